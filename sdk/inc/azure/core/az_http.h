@@ -129,6 +129,11 @@ typedef struct
 
   /// Maximum number of retries.
   int32_t max_retries;
+
+  /// If `true`, the retry policy doesn't wait before a retry. It returns
+  /// #AZ_ERROR_HTTP_RETRY_PENDING instead, and the operation must be called again with the same
+  /// request once the time given by #az_http_request_get_retry_at_msec() is reached.
+  bool defer_retries;
 } az_http_policy_retry_options;
 
 typedef enum
@@ -139,6 +144,21 @@ typedef enum
   _az_HTTP_RESPONSE_KIND_EOF = 3,
 } _az_http_response_kind;
 
+/**
+ * @brief Defines the signature of the callback function which receives the body of an HTTP
+ * response, one segment at a time, as it comes in from the network.
+ *
+ * @param[in] body_segment The next segment of the response body. It is only valid until the
+ * callback returns.
+ * @param[in] user_context The user context passed to #az_http_response_set_body_callback().
+ *
+ * @return An #az_result value indicating the result of the operation. A failure aborts the
+ * transfer of the response.
+ */
+typedef AZ_NODISCARD az_result (*az_http_response_body_fn)(
+    az_span body_segment,
+    void* user_context);
+
 /**
  * @brief Allows you to parse an HTTP response's status line, headers, and body.
  *
@@ -159,6 +179,13 @@ typedef struct
       _az_http_response_kind next_kind;
       // After parsing an element, next_kind refers to the next expected element
     } parser;
+    az_http_response_body_fn body_callback;
+    void* body_callback_context;
+    // Whether the retry policy sends the request again if the status code asks for a retry, in
+    // which case the body isn't passed to body_callback.
+    bool is_retriable;
+    // The status code of the response, once the first segment of its body is appended.
+    az_http_status_code body_status_code;
   } _internal;
 } az_http_response;
 
@@ -185,12 +212,44 @@ az_http_response_init(az_http_response* out_response, az_span buffer)
         .remaining = AZ_SPAN_EMPTY,
         .next_kind = _az_HTTP_RESPONSE_KIND_STATUS_LINE,
       },
+      .body_callback = NULL,
+      .body_callback_context = NULL,
+      .is_retriable = false,
+      .body_status_code = AZ_HTTP_STATUS_CODE_NONE,
     },
   };
 
   return AZ_OK;
 }
 
+/**
+ * @brief Sets a callback which receives the body of the response as it comes in from the network,
+ * instead of the body being written into the buffer of the #az_http_response.
+ *
+ * @details Only the status line and headers are written into the buffer, which doesn't need to be
+ * large enough for the body, so memory stays bounded regardless of the size of the response. The
+ * callback is invoked after the status line and headers are received, so they can be read with
+ * #az_http_response_get_status_line() and #az_http_response_get_next_header() from the callback.
+ * #az_http_response_get_body() returns an empty body.
+ *
+ * @param[in,out] ref_response The #az_http_response to set the callback for.
+ * @param[in] body_callback __[nullable]__ The function which receives the body. If `NULL`, the
+ * body is written into the buffer.
+ * @param[in] user_context __[nullable]__ A value passed to \p body_callback.
+ *
+ * @remarks The callback doesn't receive the body of a response which the retry policy retries, so
+ * it only receives the body of the last attempt. A callback which fails aborts the request, which
+ * isn't retried.
+ */
+AZ_INLINE void az_http_response_set_body_callback(
+    az_http_response* ref_response,
+    az_http_response_body_fn body_callback,
+    void* user_context)
+{
+  ref_response->_internal.body_callback = body_callback;
+  ref_response->_internal.body_callback_context = user_context;
+}
+
 /**
  * @brief Represents the result of making an HTTP request.
  * An application obtains this initialized structure by calling #az_http_response_get_status_line().
@@ -70,6 +70,25 @@ typedef struct
  */
 typedef az_span _az_http_request_headers;
 
+/**
+ * @brief Defines the signature of the callback function which provides the body of an HTTP
+ * request, one segment at a time, as it is sent to the network.
+ *
+ * @param[in] offset The offset, in bytes from the start of the body, of the segment to get. It is
+ * the end of the previous segment, unless the body is sent again from the start (e.g. for a retry).
+ * @param[out] out_segment The segment of the body which starts at \p offset. It must stay valid
+ * until the callback is invoked again, or the request is complete. An empty segment marks the end
+ * of the body.
+ * @param[in] user_context The user context passed to #az_http_request_set_body_callback().
+ *
+ * @return An #az_result value indicating the result of the operation. A failure aborts the
+ * transfer of the request.
+ */
+typedef AZ_NODISCARD az_result (*az_http_request_body_fn)(
+    int64_t offset,
+    az_span* out_segment,
+    void* user_context);
+
 /**
  * @brief Structure used to represent an HTTP request.
  * It contains an HTTP method, URL, headers and body. It also contains
@@ -89,6 +108,12 @@ typedef struct
     int32_t max_headers;
     int32_t retry_headers_start_byte_offset;
     az_span body;
+    az_http_request_body_fn body_callback;
+    void* body_callback_context;
+    int64_t body_size; // The size of the body given by body_callback, or -1 if it is unknown.
+    int64_t retry_at_msec;
+    int32_t retry_after_msec;
+    int32_t retry_attempt; // The attempt which got a deferred retry, or 0 if there is none.
   } _internal;
 } az_http_request;
 
@@ -177,7 +202,8 @@ AZ_NODISCARD az_result az_http_request_get_url(az_http_request const* request, a
  * @remarks This function is expected to be used by transport layer only.
  *
  * @param[in] request The HTTP request from which to get the body.
- * @param[out] out_body Pointer to write the HTTP request body to.
+ * @param[out] out_body Pointer to write the HTTP request body to. It is empty if the body is
+ * provided by a callback set with #az_http_request_set_body_callback().
  *
  * @return An #az_result value indicating the result of the operation.
  * @retval #AZ_OK Success.
@@ -185,6 +211,61 @@ AZ_NODISCARD az_result az_http_request_get_url(az_http_request const* request, a
  */
 AZ_NODISCARD az_result az_http_request_get_body(az_http_request const* request, az_span* out_body);
 
+/**
+ * @brief Gets the size of the body of an HTTP request.
+ *
+ * @remarks This function is expected to be used by transport layer only.
+ *
+ * @param[in] request The HTTP request from which to get the body size.
+ * @param[out] out_body_size Pointer to write the size of the body to, in bytes. It is -1 if the
+ * body is provided by a callback which doesn't know its size in advance.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK Success.
+ * @retval other Failure.
+ */
+AZ_NODISCARD az_result
+az_http_request_get_body_size(az_http_request const* request, int64_t* out_body_size);
+
+/**
+ * @brief Gets a segment of the body of an HTTP request, for transport adapters which send the body
+ * one segment at a time.
+ *
+ * @details If a callback was set with #az_http_request_set_body_callback(), the segment comes from
+ * it. Otherwise, it is the part of the body span which starts at \p offset.
+ *
+ * @param[in] request The HTTP request from which to get the body segment.
+ * @param[in] offset The offset, in bytes from the start of the body, of the segment to get.
+ * @param[out] out_segment Pointer to write the segment to. It is empty at the end of the body.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK Success.
+ * @retval other The body callback failed.
+ */
+AZ_NODISCARD az_result az_http_request_get_body_segment(
+    az_http_request const* request,
+    int64_t offset,
+    az_span* out_segment);
+
+/**
+ * @brief Gets when a request must be sent again, after the retry policy returned
+ * #AZ_ERROR_HTTP_RETRY_PENDING for it instead of waiting.
+ *
+ * @param[in] request Pointer to an #az_http_request to be used by this function.
+ * @param[out] out_retry_at_msec The time, by the clock of #az_platform_clock_msec(), at which the
+ * request must be sent again.
+ * @param[out] out_retry_after_msec __[nullable]__ The delay, in milliseconds, computed by the
+ * retry policy from the `Retry-After` response headers or its exponential back-off.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK Success.
+ * @retval #AZ_ERROR_HTTP_INVALID_STATE No retry of \p request is pending.
+ */
+AZ_NODISCARD az_result az_http_request_get_retry_at_msec(
+    az_http_request const* request,
+    int64_t* out_retry_at_msec,
+    int32_t* out_retry_after_msec);
+
 /**
  * @brief This function is expected to be used by transport adapters like curl. Use it to write
  * content from \p source to \p ref_response.
@@ -201,6 +282,25 @@ AZ_NODISCARD az_result az_http_request_get_body(az_http_request const* request,
  */
 AZ_NODISCARD az_result az_http_response_append(az_http_response* ref_response, az_span source);
 
+/**
+ * @brief This function is expected to be used by transport adapters which receive the body of a
+ * response separately from its status line and headers. Use it to write a segment of the body,
+ * once the status line and headers were written with #az_http_response_append().
+ *
+ * @details If a callback was set with #az_http_response_set_body_callback(), the segment is passed
+ * to it. Otherwise, it is appended to the buffer of \p ref_response.
+ *
+ * @param[in,out] ref_response Pointer to an #az_http_response.
+ * @param[in] source The segment of the response body.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK Success.
+ * @retval other The body callback failed, or there isn't enough space left in the buffer of \p
+ * ref_response.
+ */
+AZ_NODISCARD az_result
+az_http_response_append_body(az_http_response* ref_response, az_span source);
+
 /**
  * @brief Returns the number of headers within the request.
  *
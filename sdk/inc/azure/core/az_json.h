@@ -55,6 +55,10 @@ typedef struct
     // Each subsequent bit is the parent / containing type (object or array).
     uint64_t az_json_stack;
     int32_t current_depth;
+
+    // Optional storage for the levels below the 64 innermost ones held by az_json_stack, with one
+    // bit per level. It is only touched by documents nested more than 64 levels deep.
+    az_span overflow_bits;
   } _internal;
 } _az_json_bit_stack;
 
@@ -236,6 +240,11 @@ AZ_NODISCARD az_result az_json_token_get_double(az_json_token const* json_token,
  * @retval #AZ_OK The string is returned.
  * @retval #AZ_ERROR_JSON_INVALID_STATE The kind is not #AZ_JSON_TOKEN_STRING.
  * @retval #AZ_ERROR_NOT_ENOUGH_SPACE \p destination does not have enough size.
+ * @retval #AZ_ERROR_UNEXPECTED_CHAR The string contains a UTF-16 surrogate escaped in the form of
+ * `\uXXXX`, which isn't part of a high and low surrogate pair.
+ *
+ * @remarks Characters escaped in the form of `\uXXXX`, including surrogate pairs, are unescaped as
+ * UTF-8, as #az_json_token_unescape_in_place() does.
  */
 AZ_NODISCARD az_result az_json_token_get_string(
     az_json_token const* json_token,
@@ -243,6 +252,34 @@ AZ_NODISCARD az_result az_json_token_get_string(
     int32_t destination_max_size,
     int32_t* out_string_length);
 
+/**
+ * @brief Gets the JSON token's string after unescaping it in place, within the JSON buffer the
+ * token was read from, instead of copying it into a separate destination.
+ *
+ * @param[in] json_token A pointer to an #az_json_token instance.
+ * @param[out] out_string A pointer to an #az_span which receives the unescaped string. It is a
+ * slice of the JSON buffer, which starts where the token starts.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The string is returned.
+ * @retval #AZ_ERROR_JSON_INVALID_STATE The kind is not #AZ_JSON_TOKEN_STRING or
+ * #AZ_JSON_TOKEN_PROPERTY_NAME.
+ * @retval #AZ_ERROR_NOT_SUPPORTED The token straddles non-contiguous buffers. Use
+ * #az_json_token_get_string() instead.
+ * @retval #AZ_ERROR_UNEXPECTED_CHAR The string contains a UTF-16 surrogate escaped in the form of
+ * `\uXXXX`, which isn't part of a high and low surrogate pair.
+ *
+ * @remarks Characters escaped in the form of `\uXXXX`, including surrogate pairs, are unescaped as
+ * UTF-8. Unescaping only shrinks a string, so the unescaped bytes overwrite the token's bytes in
+ * the JSON buffer, which must be writable. Afterwards, the JSON text of this token is no longer
+ * valid, and #az_json_token functions must not be called on it, or on any copy of it. Since the
+ * #az_json_reader has already moved past the token, reading the rest of the JSON isn't affected.
+ * If an error is returned, the token's bytes may be partially unescaped. If the string doesn't
+ * contain any escaped characters, the token's bytes are left unchanged.
+ */
+AZ_NODISCARD az_result
+az_json_token_unescape_in_place(az_json_token const* json_token, az_span* out_string);
+
 /**
  * @brief Determines whether the unescaped JSON token value that the #az_json_token points to is
  * equal to the expected text within the provided byte span by doing a case-sensitive comparison.
@@ -260,6 +297,80 @@ AZ_NODISCARD bool az_json_token_is_text_equal(
     az_json_token const* json_token,
     az_span expected_text);
 
+/**
+ * @brief A hash table which maps JSON property names, known ahead of time, to their index in a
+ * list of names.
+ *
+ * @details Call #az_json_property_name_table_find() to find which of the names an #az_json_token
+ * matches with a single hash lookup, instead of calling #az_json_token_is_text_equal() for each
+ * name.
+ *
+ * @remarks Initialize the table once, with #az_json_property_name_table_init(), and reuse it for
+ * every JSON payload to read. The names and slots arrays must outlive the table.
+ */
+typedef struct
+{
+  struct
+  {
+    /// The caller-provided list of names.
+    az_span const* names;
+
+    /// The caller-provided array of slots, each of which contains zero or one plus the index of
+    /// a name.
+    uint8_t* slots;
+
+    /// The number of slots, which is a power of two.
+    int32_t slots_length;
+  } _internal;
+} az_json_property_name_table;
+
+/**
+ * @brief Initializes an #az_json_property_name_table over a list of names.
+ *
+ * @param[out] out_table A pointer to an #az_json_property_name_table instance to initialize.
+ * @param[in] names A pointer to an array of the unescaped names to find.
+ * @param[in] names_length The number of elements in the \p names array, which must be at most 255.
+ * @param[in] slots A pointer to an array of bytes used to store the hash table.
+ * @param[in] slots_length The number of elements in the \p slots array, which must be a power of
+ * two.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The table is initialized successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The \p slots_length isn't greater than \p names_length.
+ *
+ * @remarks To keep lookups close to a single comparison, use at least twice as many slots as
+ * names.
+ */
+AZ_NODISCARD az_result az_json_property_name_table_init(
+    az_json_property_name_table* out_table,
+    az_span const* names,
+    int32_t names_length,
+    uint8_t* slots,
+    int32_t slots_length);
+
+/**
+ * @brief Finds the name, in an #az_json_property_name_table, which is equal to the unescaped
+ * value of an #az_json_token.
+ *
+ * @param[in] table A pointer to an initialized #az_json_property_name_table instance.
+ * @param[in] json_token A pointer to an #az_json_token containing the JSON text to find.
+ * @param[out] out_index A pointer to the index of the matching name, within the list of names the
+ * table was initialized with.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK A matching name is found.
+ * @retval #AZ_ERROR_ITEM_NOT_FOUND The token doesn't match any of the names, or it isn't a string
+ * or property name.
+ *
+ * @remarks Like #az_json_token_is_text_equal(), this supports tokens that contain escaped
+ * characters or straddle non-contiguous buffers, except for characters escaped in the form of
+ * `\\uXXXX`. If the list contains the same name more than once, the first index is returned.
+ */
+AZ_NODISCARD az_result az_json_property_name_table_find(
+    az_json_property_name_table const* table,
+    az_json_token const* json_token,
+    int32_t* out_index);
+
 /************************************ JSON WRITER ******************/
 
 /**
@@ -267,6 +378,17 @@ AZ_NODISCARD bool az_json_token_is_text_equal(
  */
 typedef struct
 {
+  /// A buffer to track JSON objects and arrays nested more than 64 levels deep, which are
+  /// otherwise rejected with #AZ_ERROR_JSON_NESTING_OVERFLOW. Each byte allows 8 more levels of
+  /// nesting. The buffer must outlive the #az_json_writer. The default is #AZ_SPAN_EMPTY.
+  az_span nesting_buffer;
+
+  /// The number of spaces to indent each level of nested JSON with. If it isn't 0, each value and
+  /// property name within an object or array is written on a new line, and property values follow
+  /// a space after the colon. The default is 0, which writes minimized JSON. Text appended with
+  /// #az_json_writer_append_json_text() is written as is.
+  int32_t indentation;
+
   struct
   {
     /// Currently, this is unused, but needed as a placeholder since we can't have an empty struct.
@@ -286,6 +408,8 @@ typedef struct
 AZ_NODISCARD AZ_INLINE az_json_writer_options az_json_writer_options_default()
 {
   az_json_writer_options options = (az_json_writer_options) {
+    .nesting_buffer = AZ_SPAN_EMPTY,
+    .indentation = 0,
     ._internal = {
       .unused = false,
     },
@@ -294,6 +418,27 @@ AZ_NODISCARD AZ_INLINE az_json_writer_options az_json_writer_options_default()
   return options;
 }
 
+/**
+ * @brief Defines the signature of the callback function that the caller must implement to receive
+ * each chunk of JSON text written by an #az_json_writer initialized with
+ * #az_json_writer_buffered_init().
+ *
+ * @param user_context The user-defined struct or set of fields that was passed to
+ * #az_json_writer_buffered_init().
+ * @param[in] json_chunk The JSON text written into one of the buffers.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK Success.
+ * @retval other Failure.
+ *
+ * @remarks The callback can start an asynchronous operation, such as sending the chunk over the
+ * network, and return right away, since the writer continues in its next buffer. The writer only
+ * writes into the buffer of \p json_chunk again after each of the other buffers has been handed
+ * to the callback. That is, the chunk handed to the callback `buffers_length - 1` calls earlier
+ * must no longer be in use once this callback returns, so the callback must wait for it if needed.
+ */
+typedef az_result (*az_json_writer_flush_fn)(void* user_context, az_span json_chunk);
+
 /**
  * @brief Provides forward-only, non-cached writing of UTF-8 encoded JSON text into the provided
  * buffer.
@@ -311,6 +456,11 @@ typedef struct
     int32_t total_bytes_written; // Currently, this is primarily used for testing.
     az_span_allocator_fn allocator_callback;
     void* user_context;
+    az_json_writer_flush_fn flush_callback;
+    az_span const* buffers;
+    int32_t buffers_length;
+    int32_t buffer_index;
+    bool is_measuring;
     bool need_comma;
     az_json_token_kind token_kind; // needed for validation, potentially #if/def with preconditions.
     _az_json_bit_stack bit_stack; // needed for validation, potentially #if/def with preconditions.
@@ -355,6 +505,12 @@ AZ_NODISCARD az_result az_json_writer_init(
  * @return An #az_result value indicating the result of the operation.
  * @retval #AZ_OK The #az_json_writer is initialized successfully.
  * @retval other Failure.
+ *
+ * @remarks Tokens too large for a 64-byte buffer, and the white space before a token when
+ * #az_json_writer_options.indentation is set, are written in parts across buffers. If
+ * \p allocator_callback fails while writing them, the append function returns
+ * #AZ_ERROR_NOT_ENOUGH_SPACE, the JSON text can end with the parts already written, and the writer
+ * mustn't be used any further.
  */
 AZ_NODISCARD az_result az_json_writer_chunked_init(
     az_json_writer* out_json_writer,
@@ -363,6 +519,78 @@ AZ_NODISCARD az_result az_json_writer_chunked_init(
     void* user_context,
     az_json_writer_options const* options);
 
+/**
+ * @brief Initializes an #az_json_writer which writes JSON text into a set of buffers that are used
+ * in turn, handing each buffer to a flush callback once it is full.
+ *
+ * @param[out] out_json_writer A pointer to an #az_json_writer the instance to initialize.
+ * @param[in] buffers An array of #az_span over the byte buffers where the JSON text is written,
+ * starting with the first one. Each buffer must be at least 64 bytes long. The array must outlive
+ * the #az_json_writer.
+ * @param[in] buffers_length The number of buffers in \p buffers. Use two or more buffers to keep
+ * writing JSON text while the previous chunk is being sent.
+ * @param[in] flush_callback An #az_json_writer_flush_fn callback function that receives the JSON
+ * text written into a buffer, once that buffer is too small to contain the next token, or when
+ * #az_json_writer_flush() is called.
+ * @param user_context A context specific user-defined struct or set of fields that is passed
+ * through to calls to the #az_json_writer_flush_fn.
+ * @param[in] options __[nullable]__ A reference to an #az_json_writer_options
+ * structure which defines custom behavior of the #az_json_writer. If `NULL` is passed, the writer
+ * will use the default options (i.e. #az_json_writer_options_default()).
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The #az_json_writer is initialized successfully.
+ * @retval other Failure.
+ *
+ * @remarks Unlike #az_json_writer_chunked_init(), the writer doesn't wait for the next buffer to be
+ * allocated. If \p flush_callback fails, the append function that needed more space returns
+ * #AZ_ERROR_NOT_ENOUGH_SPACE. Since large tokens, and indentation, can span buffers, the chunks
+ * already flushed can then end with part of a token, or with white space, and the writer mustn't be
+ * used any further. Call #az_json_writer_flush() once done writing, to hand the last chunk to the
+ * callback.
+ */
+AZ_NODISCARD az_result az_json_writer_buffered_init(
+    az_json_writer* out_json_writer,
+    az_span const buffers[],
+    int32_t buffers_length,
+    az_json_writer_flush_fn flush_callback,
+    void* user_context,
+    az_json_writer_options const* options);
+
+/**
+ * @brief Initializes an #az_json_writer which doesn't write any JSON text, but counts how many
+ * bytes it takes, to allocate a buffer of the exact size before writing it.
+ *
+ * @param[out] out_json_writer A pointer to an #az_json_writer the instance to initialize.
+ * @param[in] options __[nullable]__ A reference to an #az_json_writer_options
+ * structure which defines custom behavior of the #az_json_writer. If `NULL` is passed, the writer
+ * will use the default options (i.e. #az_json_writer_options_default()).
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The #az_json_writer is initialized successfully.
+ * @retval other Failure.
+ *
+ * @remarks The append functions validate the state of the writer the same way as when writing,
+ * but none of them copy any bytes. Once done, call #az_json_writer_get_total_bytes_written() to
+ * get the size of the JSON text, and make the same calls again on a writer initialized with
+ * #az_json_writer_init(), using a buffer of exactly that size.
+ */
+AZ_NODISCARD az_result
+az_json_writer_measure_init(az_json_writer* out_json_writer, az_json_writer_options const* options);
+
+/**
+ * @brief Hands the JSON text written into the current buffer to the flush callback, and continues
+ * writing into the next buffer.
+ *
+ * @param[in,out] ref_json_writer A pointer to an #az_json_writer instance initialized with
+ * #az_json_writer_buffered_init().
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The JSON text was flushed successfully, or there was nothing to flush.
+ * @retval other The #az_json_writer_flush_fn failed.
+ */
+AZ_NODISCARD az_result az_json_writer_flush(az_json_writer* ref_json_writer);
+
 /**
  * @brief Returns the #az_span containing the JSON text written to the underlying buffer so far, in
  * the last provided destination buffer.
@@ -387,6 +615,20 @@ az_json_writer_get_bytes_used_in_destination(az_json_writer const* json_writer)
       json_writer->_internal.destination_buffer, 0, json_writer->_internal.bytes_written);
 }
 
+/**
+ * @brief Returns the number of bytes of JSON text written so far, across all of the destination
+ * buffers, or counted by a writer initialized with #az_json_writer_measure_init().
+ *
+ * @param[in] json_writer A pointer to an #az_json_writer instance.
+ *
+ * @return The total size of the JSON text written so far.
+ */
+AZ_NODISCARD AZ_INLINE int32_t
+az_json_writer_get_total_bytes_written(az_json_writer const* json_writer)
+{
+  return json_writer->_internal.total_bytes_written;
+}
+
 /**
  * @brief Appends the UTF-8 text value (as a JSON string) into the buffer.
  *
@@ -504,6 +746,26 @@ AZ_NODISCARD az_result az_json_writer_append_double(
     double value,
     int32_t fractional_digits);
 
+/**
+ * @brief Appends a `double` number value, using the fewest digits that parse back to the same
+ * `double`.
+ *
+ * @param[in,out] ref_json_writer A pointer to an #az_json_writer instance containing the buffer to
+ * append the number to.
+ * @param[in] value The value to be written as a JSON number.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The number was appended successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The buffer is too small.
+ *
+ * @remark Only finite double values are supported. Values such as `NAN` and `INFINITY` are not
+ * allowed and would lead to invalid JSON being written.
+ *
+ * @remark See #az_span_dtoa_shortest() for the format of the number.
+ */
+AZ_NODISCARD az_result
+az_json_writer_append_double_shortest(az_json_writer* ref_json_writer, double value);
+
 /**
  * @brief Appends the JSON literal `null`.
  *
@@ -575,6 +837,17 @@ AZ_NODISCARD az_result az_json_writer_append_end_array(az_json_writer* ref_json_
  */
 typedef struct
 {
+  /// A buffer to track JSON objects and arrays nested more than 64 levels deep, which are
+  /// otherwise rejected with #AZ_ERROR_JSON_NESTING_OVERFLOW. Each byte allows 8 more levels of
+  /// nesting. The buffer must outlive the #az_json_reader. The default is #AZ_SPAN_EMPTY.
+  az_span nesting_buffer;
+
+  /// Validates that the content of every string is well-formed UTF-8 (RFC 3629), while reading it.
+  /// Overlong encodings, UTF-16 surrogates, code points above U+10FFFF, and truncated sequences are
+  /// rejected with #AZ_ERROR_UNEXPECTED_CHAR. The default is `false`, which accepts any byte of
+  /// 0x80 or more.
+  bool validate_utf8;
+
   struct
   {
     /// Currently, this is unused, but needed as a placeholder since we can't have an empty struct.
@@ -594,6 +867,8 @@ typedef struct
 AZ_NODISCARD AZ_INLINE az_json_reader_options az_json_reader_options_default()
 {
   az_json_reader_options options = (az_json_reader_options) {
+    .nesting_buffer = AZ_SPAN_EMPTY,
+    .validate_utf8 = false,
     ._internal = {
       .unused = false,
     },
@@ -647,6 +922,14 @@ typedef struct
 
     /// A copy of the options provided by the user.
     az_json_reader_options options;
+
+    /// For a reader initialized with #az_json_reader_push_init(), the number of elements in the
+    /// json_buffers array. Otherwise, 0.
+    int32_t buffers_capacity;
+
+    /// Flag which indicates that more buffers can still be pushed, so reaching the end of the
+    /// buffers read so far isn't the end of the JSON payload.
+    bool is_more_data_expected;
   } _internal;
 } az_json_reader;
 
@@ -704,6 +987,59 @@ AZ_NODISCARD az_result az_json_reader_chunked_init(
     int32_t number_of_buffers,
     az_json_reader_options const* options);
 
+/**
+ * @brief Initializes an #az_json_reader to read a JSON payload which is provided one buffer at a
+ * time, with #az_json_reader_push_buffer(), as it becomes available.
+ *
+ * @param[out] out_json_reader A pointer to an #az_json_reader instance to initialize.
+ * @param[in] json_buffers An array of spans, used by the reader to keep track of the buffers
+ * pushed to it.
+ * @param[in] buffers_capacity The number of elements in the \p json_buffers array.
+ * @param[in] options __[nullable]__ A reference to an #az_json_reader_options
+ * structure which defines custom behavior of the #az_json_reader. If `NULL` is passed, the reader
+ * will use the default options (i.e. #az_json_reader_options_default()).
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The #az_json_reader is initialized successfully.
+ *
+ * @remarks Until the final buffer is pushed, #az_json_reader_next_token() returns
+ * #AZ_ERROR_JSON_NEED_MORE_DATA when the next token doesn't end within the buffers pushed so far.
+ * The reader is then left as it was before the call, so the call can be repeated after pushing
+ * another buffer. #az_json_reader_skip_children() behaves the same way, but all of the children
+ * must fit within \p buffers_capacity buffers.
+ *
+ * @remarks The reader doesn't copy the JSON text, so the tokens point into the pushed buffers. The
+ * reader only refers to the \p buffers_capacity most recently pushed buffers, so any older buffer
+ * can be reused.
+ */
+AZ_NODISCARD az_result az_json_reader_push_init(
+    az_json_reader* out_json_reader,
+    az_span json_buffers[],
+    int32_t buffers_capacity,
+    az_json_reader_options const* options);
+
+/**
+ * @brief Provides the next buffer of the JSON payload to an #az_json_reader initialized with
+ * #az_json_reader_push_init().
+ *
+ * @param[in,out] ref_json_reader A pointer to an #az_json_reader instance.
+ * @param[in] json_buffer The next portion of the JSON text, which may be empty.
+ * @param[in] is_final_buffer `true` if this is the last portion of the JSON text.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The buffer is added successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE All of the buffers in the json_buffers array are still needed,
+ * because the token being read straddles all of them.
+ *
+ * @remarks To make room for the new buffer, the reader drops the buffers which end before the
+ * current token. Copies of earlier tokens which straddle several buffers must not be used after
+ * that.
+ */
+AZ_NODISCARD az_result az_json_reader_push_buffer(
+    az_json_reader* ref_json_reader,
+    az_span json_buffer,
+    bool is_final_buffer);
+
 /**
  * @brief Reads the next token in the JSON text and updates the reader state.
  *
@@ -715,6 +1051,8 @@ AZ_NODISCARD az_result az_json_reader_chunked_init(
  * @retval #AZ_ERROR_UNEXPECTED_END The end of the JSON document is reached.
  * @retval #AZ_ERROR_UNEXPECTED_CHAR An invalid character is detected.
  * @retval #AZ_ERROR_JSON_READER_DONE No more JSON text left to process.
+ * @retval #AZ_ERROR_JSON_NEED_MORE_DATA For a reader initialized with #az_json_reader_push_init(),
+ * the token doesn't end within the buffers pushed so far.
  */
 AZ_NODISCARD az_result az_json_reader_next_token(az_json_reader* ref_json_reader);
 
@@ -728,6 +1066,8 @@ AZ_NODISCARD az_result az_json_reader_next_token(az_json_reader* ref_json_reader
  * @retval #AZ_OK The children of the current JSON token are skipped successfully.
  * @retval #AZ_ERROR_UNEXPECTED_END The end of the JSON document is reached.
  * @retval #AZ_ERROR_UNEXPECTED_CHAR An invalid character is detected.
+ * @retval #AZ_ERROR_JSON_NEED_MORE_DATA For a reader initialized with #az_json_reader_push_init(),
+ * the children don't end within the buffers pushed so far. The reader isn't moved.
  *
  * @remarks If the current token kind is a property name, the reader first moves to the property
  * value. Then, if the token kind is start of an object or array, the reader moves to the matching
@@ -735,6 +1075,380 @@ AZ_NODISCARD az_result az_json_reader_next_token(az_json_reader* ref_json_reader
  */
 AZ_NODISCARD az_result az_json_reader_skip_children(az_json_reader* ref_json_reader);
 
+/**
+ * @brief Checks whether the JSON text is a single, complete, and valid JSON value, without
+ * producing any tokens.
+ *
+ * @param[in] json_text The UTF-8 encoded JSON text to validate.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The JSON text is valid.
+ * @retval #AZ_ERROR_UNEXPECTED_END The JSON text ends before the JSON value is complete.
+ * @retval #AZ_ERROR_UNEXPECTED_CHAR An invalid character is detected.
+ * @retval #AZ_ERROR_JSON_NESTING_OVERFLOW The JSON value is nested more than 64 levels deep.
+ *
+ * @remarks The JSON text is validated the same way an #az_json_reader reads it, and in addition,
+ * the content of every string must be well-formed UTF-8. This is much faster than reading all of
+ * the tokens with an #az_json_reader.
+ */
+AZ_NODISCARD az_result az_json_validate(az_span json_text);
+
+/************************************ JSON DOCUMENT ******************/
+
+/**
+ * @brief A single entry of an #az_json_document, which holds one token of the indexed JSON.
+ *
+ * @remarks The array of nodes is provided by the caller to #az_json_document_init(). The fields are
+ * meant to be used as read-only, through the #az_json_document functions.
+ */
+typedef struct
+{
+  /// The token read at this position of the JSON.
+  az_json_token token;
+
+  struct
+  {
+    /// For a start of an object or array, the index of the node of the matching end object or
+    /// array. For all other token kinds, the index of this node.
+    int32_t end_index;
+  } _internal;
+} az_json_document_node;
+
+/**
+ * @brief A read-only, random-access view over a JSON value, which is indexed once with an
+ * #az_json_reader and then navigated without reading the JSON text again.
+ *
+ * @details Every token of the JSON value is stored, in document order, in a caller-provided array
+ * of #az_json_document_node. Nodes are referred to by their index in that array, where the index of
+ * the root value is 0. Each start of an object or array records where its children end, so moving
+ * to the next sibling skips over any nested JSON elements in constant time.
+ *
+ * @remarks The tokens point into the JSON buffers given to the #az_json_reader, which must outlive
+ * the #az_json_document.
+ */
+typedef struct
+{
+  struct
+  {
+    /// The caller-provided array of nodes.
+    az_json_document_node* nodes;
+
+    /// The number of nodes that contain tokens of the JSON value.
+    int32_t node_count;
+  } _internal;
+} az_json_document;
+
+/**
+ * @brief Reads a JSON value with an #az_json_reader and indexes all of its tokens into an
+ * #az_json_document.
+ *
+ * @param[out] out_document A pointer to an #az_json_document instance to initialize.
+ * @param[in,out] ref_json_reader A pointer to an #az_json_reader instance containing the JSON to
+ * read.
+ * @param[in] nodes A pointer to an array of #az_json_document_node, which receives the tokens.
+ * @param[in] nodes_length The number of elements in the \p nodes array.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The JSON value is indexed successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The JSON value has more tokens than \p nodes_length.
+ * @retval #AZ_ERROR_UNEXPECTED_END The end of the JSON document is reached.
+ * @retval #AZ_ERROR_UNEXPECTED_CHAR An invalid character is detected.
+ * @retval #AZ_ERROR_JSON_INVALID_STATE The current token of \p ref_json_reader is the end of an
+ * object or array.
+ *
+ * @remarks If the reader hasn't read any token yet, the first token is read. If the current token
+ * kind is a property name, the reader first moves to the property value. Then, like
+ * #az_json_reader_skip_children(), the value and all of its nested JSON elements are read, and the
+ * reader stops on the last token of the value. This allows indexing a single property value of a
+ * larger JSON payload.
+ */
+AZ_NODISCARD az_result az_json_document_init(
+    az_json_document* out_document,
+    az_json_reader* ref_json_reader,
+    az_json_document_node* nodes,
+    int32_t nodes_length);
+
+/**
+ * @brief Gets the number of tokens indexed by the #az_json_document.
+ *
+ * @param[in] document A pointer to an initialized #az_json_document instance.
+ *
+ * @return The number of tokens, which are at indexes 0 through the returned value minus one.
+ */
+AZ_NODISCARD AZ_INLINE int32_t az_json_document_get_node_count(az_json_document const* document)
+{
+  return document->_internal.node_count;
+}
+
+/**
+ * @brief Gets the token at the given index of the #az_json_document.
+ *
+ * @param[in] document A pointer to an initialized #az_json_document instance.
+ * @param[in] index The index of the token, which must be less than the number of tokens.
+ *
+ * @return A pointer to the #az_json_token at \p index.
+ */
+AZ_NODISCARD az_json_token const* az_json_document_get_token(
+    az_json_document const* document,
+    int32_t index);
+
+/**
+ * @brief Gets the index of the first child of an object or array.
+ *
+ * @param[in] document A pointer to an initialized #az_json_document instance.
+ * @param[in] index The index of the start of the object or array.
+ * @param[out] out_child_index A pointer to the index of the first child.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The first child is found.
+ * @retval #AZ_ERROR_ITEM_NOT_FOUND The token at \p index isn't the start of an object or array, or
+ * the object or array is empty.
+ *
+ * @remarks The children of an object are its property names. The value of a property is at the
+ * index of its property name plus one.
+ */
+AZ_NODISCARD az_result az_json_document_get_first_child(
+    az_json_document const* document,
+    int32_t index,
+    int32_t* out_child_index);
+
+/**
+ * @brief Gets the index of the next property name of the enclosing object, or the next element of
+ * the enclosing array, skipping over any nested JSON elements.
+ *
+ * @param[in] document A pointer to an initialized #az_json_document instance.
+ * @param[in] index The index of a property name, or of an array element.
+ * @param[out] out_sibling_index A pointer to the index of the next sibling.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The next sibling is found.
+ * @retval #AZ_ERROR_ITEM_NOT_FOUND The token at \p index is the last child of its object or array,
+ * or it is the root value.
+ */
+AZ_NODISCARD az_result az_json_document_get_next_sibling(
+    az_json_document const* document,
+    int32_t index,
+    int32_t* out_sibling_index);
+
+/**
+ * @brief Gets the index of the value of the property with the given name.
+ *
+ * @param[in] document A pointer to an initialized #az_json_document instance.
+ * @param[in] object_index The index of the start of the object.
+ * @param[in] property_name The unescaped name of the property to find.
+ * @param[out] out_value_index A pointer to the index of the property value.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The property is found.
+ * @retval #AZ_ERROR_ITEM_NOT_FOUND The token at \p object_index isn't the start of an object, or
+ * the object has no property with that name.
+ *
+ * @remarks If the object has several properties with the same name, the first one is returned.
+ */
+AZ_NODISCARD az_result az_json_document_get_property(
+    az_json_document const* document,
+    int32_t object_index,
+    az_span property_name,
+    int32_t* out_value_index);
+
+/**
+ * @brief Gets the index of the element at the given position of an array.
+ *
+ * @param[in] document A pointer to an initialized #az_json_document instance.
+ * @param[in] array_index The index of the start of the array.
+ * @param[in] element The zero-based position of the element within the array.
+ * @param[out] out_element_index A pointer to the index of the element.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The element is found.
+ * @retval #AZ_ERROR_ITEM_NOT_FOUND The token at \p array_index isn't the start of an array, or the
+ * array has \p element or fewer elements.
+ */
+AZ_NODISCARD az_result az_json_document_get_array_element(
+    az_json_document const* document,
+    int32_t array_index,
+    int32_t element,
+    int32_t* out_element_index);
+
+/**
+ * @brief Gets the index of the value referenced by a JSON Pointer (RFC 6901), starting from the
+ * root value of the #az_json_document.
+ *
+ * @param[in] document A pointer to an initialized #az_json_document instance.
+ * @param[in] json_pointer The JSON Pointer, such as `/desired/$version` or `/items/0`. An empty
+ * pointer references the root value.
+ * @param[out] out_index A pointer to the index of the referenced value.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The value is found.
+ * @retval #AZ_ERROR_ITEM_NOT_FOUND The JSON document doesn't contain the referenced value.
+ * @retval #AZ_ERROR_UNEXPECTED_CHAR The \p json_pointer isn't a valid JSON Pointer.
+ * @retval #AZ_ERROR_NOT_SUPPORTED A reference token which contains `~0` or `~1` escapes is longer
+ * than 64 bytes.
+ */
+AZ_NODISCARD az_result az_json_document_get_pointer(
+    az_json_document const* document,
+    az_span json_pointer,
+    int32_t* out_index);
+
+/************************************ JSON BINDING ******************/
+
+/**
+ * @brief Defines symbols for the C types of the struct fields an #az_json_binding can read from and
+ * write to JSON.
+ */
+typedef enum
+{
+  AZ_JSON_BINDING_BOOLEAN = 1, ///< A `bool` field, for JSON true or false.
+  AZ_JSON_BINDING_INT32 = 2, ///< An `int32_t` field, for a JSON number.
+  AZ_JSON_BINDING_UINT32 = 3, ///< A `uint32_t` field, for a JSON number.
+  AZ_JSON_BINDING_INT64 = 4, ///< An `int64_t` field, for a JSON number.
+  AZ_JSON_BINDING_UINT64 = 5, ///< A `uint64_t` field, for a JSON number.
+  AZ_JSON_BINDING_DOUBLE = 6, ///< A `double` field, for a JSON number.
+  AZ_JSON_BINDING_STRING = 7, ///< An #az_span field and an `int32_t` length, for a JSON string.
+  AZ_JSON_BINDING_OBJECT = 8, ///< A nested struct field, for a JSON object.
+} az_json_binding_kind;
+
+struct az_json_binding;
+
+/**
+ * @brief Describes how one property of a JSON object maps to a field of a C struct.
+ */
+typedef struct
+{
+  /// The unescaped JSON property name.
+  az_span name;
+
+  /// The offset of the field within the struct, as given by `offsetof`.
+  size_t offset;
+
+  /// For #AZ_JSON_BINDING_OBJECT, the binding of the nested struct. Otherwise, `NULL`.
+  struct az_json_binding const* object;
+
+  // Avoid using enum as the first field within structs, to allow for { 0 } initialization.
+
+  /// The C type of the field.
+  az_json_binding_kind kind;
+
+  /// For #AZ_JSON_BINDING_STRING, the offset of the `int32_t` field which holds the length of the
+  /// string, as given by `offsetof`. Otherwise, unused.
+  size_t length_offset;
+} az_json_binding_field;
+
+/**
+ * @brief Describes how a JSON object maps to a C struct, so that the struct can be read from, and
+ * written to, JSON without any code specific to its fields.
+ *
+ * @details A binding is typically defined once, as a `static const` table:
+ * @code{.c}
+ * typedef struct { double target; int64_t version; az_span mode; int32_t mode_length; } desired;
+ * static az_json_binding_field const desired_fields[] = {
+ *   { AZ_SPAN_LITERAL_FROM_STR("targetTemperature"), offsetof(desired, target), NULL,
+ *     AZ_JSON_BINDING_DOUBLE, 0 },
+ *   { AZ_SPAN_LITERAL_FROM_STR("$version"), offsetof(desired, version), NULL,
+ *     AZ_JSON_BINDING_INT64, 0 },
+ *   { AZ_SPAN_LITERAL_FROM_STR("mode"), offsetof(desired, mode), NULL,
+ *     AZ_JSON_BINDING_STRING, offsetof(desired, mode_length) },
+ * };
+ * static az_json_binding const desired_binding = { desired_fields, 3 };
+ * @endcode
+ */
+typedef struct az_json_binding
+{
+  /// A pointer to the array of fields.
+  az_json_binding_field const* fields;
+
+  /// The number of elements in the \p fields array.
+  int32_t fields_length;
+} az_json_binding;
+
+/**
+ * @brief Reads a JSON object into a struct, in a single pass of an #az_json_reader.
+ *
+ * @param[in,out] ref_json_reader A pointer to an #az_json_reader instance containing the JSON to
+ * read.
+ * @param[in] binding A pointer to the #az_json_binding which describes the struct.
+ * @param[in,out] ref_value A pointer to the struct to fill.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The JSON object is read successfully.
+ * @retval #AZ_ERROR_JSON_INVALID_STATE The JSON value, or the value of one of the properties in the
+ * binding, isn't of the kind the binding expects.
+ * @retval #AZ_ERROR_UNEXPECTED_CHAR A number is out of range of its field, or an invalid character
+ * is detected.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE A string doesn't fit in its field.
+ * @retval #AZ_ERROR_UNEXPECTED_END The end of the JSON document is reached.
+ *
+ * @remarks If the reader hasn't read any token yet, the first token is read. If the current token
+ * kind is a property name, the reader first moves to the property value. The reader stops on the
+ * end of the object, like #az_json_reader_skip_children().
+ *
+ * @remarks Properties that aren't in the binding are skipped along with any nested JSON elements.
+ * Fields whose property is missing, or is `null`, keep their value, so set the defaults before
+ * reading.
+ *
+ * @remarks For #AZ_JSON_BINDING_STRING, the #az_span field must be set to a buffer before reading.
+ * The unescaped string is copied into it, followed by a null terminator, and its length (without
+ * the null terminator) is set in the field at `length_offset`. The #az_span field isn't changed, so
+ * the same struct can be read again.
+ */
+AZ_NODISCARD az_result az_json_binding_read(
+    az_json_reader* ref_json_reader,
+    az_json_binding const* binding,
+    void* ref_value);
+
+/**
+ * @brief Writes a struct as a JSON object, with one property per field of the binding.
+ *
+ * @param[in,out] ref_json_writer A pointer to an #az_json_writer instance to write to.
+ * @param[in] binding A pointer to the #az_json_binding which describes the struct.
+ * @param[in] value A pointer to the struct to write.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The JSON object is written successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The destination buffer is too small.
+ *
+ * @remarks Numbers of kind #AZ_JSON_BINDING_DOUBLE are written with
+ * #az_json_writer_append_double_shortest(), so that reading them back yields the same value.
+ *
+ * @remarks For #AZ_JSON_BINDING_STRING, the string is the start of the #az_span field, of the
+ * length in the field at `length_offset`.
+ */
+AZ_NODISCARD az_result az_json_binding_write(
+    az_json_writer* ref_json_writer,
+    az_json_binding const* binding,
+    void const* value);
+
+/************************************ JSON TRANSCODING ******************/
+
+/**
+ * @brief Copies the current JSON value of an #az_json_reader into an #az_json_writer, token by
+ * token, so that it is reformatted according to the options of the writer.
+ *
+ * @param[in,out] ref_json_writer A pointer to an #az_json_writer instance to append the JSON value
+ * to.
+ * @param[in,out] ref_json_reader A pointer to an #az_json_reader instance containing the JSON to
+ * read.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The JSON value is copied successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The destination of the writer is too small.
+ * @retval #AZ_ERROR_UNEXPECTED_END The end of the JSON document is reached.
+ * @retval #AZ_ERROR_UNEXPECTED_CHAR An invalid character is detected.
+ *
+ * @remarks If the reader hasn't read any token yet, the first token is read. If the current token
+ * kind is a property name, the reader first moves to the property value. Then, like
+ * #az_json_reader_skip_children(), the value and all of its nested JSON elements are read, and the
+ * reader stops on the last token of the value.
+ *
+ * @remarks Use #az_json_writer_options_default() to minimize JSON, or set
+ * #az_json_writer_options.indentation to pretty-print it. Strings, property names, and numbers are
+ * copied as they are in the JSON text, without unescaping and escaping strings again, and nothing
+ * is copied into an intermediate buffer.
+ */
+AZ_NODISCARD az_result
+az_json_writer_transcode(az_json_writer* ref_json_writer, az_json_reader* ref_json_reader);
+
 #include <azure/core/_az_cfg_suffix.h>
 
 #endif // _az_JSON_H
@@ -109,6 +109,9 @@ enum az_result_core
   /// No more JSON text left to process.
   AZ_ERROR_JSON_READER_DONE = _az_RESULT_MAKE_ERROR(_az_FACILITY_CORE_JSON, 3),
 
+  /// The JSON buffers pushed so far end before the next token does. Push more data and try again.
+  AZ_ERROR_JSON_NEED_MORE_DATA = _az_RESULT_MAKE_ERROR(_az_FACILITY_CORE_JSON, 4),
+
   // === HTTP error codes ===
   /// The #az_http_response instance is in an invalid state.
   AZ_ERROR_HTTP_INVALID_STATE = _az_RESULT_MAKE_ERROR(_az_FACILITY_CORE_HTTP, 1),
@@ -137,6 +140,10 @@ enum az_result_core
   // === HTTP Adapter error codes ===
   /// Generic error in the HTTP transport adapter implementation.
   AZ_ERROR_HTTP_ADAPTER = _az_RESULT_MAKE_ERROR(_az_FACILITY_CORE_HTTP, 9),
+
+  /// The request must be sent again after a delay, which the retry policy left to the caller
+  /// instead of waiting for it.
+  AZ_ERROR_HTTP_RETRY_PENDING = _az_RESULT_MAKE_ERROR(_az_FACILITY_CORE_HTTP, 10),
 };
 
 /**
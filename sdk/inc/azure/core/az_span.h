@@ -476,6 +476,36 @@ AZ_NODISCARD az_result az_span_u64toa(az_span destination, uint64_t source, az_s
 AZ_NODISCARD az_result
 az_span_dtoa(az_span destination, double source, int32_t fractional_digits, az_span* out_span);
 
+/**
+ * @brief Converts a `double` into its shortest digits that parse back to the same `double`, and
+ * copies the result to the \p destination #az_span starting at its 0-th index.
+ *
+ * @param destination The #az_span where the bytes should be copied to.
+ * @param[in] source The `double` whose number is copied to the \p destination #az_span as ASCII
+ * digits and characters.
+ * @param[out] out_span A pointer to an #az_span that receives the remainder of the \p destination
+ * #az_span after the `double` has been copied.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK Success.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The \p destination is not big enough to contain the copied
+ * bytes. Nothing is written in that case.
+ * @retval #AZ_ERROR_NOT_SUPPORTED The \p source is not a finite decimal number.
+ *
+ * @remark Only finite `double` values are supported. Values such as `NaN` and `INFINITY` are not
+ * allowed.
+ *
+ * @remark Unlike #az_span_dtoa(), the number of digits isn't fixed and the integer component isn't
+ * limited to `2^53 - 1`. Numbers with a decimal exponent from -6 to 20 are written without an
+ * exponent (such as `0.1`, `-1013.25`, or `100000000000000000000`), and the rest in scientific
+ * notation (such as `1e+21` or `1.5e-7`), the same way JavaScript formats numbers. Negative zero is
+ * written as `-0`. At most 25 bytes are written.
+ *
+ * @remark The digits always parse back to the same `double`. For a very small fraction of values,
+ * one more digit than the minimum may be written.
+ */
+AZ_NODISCARD az_result az_span_dtoa_shortest(az_span destination, double source, az_span* out_span);
+
 /******************************  NON-CONTIGUOUS SPAN  */
 
 /**
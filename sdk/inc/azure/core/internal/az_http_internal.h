@@ -9,6 +9,9 @@
 #include <azure/core/az_http_transport.h>
 #include <azure/core/az_result.h>
 
+#include <stdbool.h>
+#include <stdint.h>
+
 #include <azure/core/_az_cfg_prefix.h>
 
 enum
@@ -111,6 +114,61 @@ AZ_NODISCARD az_result az_http_pipeline_process(
     az_http_request* ref_request,
     az_http_response* ref_response);
 
+/**
+ * @brief Runs the policies of a pipeline which prepare a request, for a transport adapter which
+ * sends the request asynchronously. Returns once the request is ready to be sent, without sending
+ * it.
+ *
+ * @details The retry policy only marks where the headers that are added for each attempt start,
+ * and the logging policy only logs the request. When \p attempt is greater than 1, the headers
+ * added for the previous attempt are removed and only the policies after the retry policy run
+ * again.
+ *
+ * @param[in,out] ref_pipeline The pipeline the request is sent through.
+ * @param[in,out] ref_request The request to prepare.
+ * @param[in,out] ref_response The response, which is reset to receive the next attempt. Its body
+ * isn't passed to its body callback if the retry policy retries it.
+ * @param[in] attempt The number of the attempt the request is prepared for, starting from 1.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The request is ready to be sent.
+ * @retval #AZ_ERROR_CANCELED The context of \p ref_request expired before a retry.
+ * @retval other A policy failed.
+ */
+AZ_NODISCARD az_result _az_http_pipeline_prepare_request(
+    _az_http_pipeline* ref_pipeline,
+    az_http_request* ref_request,
+    az_http_response* ref_response,
+    int32_t attempt);
+
+/**
+ * @brief Runs the part of the policies of a pipeline which handles a response, once an
+ * asynchronous transport adapter received it for a request prepared by
+ * #_az_http_pipeline_prepare_request().
+ *
+ * @details The response is logged by the logging policy and checked by the retry policy, which
+ * computes the delay before the next attempt instead of waiting for it.
+ *
+ * @param[in] pipeline The pipeline the request is sent through.
+ * @param[in] request The request that was sent.
+ * @param[in] response The response that was received.
+ * @param[in] transport_result The result of sending the request.
+ * @param[in] duration_msec The time it took to send the request and receive the response.
+ * @param[in] attempt The number of times the request was sent, starting from 1.
+ * @param[out] out_retry_after_msec The delay, in milliseconds, before the request must be prepared
+ * and sent again, or -1 if the request is complete.
+ *
+ * @return \p transport_result, unless checking the response for a retry failed.
+ */
+AZ_NODISCARD az_result _az_http_pipeline_complete_request(
+    _az_http_pipeline const* pipeline,
+    az_http_request const* request,
+    az_http_response const* response,
+    az_result transport_result,
+    int64_t duration_msec,
+    int32_t attempt,
+    int32_t* out_retry_after_msec);
+
 AZ_NODISCARD az_result az_http_pipeline_policy_apiversion(
     _az_http_policy* ref_policies,
     void* ref_options,
@@ -244,6 +302,30 @@ AZ_NODISCARD az_result az_http_request_set_query_parameter(
 AZ_NODISCARD az_result
 az_http_request_append_header(az_http_request* ref_request, az_span name, az_span value);
 
+/**
+ * @brief Sets a callback which provides the body of an HTTP request one segment at a time, as it is
+ * sent, instead of the body span passed to #az_http_request_init().
+ *
+ * @details This lets a large body, or one which is generated as it is sent, be uploaded without
+ * holding all of it in memory.
+ *
+ * @param[in,out] ref_request HTTP request to set the body callback for.
+ * @param[in] body_callback The function which provides the body.
+ * @param[in] body_size The size of the body, in bytes, or -1 if it is unknown in advance. A body of
+ * unknown size is sent with the chunked transfer encoding.
+ * @param[in] user_context __[nullable]__ A value passed to \p body_callback.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK Success.
+ *
+ * @remarks \p body_callback is invoked again from offset 0 each time the request is retried.
+ */
+AZ_NODISCARD az_result az_http_request_set_body_callback(
+    az_http_request* ref_request,
+    az_http_request_body_fn body_callback,
+    int64_t body_size,
+    void* user_context);
+
 #include <azure/core/_az_cfg_suffix.h>
 
 #endif // _az_HTTP_INTERNAL_H
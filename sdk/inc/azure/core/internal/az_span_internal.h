@@ -43,6 +43,14 @@ AZ_INLINE AZ_NODISCARD int32_t _az_span_diff(az_span sliced_span, az_span origin
   return answer;
 }
 
+/**
+ * @brief Calculates the number of decimal digits needed to write the \p value.
+ *
+ * @param[in] value The number to be written.
+ * @return The number of digits, which is 1 for 0.
+ */
+AZ_NODISCARD int32_t _az_span_u64toa_size(uint64_t value);
+
 /**
  * @brief Copies character from the \p source #az_span to the \p destination #az_span by
  * URL-encoding the \p source span characters.
@@ -72,6 +80,30 @@ _az_span_url_encode(az_span destination, az_span source, int32_t* out_length);
  */
 AZ_NODISCARD int32_t _az_span_url_encode_calc_length(az_span source);
 
+/**
+ * @brief Copies the bytes from the \p source #az_span to the \p destination #az_span by
+ * URL-decoding them, which replaces each `%XX` sequence with the byte it encodes.
+ *
+ * @param destination The #az_span whose bytes will receive the URL-decoded \p source.
+ * @param[in] source The #az_span containing the URL-encoded bytes.
+ * @param[out] out_length A pointer to an int32_t that is going to be assigned the length
+ * of URL-decoding the \p source.
+ * @return An #az_result value indicating the result of the operation:
+ *         - #AZ_OK if successful
+ *         - #AZ_ERROR_NOT_ENOUGH_SPACE if the \p destination is not big enough to contain the
+ * decoded bytes
+ *         - #AZ_ERROR_UNEXPECTED_CHAR if a `%` is not followed by two hexadecimal digits
+ *         - #AZ_ERROR_UNEXPECTED_END if the \p source ends within a `%XX` sequence
+ *
+ * @remark If it fails, some data may still be written to \p destination, but the \p out_length
+ * will be set to 0.
+ * @remark The decoded bytes are never longer than the \p source, so the \p destination may start
+ * at the same byte as the \p source, to decode in place. Otherwise, they must not overlap. A `+`
+ * is left as it is.
+ */
+AZ_NODISCARD az_result
+_az_span_url_decode(az_span destination, az_span source, int32_t* out_length);
+
 /**
  * @brief String tokenizer for #az_span.
  *
@@ -247,6 +247,30 @@ AZ_NODISCARD az_result az_iot_message_properties_next(
     az_span* out_name,
     az_span* out_value);
 
+/**
+ * @brief Decodes the name or value of a property, as found by #az_iot_message_properties_find() or
+ * #az_iot_message_properties_next(), replacing each percent-encoded (RFC3986) character with the
+ * character it stands for.
+ *
+ * @note The names and values of the properties of a received C2D message are percent-encoded, so
+ * that a `$.to` property arrives as `%24.to`, and a `/` within a value arrives as `%2F`.
+ *
+ * @param[in] source The percent-encoded name or value.
+ * @param[in] destination The #az_span where the decoded bytes are written. It may be \p source
+ * itself, to decode it in place, since the decoded bytes are never longer.
+ * @param[out] out_decoded A pointer to an #az_span over the decoded bytes within \p destination.
+ * @pre \p source must be a valid span.
+ * @pre \p destination must be a valid span.
+ * @pre \p out_decoded must not be `NULL`.
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The name or value was decoded successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE \p destination is too small for the decoded bytes.
+ * @retval #AZ_ERROR_UNEXPECTED_CHAR A `%` isn't followed by two hexadecimal digits.
+ * @retval #AZ_ERROR_UNEXPECTED_END \p source ends within a `%XX` sequence.
+ */
+AZ_NODISCARD az_result
+az_iot_message_properties_decode(az_span source, az_span destination, az_span* out_decoded);
+
 /**
  * @brief Checks if the status indicates a successful operation.
  *
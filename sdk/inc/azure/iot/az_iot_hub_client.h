@@ -330,7 +330,8 @@ AZ_NODISCARD az_result az_iot_hub_client_telemetry_get_publish_topic(
 typedef struct
 {
   /**
-   * The properties associated with this C2D request.
+   * The properties associated with this C2D request. Their names and values are percent-encoded,
+   * and can be decoded with #az_iot_message_properties_decode().
    */
   az_iot_message_properties properties;
 } az_iot_hub_client_c2d_request;
@@ -0,0 +1,328 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ *
+ * @brief Defines libcurl-specific functionality of the `az::curl` HTTP transport adapter.
+ *
+ * @note You MUST NOT use any symbols (macros, functions, structures, enums, etc.)
+ * prefixed with an underscore ('_') directly in your application code. These symbols
+ * are part of Azure SDK's internal implementation; we do not document these symbols
+ * and they are subject to change in future versions of the SDK which would break your code.
+ */
+
+#ifndef _az_CURL_H
+#define _az_CURL_H
+
+#include <azure/core/az_http.h>
+#include <azure/core/az_http_transport.h>
+#include <azure/core/az_result.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <azure/core/_az_cfg_prefix.h>
+
+/**
+ * @brief Allows the user to define custom behavior when reusing connections with an
+ * #az_curl_connection.
+ */
+typedef struct
+{
+  /// Maximum time, in seconds, that an idle connection is kept open for reuse. A connection that
+  /// was idle for longer than this is closed instead of being reused by the next request. If 0,
+  /// the libcurl default (118 seconds) is used.
+  int32_t idle_timeout_sec;
+
+  /// Interval, in seconds, at which TCP keep-alive probes are sent on idle connections. If 0, TCP
+  /// keep-alive probes are not enabled.
+  int32_t keep_alive_interval_sec;
+} az_curl_connection_options;
+
+/**
+ * @brief Gets the default #az_curl_connection_options.
+ *
+ * @details Call this to obtain an initialized #az_curl_connection_options structure that can be
+ * modified and passed to #az_curl_connection_init().
+ *
+ * @return The default #az_curl_connection_options.
+ */
+AZ_NODISCARD AZ_INLINE az_curl_connection_options az_curl_connection_options_default()
+{
+  return (az_curl_connection_options){
+    .idle_timeout_sec = 0,
+    .keep_alive_interval_sec = 60,
+  };
+}
+
+/**
+ * @brief A reusable libcurl handle which keeps connections alive across HTTP requests.
+ *
+ * @details Requests sent through the same #az_curl_connection reuse the open TCP/TLS connection to
+ * a host (libcurl keeps a small cache of connections per handle, keyed by host and port), so only
+ * the first request to that host pays for the connection handshake.
+ *
+ * @remarks An #az_curl_connection must not be used by more than one thread at a time.
+ */
+typedef struct
+{
+  struct
+  {
+    /// The underlying libcurl easy handle.
+    void* curl;
+
+    /// A copy of the options provided by the user.
+    az_curl_connection_options options;
+  } _internal;
+} az_curl_connection;
+
+/**
+ * @brief Initializes an #az_curl_connection.
+ *
+ * @param[out] out_connection A pointer to an #az_curl_connection instance to initialize.
+ * @param[in] options __[nullable]__ A reference to an #az_curl_connection_options structure which
+ * defines custom behavior of the #az_curl_connection. If `NULL` is passed, the connection will use
+ * the default options (i.e. #az_curl_connection_options_default()).
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The #az_curl_connection is initialized successfully.
+ * @retval #AZ_ERROR_HTTP_ADAPTER libcurl failed to create a handle.
+ *
+ * @remarks `curl_global_init` must be called before this function. Every successfully initialized
+ * #az_curl_connection must be released with #az_curl_connection_deinit().
+ */
+AZ_NODISCARD az_result az_curl_connection_init(
+    az_curl_connection* out_connection,
+    az_curl_connection_options const* options);
+
+/**
+ * @brief Closes every connection kept open by an #az_curl_connection and releases its resources.
+ *
+ * @param[in,out] ref_connection The #az_curl_connection to release.
+ *
+ * @remarks If \p ref_connection is the one set by #az_curl_set_default_connection(), the default
+ * connection is cleared as well.
+ */
+void az_curl_connection_deinit(az_curl_connection* ref_connection);
+
+/**
+ * @brief Sends an HTTP request through an #az_curl_connection and writes the response into \p
+ * ref_response.
+ *
+ * @param[in,out] ref_connection The #az_curl_connection to send the request with.
+ * @param[in] request Points to an #az_http_request that contains the settings and data that is
+ * used to send the request through the wire.
+ * @param[in,out] ref_response Points to an #az_http_response where the response from the wire will
+ * be written.
+ *
+ * @return An #az_result value indicating the result of the operation. See
+ * #az_http_client_send_request() for the possible values.
+ */
+AZ_NODISCARD az_result az_curl_connection_send_request(
+    az_curl_connection* ref_connection,
+    az_http_request const* request,
+    az_http_response* ref_response);
+
+/**
+ * @brief Sets the #az_curl_connection used by #az_http_client_send_request(), and therefore by
+ * every HTTP pipeline, to send requests.
+ *
+ * @param[in] connection __[nullable]__ The #az_curl_connection to use. If `NULL`, a new libcurl
+ * handle is created and destroyed for every request.
+ *
+ * @remarks By default, this is `NULL`. Since an #az_curl_connection must not be used by more than
+ * one thread at a time, only set a default connection when HTTP requests are sent from a single
+ * thread.
+ */
+void az_curl_set_default_connection(az_curl_connection* connection);
+
+/**
+ * @brief The progress of the upload of a request body by the `az::curl` transport adapter.
+ */
+typedef struct
+{
+  struct
+  {
+    az_http_request const* request;
+    az_span segment; // The part of the current body segment that curl didn't read yet.
+    int64_t offset; // The offset in the body of the next segment to get.
+  } _internal;
+} _az_curl_upload;
+
+/**
+ * @brief Allows the user to define how #az_curl_multi_submit() sends a request.
+ */
+typedef struct
+{
+  /// The options of the retry policy, which sends the request again when its response asks for a
+  /// retry. The default `max_retries` is 0, so the request isn't retried.
+  az_http_policy_retry_options retry_options;
+
+  struct
+  {
+    // The _az_http_pipeline of a service client, which the request is sent through instead, or
+    // NULL.
+    void* pipeline;
+  } _internal;
+} az_curl_multi_submit_options;
+
+/**
+ * @brief Gets the default #az_curl_multi_submit_options.
+ *
+ * @details Call this to obtain an initialized #az_curl_multi_submit_options structure that can be
+ * modified and passed to #az_curl_multi_submit().
+ *
+ * @return The default #az_curl_multi_submit_options.
+ */
+AZ_NODISCARD az_curl_multi_submit_options az_curl_multi_submit_options_default();
+
+/**
+ * @brief A request sent asynchronously by an #az_curl_multi.
+ */
+typedef struct az_curl_multi_request az_curl_multi_request;
+
+/**
+ * @brief Defines the signature of the callback function invoked by #az_curl_multi_poll() when a
+ * request submitted with #az_curl_multi_submit() completes.
+ *
+ * @param[in,out] request The #az_curl_multi_request which completed. It can be submitted again,
+ * or released, once this callback returns.
+ * @param[in] result The result of sending the request. See #az_http_client_send_request() for the
+ * possible values. #AZ_ERROR_CANCELED is returned for a request whose context expired before a
+ * retry, or which was pending when the #az_curl_multi was released.
+ * @param[in] user_context The user context passed to #az_curl_multi_submit().
+ */
+typedef void (*az_curl_multi_completion_fn)(
+    az_curl_multi_request* request,
+    az_result result,
+    void* user_context);
+
+/**
+ * @brief A request sent asynchronously by an #az_curl_multi.
+ *
+ * @remarks The caller owns the storage of an #az_curl_multi_request, which must not be modified
+ * or moved from the time it is submitted until its #az_curl_multi_completion_fn is invoked.
+ */
+struct az_curl_multi_request
+{
+  struct
+  {
+    void* curl;
+    void* headers;
+    _az_curl_upload upload;
+    az_curl_multi_submit_options options;
+    az_http_request* request;
+    az_http_response* response;
+    az_curl_multi_completion_fn completion_callback;
+    void* user_context;
+    az_curl_multi_request* previous;
+    az_curl_multi_request* next;
+    int64_t start_msec;
+    int64_t retry_at_msec;
+    int32_t attempt;
+  } _internal;
+};
+
+/**
+ * @brief Sends many HTTP requests concurrently from a single thread, using the libcurl multi
+ * interface.
+ *
+ * @details Requests are submitted with #az_curl_multi_submit(), and sent while
+ * #az_curl_multi_poll() is called, which invokes the completion callback of each request once its
+ * response is received. A request to retry is rescheduled, instead of waiting for its retry delay.
+ * Requests to the same host share open connections.
+ *
+ * @remarks An #az_curl_multi must not be used by more than one thread at a time.
+ */
+typedef struct
+{
+  struct
+  {
+    void* multi;
+    az_curl_multi_request* requests;
+    az_curl_connection_options options;
+    int32_t pending_count;
+  } _internal;
+} az_curl_multi;
+
+/**
+ * @brief Initializes an #az_curl_multi.
+ *
+ * @param[out] out_multi A pointer to an #az_curl_multi instance to initialize.
+ * @param[in] options __[nullable]__ A reference to an #az_curl_connection_options structure which
+ * defines how connections are kept open. If `NULL` is passed, the default options are used (i.e.
+ * #az_curl_connection_options_default()).
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The #az_curl_multi is initialized successfully.
+ * @retval #AZ_ERROR_HTTP_ADAPTER libcurl failed to create a multi handle.
+ *
+ * @remarks `curl_global_init` must be called before this function. Every successfully initialized
+ * #az_curl_multi must be released with #az_curl_multi_deinit().
+ */
+AZ_NODISCARD az_result
+az_curl_multi_init(az_curl_multi* out_multi, az_curl_connection_options const* options);
+
+/**
+ * @brief Releases an #az_curl_multi, and its connections.
+ *
+ * @details The completion callback of each request that is still pending is invoked with
+ * #AZ_ERROR_CANCELED.
+ *
+ * @param[in,out] ref_multi The #az_curl_multi to release.
+ */
+void az_curl_multi_deinit(az_curl_multi* ref_multi);
+
+/**
+ * @brief Prepares an HTTP request and submits it to be sent by #az_curl_multi_poll().
+ *
+ * @details The response is checked by the retry policy of \p options once it is received, and a
+ * request to retry is sent again from #az_curl_multi_poll() once its retry delay has passed.
+ *
+ * @param[in,out] ref_multi The #az_curl_multi to send the request with.
+ * @param[out] out_request The #az_curl_multi_request which tracks the request until it completes.
+ * @param[in] options __[nullable]__ A reference to an #az_curl_multi_submit_options structure which
+ * defines how the request is sent. If `NULL` is passed, the default options are used (i.e.
+ * #az_curl_multi_submit_options_default()), and the request is sent once, as it is.
+ * @param[in,out] ref_request The #az_http_request to send. It must not be used by anything else
+ * until the request completes.
+ * @param[in,out] ref_response The #az_http_response where the response is written.
+ * @param[in] completion_callback The function invoked when the request completes.
+ * @param[in] user_context __[nullable]__ A value passed to \p completion_callback.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The request is submitted, and \p completion_callback will be invoked.
+ * @retval other The request could not be prepared or submitted, and \p completion_callback won't
+ * be invoked.
+ */
+AZ_NODISCARD az_result az_curl_multi_submit(
+    az_curl_multi* ref_multi,
+    az_curl_multi_request* out_request,
+    az_curl_multi_submit_options const* options,
+    az_http_request* ref_request,
+    az_http_response* ref_response,
+    az_curl_multi_completion_fn completion_callback,
+    void* user_context);
+
+/**
+ * @brief Sends and receives data for the submitted requests, waiting up to \p timeout_msec for
+ * any of them to make progress, and invokes the completion callback of each request which
+ * completes.
+ *
+ * @param[in,out] ref_multi The #az_curl_multi to poll.
+ * @param[in] timeout_msec The maximum time, in milliseconds, to wait. If 0, the function returns
+ * without waiting.
+ * @param[out] out_pending_count __[nullable]__ The number of submitted requests which haven't
+ * completed yet, including the ones waiting to be retried.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK Success.
+ * @retval #AZ_ERROR_HTTP_ADAPTER The libcurl multi interface failed.
+ */
+AZ_NODISCARD az_result
+az_curl_multi_poll(az_curl_multi* ref_multi, int32_t timeout_msec, int32_t* out_pending_count);
+
+#include <azure/core/_az_cfg_suffix.h>
+
+#endif // _az_CURL_H
@@ -1,9 +1,15 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // SPDX-License-Identifier: MIT
 
+#include "az_http_policy_logging_private.h"
+#include "az_http_private.h"
+#include <azure/core/az_context.h>
 #include <azure/core/az_http.h>
+#include <azure/core/az_platform.h>
 #include <azure/core/internal/az_http_internal.h>
+#include <azure/core/internal/az_log_internal.h>
 #include <azure/core/internal/az_precondition_internal.h>
+#include <azure/core/internal/az_result_internal.h>
 
 #include <azure/core/_az_cfg.h>
 
@@ -16,9 +22,195 @@ AZ_NODISCARD az_result az_http_pipeline_process(
   _az_PRECONDITION_NOT_NULL(ref_response);
   _az_PRECONDITION_NOT_NULL(ref_pipeline);
 
-  return ref_pipeline->_internal.policies[0]._internal.process(
-      &(ref_pipeline->_internal.policies[1]),
-      ref_pipeline->_internal.policies[0]._internal.options,
-      ref_request,
-      ref_response);
+  _az_http_policy* policies = ref_pipeline->_internal.policies;
+
+  if (ref_request->_internal.retry_attempt > 0)
+  {
+    // The retry policy deferred a retry of this request to the caller. Resume at the retry policy,
+    // since the headers added by the policies before it are still in the request.
+    for (int32_t i = 0; i < _az_MAXIMUM_NUMBER_OF_POLICIES; ++i)
+    {
+      if (policies[i]._internal.process == az_http_pipeline_policy_retry)
+      {
+        policies = &policies[i];
+        break;
+      }
+    }
+  }
+
+  return _az_http_pipeline_nextpolicy(policies, ref_request, ref_response);
+}
+
+static AZ_NODISCARD az_result _az_http_pipeline_policy_retry_prepare(
+    _az_http_policy* ref_policies,
+    void* ref_options,
+    az_http_request* ref_request,
+    az_http_response* ref_response)
+{
+  (void)ref_options;
+
+  // The retry policy of an asynchronous request only marks where the headers which are added again
+  // for every attempt start. The caller schedules the retries.
+  _az_RETURN_IF_FAILED(_az_http_request_mark_retry_headers_start(ref_request));
+
+  return _az_http_pipeline_nextpolicy(ref_policies, ref_request, ref_response);
+}
+
+#ifndef AZ_NO_LOGGING
+static AZ_NODISCARD az_result _az_http_pipeline_policy_logging_prepare(
+    _az_http_policy* ref_policies,
+    void* ref_options,
+    az_http_request* ref_request,
+    az_http_response* ref_response)
+{
+  (void)ref_options;
+
+  // The response is logged by _az_http_pipeline_complete_request(), once it is received.
+  if (_az_LOG_SHOULD_WRITE(AZ_LOG_HTTP_REQUEST))
+  {
+    _az_http_policy_logging_log_http_request(ref_request);
+  }
+
+  return _az_http_pipeline_nextpolicy(ref_policies, ref_request, ref_response);
+}
+#endif // AZ_NO_LOGGING
+
+static AZ_NODISCARD az_result _az_http_pipeline_policy_transport_prepare(
+    _az_http_policy* ref_policies,
+    void* ref_options,
+    az_http_request* ref_request,
+    az_http_response* ref_response)
+{
+  (void)ref_policies;
+  (void)ref_options;
+  (void)ref_request;
+
+  // The request is ready to be sent, which is left to the caller.
+  _az_http_response_reset(ref_response);
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result _az_http_pipeline_prepare_request(
+    _az_http_pipeline* ref_pipeline,
+    az_http_request* ref_request,
+    az_http_response* ref_response,
+    int32_t attempt)
+{
+  _az_PRECONDITION_NOT_NULL(ref_pipeline);
+  _az_PRECONDITION_NOT_NULL(ref_request);
+  _az_PRECONDITION_NOT_NULL(ref_response);
+  _az_PRECONDITION(attempt > 0);
+
+  bool const is_retry = attempt > 1;
+  if (is_retry)
+  {
+    az_context* const context = ref_request->_internal.context;
+    if (context != NULL)
+    {
+      int64_t clock = 0;
+      _az_RETURN_IF_FAILED(az_platform_clock_msec(&clock));
+      if (az_context_has_expired(context, clock))
+      {
+        return AZ_ERROR_CANCELED;
+      }
+    }
+
+    _az_RETURN_IF_FAILED(_az_http_request_remove_retry_headers(ref_request));
+  }
+
+  // Run a copy of the pipeline, where the policies which would wait for the response only do the
+  // part of their work which comes before sending the request. A retry only runs the policies which
+  // come after the retry policy, as the synchronous retry policy does.
+  _az_http_pipeline pipeline = *ref_pipeline;
+  _az_http_policy* policies = pipeline._internal.policies;
+  az_http_policy_retry_options const* retry_options = NULL;
+  for (int32_t i = 0; i < _az_MAXIMUM_NUMBER_OF_POLICIES; ++i)
+  {
+    _az_http_policy_process_fn const process = pipeline._internal.policies[i]._internal.process;
+    if (process == az_http_pipeline_policy_retry)
+    {
+      retry_options
+          = (az_http_policy_retry_options const*)pipeline._internal.policies[i]._internal.options;
+      pipeline._internal.policies[i]._internal.process = _az_http_pipeline_policy_retry_prepare;
+      if (is_retry)
+      {
+        if (i + 1 == _az_MAXIMUM_NUMBER_OF_POLICIES)
+        {
+          return AZ_ERROR_HTTP_PIPELINE_INVALID_POLICY;
+        }
+
+        policies = &pipeline._internal.policies[i + 1];
+      }
+    }
+#ifndef AZ_NO_LOGGING
+    else if (process == az_http_pipeline_policy_logging)
+    {
+      pipeline._internal.policies[i]._internal.process = _az_http_pipeline_policy_logging_prepare;
+    }
+#endif // AZ_NO_LOGGING
+    else if (process == az_http_pipeline_policy_transport)
+    {
+      pipeline._internal.policies[i]._internal.process = _az_http_pipeline_policy_transport_prepare;
+    }
+  }
+
+  _az_RETURN_IF_FAILED(_az_http_pipeline_nextpolicy(policies, ref_request, ref_response));
+
+  // As with the synchronous retry policy, the body of a response which is retried isn't passed to
+  // the body callback.
+  ref_response->_internal.is_retriable
+      = retry_options != NULL && attempt <= retry_options->max_retries;
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result _az_http_pipeline_complete_request(
+    _az_http_pipeline const* pipeline,
+    az_http_request const* request,
+    az_http_response const* response,
+    az_result transport_result,
+    int64_t duration_msec,
+    int32_t attempt,
+    int32_t* out_retry_after_msec)
+{
+  _az_PRECONDITION_NOT_NULL(pipeline);
+  _az_PRECONDITION_NOT_NULL(request);
+  _az_PRECONDITION_NOT_NULL(response);
+  _az_PRECONDITION_NOT_NULL(out_retry_after_msec);
+
+#ifdef AZ_NO_LOGGING
+  (void)request;
+  (void)duration_msec;
+#endif // AZ_NO_LOGGING
+
+  *out_retry_after_msec = -1;
+
+  az_http_policy_retry_options const* retry_options = NULL;
+  for (int32_t i = 0; i < _az_MAXIMUM_NUMBER_OF_POLICIES; ++i)
+  {
+    _az_http_policy const* const policy = &pipeline->_internal.policies[i];
+    if (policy->_internal.process == az_http_pipeline_policy_retry)
+    {
+      retry_options = (az_http_policy_retry_options const*)policy->_internal.options;
+    }
+#ifndef AZ_NO_LOGGING
+    else if (
+        policy->_internal.process == az_http_pipeline_policy_logging
+        && _az_LOG_SHOULD_WRITE(AZ_LOG_HTTP_RESPONSE))
+    {
+      _az_http_policy_logging_log_http_response(response, duration_msec, request);
+    }
+#endif // AZ_NO_LOGGING
+  }
+
+  // Even HTTP 429, or 502 are expected to be AZ_OK, so the failed result is not retriable.
+  if (retry_options == NULL || az_result_failed(transport_result))
+  {
+    return transport_result;
+  }
+
+  _az_RETURN_IF_FAILED(_az_http_policy_retry_get_retry_delay(
+      retry_options, attempt, response, out_retry_after_msec));
+
+  return transport_result;
 }
@@ -24,6 +24,7 @@ AZ_NODISCARD az_http_policy_retry_options _az_http_policy_retry_options_default(
     .retry_delay_msec = 4 * _az_TIME_MILLISECONDS_PER_SECOND, // 4 seconds
     .max_retry_delay_msec
     = 2 * _az_TIME_SECONDS_PER_MINUTE * _az_TIME_MILLISECONDS_PER_SECOND, // 2 minutes
+    .defer_retries = false,
   };
 }
 
@@ -75,23 +76,6 @@ AZ_INLINE AZ_NODISCARD int32_t _az_uint32_span_to_int32(az_span span)
   return value < INT32_MAX ? (int32_t)value : INT32_MAX;
 }
 
-AZ_INLINE AZ_NODISCARD bool _az_http_policy_retry_should_retry_http_response_code(
-    az_http_status_code http_response_code)
-{
-  switch (http_response_code)
-  {
-    case AZ_HTTP_STATUS_CODE_REQUEST_TIMEOUT:
-    case AZ_HTTP_STATUS_CODE_TOO_MANY_REQUESTS:
-    case AZ_HTTP_STATUS_CODE_INTERNAL_SERVER_ERROR:
-    case AZ_HTTP_STATUS_CODE_BAD_GATEWAY:
-    case AZ_HTTP_STATUS_CODE_SERVICE_UNAVAILABLE:
-    case AZ_HTTP_STATUS_CODE_GATEWAY_TIMEOUT:
-      return true;
-    default:
-      return false;
-  }
-}
-
 AZ_INLINE AZ_NODISCARD az_result _az_http_policy_retry_get_retry_after(
     az_http_response* ref_response,
     bool* should_retry,
@@ -150,6 +134,65 @@ AZ_INLINE AZ_NODISCARD az_result _az_http_policy_retry_get_retry_after(
   return AZ_OK;
 }
 
+AZ_NODISCARD az_result _az_http_policy_retry_get_retry_delay(
+    az_http_policy_retry_options const* retry_options,
+    int32_t attempt,
+    az_http_response const* response,
+    int32_t* out_retry_after_msec)
+{
+  _az_PRECONDITION_NOT_NULL(retry_options);
+  _az_PRECONDITION_NOT_NULL(response);
+  _az_PRECONDITION_NOT_NULL(out_retry_after_msec);
+
+  *out_retry_after_msec = -1;
+
+  if (attempt > retry_options->max_retries)
+  {
+    return AZ_OK;
+  }
+
+  int32_t retry_after_msec = -1;
+  bool should_retry = false;
+  az_http_response response_copy = *response;
+
+  _az_RETURN_IF_FAILED(
+      _az_http_policy_retry_get_retry_after(&response_copy, &should_retry, &retry_after_msec));
+
+  if (!should_retry)
+  {
+    return AZ_OK;
+  }
+
+  if (retry_after_msec < 0)
+  { // there wasn't any kind of "retry-after" response header
+    retry_after_msec = _az_retry_calc_delay(
+        attempt + 1, retry_options->retry_delay_msec, retry_options->max_retry_delay_msec);
+  }
+
+  if (_az_LOG_SHOULD_WRITE(AZ_LOG_HTTP_RETRY))
+  {
+    _az_http_policy_retry_log(attempt + 1, retry_after_msec);
+  }
+
+  *out_retry_after_msec = retry_after_msec;
+  return AZ_OK;
+}
+
+static AZ_NODISCARD az_result _az_http_policy_retry_check_context(az_context* context)
+{
+  if (context != NULL)
+  {
+    int64_t clock = 0;
+    _az_RETURN_IF_FAILED(az_platform_clock_msec(&clock));
+    if (az_context_has_expired(context, clock))
+    {
+      return AZ_ERROR_CANCELED;
+    }
+  }
+
+  return AZ_OK;
+}
+
 AZ_NODISCARD az_result az_http_pipeline_policy_retry(
     _az_http_policy* ref_policies,
     void* ref_options,
@@ -159,66 +202,66 @@ AZ_NODISCARD az_result az_http_pipeline_policy_retry(
   az_http_policy_retry_options const* const retry_options
       = (az_http_policy_retry_options const*)ref_options;
 
-  int32_t const max_retries = retry_options->max_retries;
-  int32_t const retry_delay_msec = retry_options->retry_delay_msec;
-  int32_t const max_retry_delay_msec = retry_options->max_retry_delay_msec;
-
-  _az_RETURN_IF_FAILED(_az_http_request_mark_retry_headers_start(ref_request));
-
   az_context* const context = ref_request->_internal.context;
 
-  bool const should_log = _az_LOG_SHOULD_WRITE(AZ_LOG_HTTP_RETRY);
   az_result result = AZ_OK;
   int32_t attempt = 1;
+
+  if (ref_request->_internal.retry_attempt > 0)
+  {
+    // The caller sends again a request whose retry was deferred. The headers added by the policies
+    // before this one are still in the request, and the retry headers start where they did.
+    attempt = ref_request->_internal.retry_attempt + 1;
+    ref_request->_internal.retry_attempt = 0;
+
+    _az_RETURN_IF_FAILED(_az_http_policy_retry_check_context(context));
+  }
+  else
+  {
+    _az_RETURN_IF_FAILED(_az_http_request_mark_retry_headers_start(ref_request));
+  }
+
   while (true)
   {
-    _az_RETURN_IF_FAILED(
-        az_http_response_init(ref_response, ref_response->_internal.http_response));
+    _az_http_response_reset(ref_response);
     _az_RETURN_IF_FAILED(_az_http_request_remove_retry_headers(ref_request));
 
+    // The body of a response which is retried isn't passed to the body callback.
+    ref_response->_internal.is_retriable = attempt <= retry_options->max_retries;
     result = _az_http_pipeline_nextpolicy(ref_policies, ref_request, ref_response);
+    ref_response->_internal.is_retriable = false;
 
     // Even HTTP 429, or 502 are expected to be AZ_OK, so the failed result is not retriable.
-    if (attempt > max_retries || az_result_failed(result))
+    if (az_result_failed(result))
     {
       return result;
     }
 
     int32_t retry_after_msec = -1;
-    bool should_retry = false;
-    az_http_response response_copy = *ref_response;
+    _az_RETURN_IF_FAILED(_az_http_policy_retry_get_retry_delay(
+        retry_options, attempt, ref_response, &retry_after_msec));
 
-    _az_RETURN_IF_FAILED(
-        _az_http_policy_retry_get_retry_after(&response_copy, &should_retry, &retry_after_msec));
-
-    if (!should_retry)
+    if (retry_after_msec < 0)
     {
       return result;
     }
 
-    ++attempt;
+    if (retry_options->defer_retries)
+    {
+      // Leave the retry to the caller, which can reschedule it without parking this thread.
+      int64_t clock = 0;
+      _az_RETURN_IF_FAILED(az_platform_clock_msec(&clock));
 
-    if (retry_after_msec < 0)
-    { // there wasn't any kind of "retry-after" response header
-      retry_after_msec = _az_retry_calc_delay(attempt, retry_delay_msec, max_retry_delay_msec);
+      ref_request->_internal.retry_at_msec = clock + retry_after_msec;
+      ref_request->_internal.retry_after_msec = retry_after_msec;
+      ref_request->_internal.retry_attempt = attempt;
+      return AZ_ERROR_HTTP_RETRY_PENDING;
     }
 
-    if (should_log)
-    {
-      _az_http_policy_retry_log(attempt, retry_after_msec);
-    }
+    ++attempt;
 
     _az_RETURN_IF_FAILED(az_platform_sleep_msec(retry_after_msec));
-
-    if (context != NULL)
-    {
-      int64_t clock = 0;
-      _az_RETURN_IF_FAILED(az_platform_clock_msec(&clock));
-      if (az_context_has_expired(context, clock))
-      {
-        return AZ_ERROR_CANCELED;
-      }
-    }
+    _az_RETURN_IF_FAILED(_az_http_policy_retry_check_context(context));
   }
 
   return result;
@@ -41,6 +41,44 @@ AZ_NODISCARD AZ_INLINE az_result _az_http_request_remove_retry_headers(az_http_r
   return AZ_OK;
 }
 
+/**
+ * @brief Computes how long to wait before retrying a request, according to the retry policy
+ * options and the response to the attempt which just completed.
+ *
+ * @param[in] retry_options The options of the retry policy.
+ * @param[in] attempt The number of the attempt which received \p response, starting from 1.
+ * @param[in] response The response received by that attempt.
+ * @param[out] out_retry_after_msec The delay, in milliseconds, before the next attempt, honoring
+ * the `Retry-After` response headers, or -1 if the request must not be retried.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ */
+AZ_NODISCARD az_result _az_http_policy_retry_get_retry_delay(
+    az_http_policy_retry_options const* retry_options,
+    int32_t attempt,
+    az_http_response const* response,
+    int32_t* out_retry_after_msec);
+
+/**
+ * @brief Whether the retry policy retries a response with the status code \p http_response_code.
+ */
+AZ_NODISCARD AZ_INLINE bool _az_http_policy_retry_should_retry_http_response_code(
+    az_http_status_code http_response_code)
+{
+  switch (http_response_code)
+  {
+    case AZ_HTTP_STATUS_CODE_REQUEST_TIMEOUT:
+    case AZ_HTTP_STATUS_CODE_TOO_MANY_REQUESTS:
+    case AZ_HTTP_STATUS_CODE_INTERNAL_SERVER_ERROR:
+    case AZ_HTTP_STATUS_CODE_BAD_GATEWAY:
+    case AZ_HTTP_STATUS_CODE_SERVICE_UNAVAILABLE:
+    case AZ_HTTP_STATUS_CODE_GATEWAY_TIMEOUT:
+      return true;
+    default:
+      return false;
+  }
+}
+
 /**
  * @brief Sets buffer and parser to its initial state.
  *
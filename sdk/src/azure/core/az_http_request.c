@@ -58,6 +58,12 @@ AZ_NODISCARD az_result az_http_request_init(
                                    / (int32_t)sizeof(_az_http_request_header),
                                .retry_headers_start_byte_offset = 0,
                                .body = body,
+                               .body_callback = NULL,
+                               .body_callback_context = NULL,
+                               .body_size = az_span_size(body),
+                               .retry_at_msec = 0,
+                               .retry_after_msec = 0,
+                               .retry_attempt = 0,
                            } };
 
   return AZ_OK;
@@ -80,40 +86,37 @@ AZ_NODISCARD az_result az_http_request_set_query_parameter(
   az_span url_remainder = az_span_slice_to_end(ref_request->_internal.url, initial_url_length);
 
   // Adding query parameter. Adding +2 to required length to include extra required symbols `=`
-  // and `?` or `&`.
-  int32_t required_length = 2 + az_span_size(name)
-      + (is_value_url_encoded ? az_span_size(value) : _az_span_url_encode_calc_length(value));
-
-  _az_RETURN_IF_NOT_ENOUGH_SIZE(url_remainder, required_length);
+  // and `?` or `&`. The value is at least as long once it is URL-encoded.
+  int32_t const prefix_length = 2 + az_span_size(name);
+  _az_RETURN_IF_NOT_ENOUGH_SIZE(url_remainder, prefix_length + az_span_size(value));
 
   // Append either '?' or '&'
-  uint8_t separator = '&';
-  if (ref_request->_internal.query_start == 0)
-  {
-    separator = '?';
-
-    // update QPs starting position when it's 0
-    ref_request->_internal.query_start = initial_url_length + 1;
-  }
-
-  url_remainder = az_span_copy_u8(url_remainder, separator);
+  bool const is_first_query_parameter = ref_request->_internal.query_start == 0;
+  url_remainder = az_span_copy_u8(url_remainder, is_first_query_parameter ? '?' : '&');
   url_remainder = az_span_copy(url_remainder, name);
 
   // Append equal sym
   url_remainder = az_span_copy_u8(url_remainder, '=');
 
-  // Parameter value
+  // Parameter value. It is URL-encoded in a single pass, which fails if the URL runs out of space,
+  // without computing the encoded length first. The URL length isn't updated until then.
+  int32_t value_length = az_span_size(value);
   if (is_value_url_encoded)
   {
     az_span_copy(url_remainder, value);
   }
   else
   {
-    int32_t encoding_size = 0;
-    _az_RETURN_IF_FAILED(_az_span_url_encode(url_remainder, value, &encoding_size));
+    _az_RETURN_IF_FAILED(_az_span_url_encode(url_remainder, value, &value_length));
   }
 
-  ref_request->_internal.url_length += required_length;
+  if (is_first_query_parameter)
+  {
+    // update QPs starting position when it's 0
+    ref_request->_internal.query_start = initial_url_length + 1;
+  }
+
+  ref_request->_internal.url_length += prefix_length + value_length;
 
   return AZ_OK;
 }
@@ -202,6 +205,78 @@ AZ_NODISCARD az_result az_http_request_get_body(az_http_request const* request,
   return AZ_OK;
 }
 
+AZ_NODISCARD az_result az_http_request_set_body_callback(
+    az_http_request* ref_request,
+    az_http_request_body_fn body_callback,
+    int64_t body_size,
+    void* user_context)
+{
+  _az_PRECONDITION_NOT_NULL(ref_request);
+  _az_PRECONDITION_NOT_NULL(body_callback);
+  _az_PRECONDITION(body_size >= -1);
+
+  ref_request->_internal.body = AZ_SPAN_EMPTY;
+  ref_request->_internal.body_callback = body_callback;
+  ref_request->_internal.body_callback_context = user_context;
+  ref_request->_internal.body_size = body_size;
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result
+az_http_request_get_body_size(az_http_request const* request, int64_t* out_body_size)
+{
+  _az_PRECONDITION_NOT_NULL(request);
+  _az_PRECONDITION_NOT_NULL(out_body_size);
+
+  *out_body_size = request->_internal.body_size;
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_http_request_get_body_segment(
+    az_http_request const* request,
+    int64_t offset,
+    az_span* out_segment)
+{
+  _az_PRECONDITION_NOT_NULL(request);
+  _az_PRECONDITION_NOT_NULL(out_segment);
+  _az_PRECONDITION(offset >= 0);
+
+  if (request->_internal.body_callback != NULL)
+  {
+    *out_segment = AZ_SPAN_EMPTY;
+    return request->_internal.body_callback(
+        offset, out_segment, request->_internal.body_callback_context);
+  }
+
+  az_span const body = request->_internal.body;
+  *out_segment = offset < az_span_size(body) ? az_span_slice_to_end(body, (int32_t)offset)
+                                             : AZ_SPAN_EMPTY;
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_http_request_get_retry_at_msec(
+    az_http_request const* request,
+    int64_t* out_retry_at_msec,
+    int32_t* out_retry_after_msec)
+{
+  _az_PRECONDITION_NOT_NULL(request);
+  _az_PRECONDITION_NOT_NULL(out_retry_at_msec);
+
+  if (request->_internal.retry_attempt == 0)
+  {
+    return AZ_ERROR_HTTP_INVALID_STATE;
+  }
+
+  *out_retry_at_msec = request->_internal.retry_at_msec;
+  if (out_retry_after_msec != NULL)
+  {
+    *out_retry_after_msec = request->_internal.retry_after_msec;
+  }
+
+  return AZ_OK;
+}
+
 AZ_NODISCARD int32_t az_http_request_headers_count(az_http_request const* request)
 {
   return request->_internal.headers_length;
@@ -310,8 +310,11 @@ AZ_NODISCARD az_result az_http_response_get_body(az_http_response* ref_response,
     }
   }
 
-  // take all the remaining content from reader as body
-  *out_body = az_span_slice_to_end(ref_response->_internal.parser.remaining, 0);
+  // take all the remaining content from reader as body, unless the body was passed to a callback
+  // instead of being written into the buffer
+  *out_body = ref_response->_internal.body_callback == NULL
+      ? az_span_slice_to_end(ref_response->_internal.parser.remaining, 0)
+      : az_span_slice(ref_response->_internal.parser.remaining, 0, 0);
 
   ref_response->_internal.parser.next_kind = _az_HTTP_RESPONSE_KIND_EOF;
   return AZ_OK;
@@ -319,11 +322,20 @@ AZ_NODISCARD az_result az_http_response_get_body(az_http_response* ref_response,
 
 void _az_http_response_reset(az_http_response* ref_response)
 {
+  az_http_response_body_fn const body_callback = ref_response->_internal.body_callback;
+  void* const body_callback_context = ref_response->_internal.body_callback_context;
+  bool const is_retriable = ref_response->_internal.is_retriable;
+
   // never fails, discard the result
   // init will set written to 0 and will use the same az_span. Internal parser's state is also
   // reset
   az_result result = az_http_response_init(ref_response, ref_response->_internal.http_response);
   (void)result;
+
+  // The body callback is kept for the next response written into the same az_http_response, and
+  // whether the retry policy retries it is kept for the transport policy, which resets it too.
+  az_http_response_set_body_callback(ref_response, body_callback, body_callback_context);
+  ref_response->_internal.is_retriable = is_retriable;
 }
 
 // internal function to get az_http_response remainder
@@ -345,3 +357,36 @@ AZ_NODISCARD az_result az_http_response_append(az_http_response* ref_response, a
 
   return AZ_OK;
 }
+
+AZ_NODISCARD az_result az_http_response_append_body(az_http_response* ref_response, az_span source)
+{
+  _az_PRECONDITION_NOT_NULL(ref_response);
+
+  az_http_response_body_fn const body_callback = ref_response->_internal.body_callback;
+  if (body_callback != NULL)
+  {
+    if (ref_response->_internal.is_retriable)
+    {
+      if (ref_response->_internal.body_status_code == AZ_HTTP_STATUS_CODE_NONE)
+      {
+        // The status line was received before the body. Parse it once, from a copy, so the parser
+        // of the response isn't moved.
+        az_http_response response_copy = *ref_response;
+        az_http_response_status_line status_line = { 0 };
+        _az_RETURN_IF_FAILED(az_http_response_get_status_line(&response_copy, &status_line));
+        ref_response->_internal.body_status_code = status_line.status_code;
+      }
+
+      if (_az_http_policy_retry_should_retry_http_response_code(
+              ref_response->_internal.body_status_code))
+      {
+        // The request is sent again, so the body of this attempt is dropped.
+        return AZ_OK;
+      }
+    }
+
+    return body_callback(source, ref_response->_internal.body_callback_context);
+  }
+
+  return az_http_response_append(ref_response, source);
+}
@@ -0,0 +1,192 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <azure/core/az_json.h>
+#include <azure/core/internal/az_precondition_internal.h>
+#include <azure/core/internal/az_result_internal.h>
+#include <azure/core/internal/az_span_internal.h>
+
+#include "az_json_private.h"
+#include "az_span_private.h"
+
+#include <azure/core/_az_cfg.h>
+
+AZ_NODISCARD static az_json_binding_field const* _az_json_binding_find_field(
+    az_json_binding const* binding,
+    az_json_token const* property_name)
+{
+  for (int32_t i = 0; i < binding->fields_length; i++)
+  {
+    if (az_json_token_is_text_equal(property_name, binding->fields[i].name))
+    {
+      return &binding->fields[i];
+    }
+  }
+  return NULL;
+}
+
+AZ_NODISCARD static az_result _az_json_binding_read_string(
+    az_json_token const* json_token,
+    az_span buffer,
+    int32_t* out_length)
+{
+  // The buffer is left as is, so that its size is still known when the struct is read again.
+  return az_json_token_get_string(
+      json_token, (char*)az_span_ptr(buffer), az_span_size(buffer), out_length);
+}
+
+AZ_NODISCARD static az_result _az_json_binding_read_object(
+    az_json_reader* ref_json_reader,
+    az_json_binding const* binding,
+    uint8_t* ref_value)
+{
+  if (ref_json_reader->token.kind != AZ_JSON_TOKEN_BEGIN_OBJECT)
+  {
+    return AZ_ERROR_JSON_INVALID_STATE;
+  }
+
+  while (true)
+  {
+    _az_RETURN_IF_FAILED(az_json_reader_next_token(ref_json_reader));
+    if (ref_json_reader->token.kind == AZ_JSON_TOKEN_END_OBJECT)
+    {
+      return AZ_OK;
+    }
+
+    az_json_binding_field const* const field
+        = _az_json_binding_find_field(binding, &ref_json_reader->token);
+
+    _az_RETURN_IF_FAILED(az_json_reader_next_token(ref_json_reader));
+    az_json_token const* const token = &ref_json_reader->token;
+
+    // Skip unknown properties, and leave the field unchanged for null.
+    if (field == NULL || token->kind == AZ_JSON_TOKEN_NULL)
+    {
+      _az_RETURN_IF_FAILED(az_json_reader_skip_children(ref_json_reader));
+      continue;
+    }
+
+    void* const field_ptr = ref_value + field->offset;
+    switch (field->kind)
+    {
+      case AZ_JSON_BINDING_BOOLEAN:
+        _az_RETURN_IF_FAILED(az_json_token_get_boolean(token, (bool*)field_ptr));
+        break;
+      case AZ_JSON_BINDING_INT32:
+        _az_RETURN_IF_FAILED(az_json_token_get_int32(token, (int32_t*)field_ptr));
+        break;
+      case AZ_JSON_BINDING_UINT32:
+        _az_RETURN_IF_FAILED(az_json_token_get_uint32(token, (uint32_t*)field_ptr));
+        break;
+      case AZ_JSON_BINDING_INT64:
+        _az_RETURN_IF_FAILED(az_json_token_get_int64(token, (int64_t*)field_ptr));
+        break;
+      case AZ_JSON_BINDING_UINT64:
+        _az_RETURN_IF_FAILED(az_json_token_get_uint64(token, (uint64_t*)field_ptr));
+        break;
+      case AZ_JSON_BINDING_DOUBLE:
+        _az_RETURN_IF_FAILED(az_json_token_get_double(token, (double*)field_ptr));
+        break;
+      case AZ_JSON_BINDING_STRING:
+        _az_RETURN_IF_FAILED(_az_json_binding_read_string(
+            token, *(az_span const*)field_ptr, (int32_t*)(ref_value + field->length_offset)));
+        break;
+      case AZ_JSON_BINDING_OBJECT:
+        _az_RETURN_IF_FAILED(
+            _az_json_binding_read_object(ref_json_reader, field->object, (uint8_t*)field_ptr));
+        break;
+      default:
+        _az_PRECONDITION(false);
+        return AZ_ERROR_ARG;
+    }
+  }
+}
+
+AZ_NODISCARD az_result az_json_binding_read(
+    az_json_reader* ref_json_reader,
+    az_json_binding const* binding,
+    void* ref_value)
+{
+  _az_PRECONDITION_NOT_NULL(ref_json_reader);
+  _az_PRECONDITION_NOT_NULL(binding);
+  _az_PRECONDITION_NOT_NULL(ref_value);
+
+  if (ref_json_reader->token.kind == AZ_JSON_TOKEN_NONE)
+  {
+    _az_RETURN_IF_FAILED(az_json_reader_next_token(ref_json_reader));
+  }
+
+  if (ref_json_reader->token.kind == AZ_JSON_TOKEN_PROPERTY_NAME)
+  {
+    _az_RETURN_IF_FAILED(az_json_reader_next_token(ref_json_reader));
+  }
+
+  return _az_json_binding_read_object(ref_json_reader, binding, (uint8_t*)ref_value);
+}
+
+AZ_NODISCARD static az_result _az_json_binding_write_field(
+    az_json_writer* ref_json_writer,
+    az_json_binding_field const* field,
+    uint8_t const* value)
+{
+  void const* const field_ptr = value + field->offset;
+
+  // Large enough for any 64-bit integer.
+  uint8_t number_buffer[_az_MAX_SIZE_FOR_INT64];
+  az_span const number_text = AZ_SPAN_FROM_BUFFER(number_buffer);
+  az_span remainder = AZ_SPAN_EMPTY;
+
+  switch (field->kind)
+  {
+    case AZ_JSON_BINDING_BOOLEAN:
+      return az_json_writer_append_bool(ref_json_writer, *(bool const*)field_ptr);
+    case AZ_JSON_BINDING_INT32:
+      return az_json_writer_append_int32(ref_json_writer, *(int32_t const*)field_ptr);
+    case AZ_JSON_BINDING_UINT32:
+      _az_RETURN_IF_FAILED(az_span_u32toa(number_text, *(uint32_t const*)field_ptr, &remainder));
+      break;
+    case AZ_JSON_BINDING_INT64:
+      _az_RETURN_IF_FAILED(az_span_i64toa(number_text, *(int64_t const*)field_ptr, &remainder));
+      break;
+    case AZ_JSON_BINDING_UINT64:
+      _az_RETURN_IF_FAILED(az_span_u64toa(number_text, *(uint64_t const*)field_ptr, &remainder));
+      break;
+    case AZ_JSON_BINDING_DOUBLE:
+      return az_json_writer_append_double_shortest(ref_json_writer, *(double const*)field_ptr);
+    case AZ_JSON_BINDING_STRING:
+      return az_json_writer_append_string(
+          ref_json_writer,
+          az_span_slice(
+              *(az_span const*)field_ptr, 0, *(int32_t const*)(value + field->length_offset)));
+    case AZ_JSON_BINDING_OBJECT:
+      return az_json_binding_write(ref_json_writer, field->object, field_ptr);
+    default:
+      _az_PRECONDITION(false);
+      return AZ_ERROR_ARG;
+  }
+
+  return _az_json_writer_append_number_text(
+      ref_json_writer, az_span_slice(number_text, 0, _az_span_diff(remainder, number_text)));
+}
+
+AZ_NODISCARD az_result az_json_binding_write(
+    az_json_writer* ref_json_writer,
+    az_json_binding const* binding,
+    void const* value)
+{
+  _az_PRECONDITION_NOT_NULL(ref_json_writer);
+  _az_PRECONDITION_NOT_NULL(binding);
+  _az_PRECONDITION_NOT_NULL(value);
+
+  _az_RETURN_IF_FAILED(az_json_writer_append_begin_object(ref_json_writer));
+
+  for (int32_t i = 0; i < binding->fields_length; i++)
+  {
+    az_json_binding_field const* const field = &binding->fields[i];
+    _az_RETURN_IF_FAILED(az_json_writer_append_property_name(ref_json_writer, field->name));
+    _az_RETURN_IF_FAILED(
+        _az_json_binding_write_field(ref_json_writer, field, (uint8_t const*)value));
+  }
+
+  return az_json_writer_append_end_object(ref_json_writer);
+}
@@ -0,0 +1,338 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <azure/core/az_json.h>
+#include <azure/core/internal/az_precondition_internal.h>
+#include <azure/core/internal/az_result_internal.h>
+
+#include <azure/core/_az_cfg.h>
+
+// The longest JSON Pointer reference token, containing ~0 or ~1 escapes, that can be decoded.
+enum
+{
+  _az_JSON_POINTER_MAX_ESCAPED_TOKEN_SIZE = 64,
+};
+
+AZ_NODISCARD AZ_INLINE bool _az_is_json_end_token(az_json_token_kind token_kind)
+{
+  return token_kind == AZ_JSON_TOKEN_END_OBJECT || token_kind == AZ_JSON_TOKEN_END_ARRAY;
+}
+
+AZ_NODISCARD az_result az_json_document_init(
+    az_json_document* out_document,
+    az_json_reader* ref_json_reader,
+    az_json_document_node* nodes,
+    int32_t nodes_length)
+{
+  _az_PRECONDITION_NOT_NULL(out_document);
+  _az_PRECONDITION_NOT_NULL(ref_json_reader);
+  _az_PRECONDITION_NOT_NULL(nodes);
+  _az_PRECONDITION(nodes_length > 0);
+
+  out_document->_internal.nodes = nodes;
+  out_document->_internal.node_count = 0;
+
+  if (ref_json_reader->token.kind == AZ_JSON_TOKEN_NONE)
+  {
+    _az_RETURN_IF_FAILED(az_json_reader_next_token(ref_json_reader));
+  }
+
+  if (ref_json_reader->token.kind == AZ_JSON_TOKEN_PROPERTY_NAME)
+  {
+    _az_RETURN_IF_FAILED(az_json_reader_next_token(ref_json_reader));
+  }
+
+  // An end token closes a value that started before the reader's current position, so there is no
+  // value to index.
+  if (_az_is_json_end_token(ref_json_reader->token.kind))
+  {
+    return AZ_ERROR_JSON_INVALID_STATE;
+  }
+
+  // Instead of a separate stack, each object or array that is still open stores the index of its
+  // enclosing open object or array in its end_index, which gets replaced once the matching end
+  // token is read. That way, indexing needs no memory other than the caller's nodes.
+  int32_t node_count = 0;
+  int32_t open_index = -1;
+  while (true)
+  {
+    if (node_count >= nodes_length)
+    {
+      return AZ_ERROR_NOT_ENOUGH_SPACE;
+    }
+
+    az_json_token_kind const token_kind = ref_json_reader->token.kind;
+    az_json_document_node* const node = &nodes[node_count];
+    node->token = ref_json_reader->token;
+    node->_internal.end_index = node_count;
+
+    if (token_kind == AZ_JSON_TOKEN_BEGIN_OBJECT || token_kind == AZ_JSON_TOKEN_BEGIN_ARRAY)
+    {
+      node->_internal.end_index = open_index;
+      open_index = node_count;
+    }
+    else if (_az_is_json_end_token(token_kind))
+    {
+      az_json_document_node* const begin_node = &nodes[open_index];
+      open_index = begin_node->_internal.end_index;
+      begin_node->_internal.end_index = node_count;
+    }
+
+    node_count++;
+    out_document->_internal.node_count = node_count;
+
+    if (open_index < 0)
+    {
+      // The root value is complete.
+      return AZ_OK;
+    }
+
+    _az_RETURN_IF_FAILED(az_json_reader_next_token(ref_json_reader));
+  }
+}
+
+AZ_NODISCARD az_json_token const* az_json_document_get_token(
+    az_json_document const* document,
+    int32_t index)
+{
+  _az_PRECONDITION_NOT_NULL(document);
+  _az_PRECONDITION_RANGE(0, index, document->_internal.node_count - 1);
+
+  return &document->_internal.nodes[index].token;
+}
+
+AZ_NODISCARD az_result az_json_document_get_first_child(
+    az_json_document const* document,
+    int32_t index,
+    int32_t* out_child_index)
+{
+  _az_PRECONDITION_NOT_NULL(document);
+  _az_PRECONDITION_RANGE(0, index, document->_internal.node_count - 1);
+  _az_PRECONDITION_NOT_NULL(out_child_index);
+
+  az_json_document_node const* const nodes = document->_internal.nodes;
+  az_json_token_kind const token_kind = nodes[index].token.kind;
+
+  // An empty object or array is immediately followed by its end token.
+  if ((token_kind != AZ_JSON_TOKEN_BEGIN_OBJECT && token_kind != AZ_JSON_TOKEN_BEGIN_ARRAY)
+      || nodes[index]._internal.end_index == index + 1)
+  {
+    return AZ_ERROR_ITEM_NOT_FOUND;
+  }
+
+  *out_child_index = index + 1;
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_json_document_get_next_sibling(
+    az_json_document const* document,
+    int32_t index,
+    int32_t* out_sibling_index)
+{
+  _az_PRECONDITION_NOT_NULL(document);
+  _az_PRECONDITION_RANGE(0, index, document->_internal.node_count - 1);
+  _az_PRECONDITION_NOT_NULL(out_sibling_index);
+
+  az_json_document_node const* const nodes = document->_internal.nodes;
+  int32_t const node_count = document->_internal.node_count;
+
+  // A property name is always followed by its value, which is skipped along with the name.
+  int32_t last_index = index;
+  if (nodes[index].token.kind == AZ_JSON_TOKEN_PROPERTY_NAME)
+  {
+    last_index = index + 1;
+    if (last_index >= node_count)
+    {
+      return AZ_ERROR_ITEM_NOT_FOUND;
+    }
+  }
+
+  int32_t const sibling_index = nodes[last_index]._internal.end_index + 1;
+  if (sibling_index >= node_count || _az_is_json_end_token(nodes[sibling_index].token.kind))
+  {
+    return AZ_ERROR_ITEM_NOT_FOUND;
+  }
+
+  *out_sibling_index = sibling_index;
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_json_document_get_property(
+    az_json_document const* document,
+    int32_t object_index,
+    az_span property_name,
+    int32_t* out_value_index)
+{
+  _az_PRECONDITION_NOT_NULL(document);
+  _az_PRECONDITION_RANGE(0, object_index, document->_internal.node_count - 1);
+  _az_PRECONDITION_NOT_NULL(out_value_index);
+
+  az_json_document_node const* const nodes = document->_internal.nodes;
+  if (nodes[object_index].token.kind != AZ_JSON_TOKEN_BEGIN_OBJECT)
+  {
+    return AZ_ERROR_ITEM_NOT_FOUND;
+  }
+
+  int32_t index = 0;
+  az_result result = az_json_document_get_first_child(document, object_index, &index);
+  while (az_result_succeeded(result))
+  {
+    if (az_json_token_is_text_equal(&nodes[index].token, property_name))
+    {
+      *out_value_index = index + 1;
+      return AZ_OK;
+    }
+    result = az_json_document_get_next_sibling(document, index, &index);
+  }
+
+  return result;
+}
+
+AZ_NODISCARD az_result az_json_document_get_array_element(
+    az_json_document const* document,
+    int32_t array_index,
+    int32_t element,
+    int32_t* out_element_index)
+{
+  _az_PRECONDITION_NOT_NULL(document);
+  _az_PRECONDITION_RANGE(0, array_index, document->_internal.node_count - 1);
+  _az_PRECONDITION(element >= 0);
+  _az_PRECONDITION_NOT_NULL(out_element_index);
+
+  if (document->_internal.nodes[array_index].token.kind != AZ_JSON_TOKEN_BEGIN_ARRAY)
+  {
+    return AZ_ERROR_ITEM_NOT_FOUND;
+  }
+
+  int32_t index = 0;
+  _az_RETURN_IF_FAILED(az_json_document_get_first_child(document, array_index, &index));
+  for (int32_t i = 0; i < element; i++)
+  {
+    _az_RETURN_IF_FAILED(az_json_document_get_next_sibling(document, index, &index));
+  }
+
+  *out_element_index = index;
+  return AZ_OK;
+}
+
+// Parses an array index reference token, which is a decimal number without leading zeros.
+AZ_NODISCARD static az_result _az_json_pointer_parse_array_index(
+    az_span reference_token,
+    int32_t* out_element)
+{
+  int32_t const size = az_span_size(reference_token);
+  uint8_t const* const ptr = az_span_ptr(reference_token);
+
+  // Any reference token that isn't a valid array index, such as "-", can't match an element.
+  if (size == 0 || (size > 1 && ptr[0] == '0'))
+  {
+    return AZ_ERROR_ITEM_NOT_FOUND;
+  }
+
+  int32_t element = 0;
+  for (int32_t i = 0; i < size; i++)
+  {
+    uint8_t const next_byte = ptr[i];
+    if (next_byte < '0' || next_byte > '9' || element > (INT32_MAX - 9) / 10)
+    {
+      return AZ_ERROR_ITEM_NOT_FOUND;
+    }
+    element = element * 10 + (next_byte - '0');
+  }
+
+  *out_element = element;
+  return AZ_OK;
+}
+
+// Replaces the ~1 and ~0 escapes of a reference token with / and ~ respectively.
+AZ_NODISCARD static az_result _az_json_pointer_unescape(
+    az_span reference_token,
+    az_span destination,
+    az_span* out_unescaped)
+{
+  int32_t const size = az_span_size(reference_token);
+  uint8_t const* const ptr = az_span_ptr(reference_token);
+  uint8_t* const destination_ptr = az_span_ptr(destination);
+
+  if (size > az_span_size(destination))
+  {
+    return AZ_ERROR_NOT_SUPPORTED;
+  }
+
+  int32_t length = 0;
+  for (int32_t i = 0; i < size; i++)
+  {
+    uint8_t next_byte = ptr[i];
+    if (next_byte == '~')
+    {
+      i++;
+      if (i >= size || (ptr[i] != '0' && ptr[i] != '1'))
+      {
+        return AZ_ERROR_UNEXPECTED_CHAR;
+      }
+      next_byte = ptr[i] == '0' ? '~' : '/';
+    }
+    destination_ptr[length] = next_byte;
+    length++;
+  }
+
+  *out_unescaped = az_span_slice(destination, 0, length);
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_json_document_get_pointer(
+    az_json_document const* document,
+    az_span json_pointer,
+    int32_t* out_index)
+{
+  _az_PRECONDITION_NOT_NULL(document);
+  _az_PRECONDITION(document->_internal.node_count > 0);
+  _az_PRECONDITION_VALID_SPAN(json_pointer, 0, true);
+  _az_PRECONDITION_NOT_NULL(out_index);
+
+  int32_t index = 0;
+  az_span remaining = json_pointer;
+  while (az_span_size(remaining) > 0)
+  {
+    if (az_span_ptr(remaining)[0] != '/')
+    {
+      return AZ_ERROR_UNEXPECTED_CHAR;
+    }
+    remaining = az_span_slice_to_end(remaining, 1);
+
+    int32_t token_size = az_span_find(remaining, AZ_SPAN_FROM_STR("/"));
+    if (token_size == -1)
+    {
+      token_size = az_span_size(remaining);
+    }
+    az_span reference_token = az_span_slice(remaining, 0, token_size);
+    remaining = az_span_slice_to_end(remaining, token_size);
+
+    az_json_token_kind const token_kind = document->_internal.nodes[index].token.kind;
+    if (token_kind == AZ_JSON_TOKEN_BEGIN_OBJECT)
+    {
+      uint8_t unescaped_buffer[_az_JSON_POINTER_MAX_ESCAPED_TOKEN_SIZE];
+      if (az_span_find(reference_token, AZ_SPAN_FROM_STR("~")) != -1)
+      {
+        _az_RETURN_IF_FAILED(_az_json_pointer_unescape(
+            reference_token, AZ_SPAN_FROM_BUFFER(unescaped_buffer), &reference_token));
+      }
+      _az_RETURN_IF_FAILED(
+          az_json_document_get_property(document, index, reference_token, &index));
+    }
+    else if (token_kind == AZ_JSON_TOKEN_BEGIN_ARRAY)
+    {
+      int32_t element = 0;
+      _az_RETURN_IF_FAILED(_az_json_pointer_parse_array_index(reference_token, &element));
+      _az_RETURN_IF_FAILED(
+          az_json_document_get_array_element(document, index, element, &index));
+    }
+    else
+    {
+      return AZ_ERROR_ITEM_NOT_FOUND;
+    }
+  }
+
+  *out_index = index;
+  return AZ_OK;
+}
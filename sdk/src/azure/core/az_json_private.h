@@ -41,6 +41,10 @@ enum
   // [-][0-9]{16}.[0-9]{15}, i.e. 1+16+1+15 since _az_MAX_SUPPORTED_FRACTIONAL_DIGITS is 15
   _az_MAX_SIZE_FOR_WRITING_DOUBLE = 33,
 
+  // [-]0.00000[0-9]{17}, i.e. 1+2+5+17 which is longer than any of the other forms written by
+  // az_span_dtoa_shortest
+  _az_MAX_SIZE_FOR_WRITING_SHORTEST_DOUBLE = 25,
+
   // When writing large JSON strings in chunks, ask for at least 64 bytes, to avoid writing one
   // character at a time.
   // This value should be between 12 and 512 (inclusive).
@@ -66,11 +70,24 @@ typedef enum
   _az_JSON_STACK_ARRAY = 0,
 } _az_json_stack_item;
 
+/**
+ * @brief Appends a JSON number that is already formatted, such as by #az_span_i64toa(), without
+ * validating it.
+ */
+AZ_NODISCARD az_result
+_az_json_writer_append_number_text(az_json_writer* ref_json_writer, az_span number_text);
+
+// The deepest level of nesting the stack can track: 64, plus 8 for each byte of overflow bits.
+AZ_NODISCARD AZ_INLINE int32_t _az_json_stack_max_depth(_az_json_bit_stack const* json_stack)
+{
+  return _az_MAX_JSON_STACK_SIZE + az_span_size(json_stack->_internal.overflow_bits) * 8;
+}
+
 AZ_INLINE _az_json_stack_item _az_json_stack_pop(_az_json_bit_stack* ref_json_stack)
 {
   _az_PRECONDITION(
       ref_json_stack->_internal.current_depth > 0
-      && ref_json_stack->_internal.current_depth <= _az_MAX_JSON_STACK_SIZE);
+      && ref_json_stack->_internal.current_depth <= _az_json_stack_max_depth(ref_json_stack));
 
   // Don't do the right bit shift if we are at the last bit in the stack.
   if (ref_json_stack->_internal.current_depth != 0)
@@ -80,6 +97,17 @@ AZ_INLINE _az_json_stack_item _az_json_stack_pop(_az_json_bit_stack* ref_json_st
     // We don't want current_depth to become negative, in case preconditions are off, and if
     // append_container_end is called before append_X_start.
     ref_json_stack->_internal.current_depth--;
+
+    // Bring back the level that was moved to the overflow bits when it was pushed out of the word.
+    int32_t const overflow_index
+        = ref_json_stack->_internal.current_depth - _az_MAX_JSON_STACK_SIZE;
+    if (overflow_index >= 0)
+    {
+      uint8_t const overflow_byte
+          = az_span_ptr(ref_json_stack->_internal.overflow_bits)[overflow_index / 8];
+      ref_json_stack->_internal.az_json_stack
+          |= (uint64_t)((overflow_byte >> (overflow_index % 8)) & 1U) << 63U;
+    }
   }
 
   // true (i.e. 1) means _az_JSON_STACK_OBJECT, while false (i.e. 0) means _az_JSON_STACK_ARRAY
@@ -91,7 +119,25 @@ AZ_INLINE void _az_json_stack_push(_az_json_bit_stack* ref_json_stack, _az_json_
 {
   _az_PRECONDITION(
       ref_json_stack->_internal.current_depth >= 0
-      && ref_json_stack->_internal.current_depth < _az_MAX_JSON_STACK_SIZE);
+      && ref_json_stack->_internal.current_depth < _az_json_stack_max_depth(ref_json_stack));
+
+  // The outermost level held by the word is about to be shifted out, so move it to the overflow
+  // bits.
+  int32_t const overflow_index = ref_json_stack->_internal.current_depth - _az_MAX_JSON_STACK_SIZE;
+  if (overflow_index >= 0)
+  {
+    uint8_t* const overflow_byte
+        = az_span_ptr(ref_json_stack->_internal.overflow_bits) + overflow_index / 8;
+    uint8_t const mask = (uint8_t)(1U << (overflow_index % 8));
+    if ((ref_json_stack->_internal.az_json_stack >> 63U) != 0)
+    {
+      *overflow_byte |= mask;
+    }
+    else
+    {
+      *overflow_byte &= (uint8_t)~mask;
+    }
+  }
 
   ref_json_stack->_internal.current_depth++;
   ref_json_stack->_internal.az_json_stack <<= 1U;
@@ -102,13 +148,86 @@ AZ_NODISCARD AZ_INLINE _az_json_stack_item _az_json_stack_peek(_az_json_bit_stac
 {
   _az_PRECONDITION(
       json_stack->_internal.current_depth >= 0
-      && json_stack->_internal.current_depth <= _az_MAX_JSON_STACK_SIZE);
+      && json_stack->_internal.current_depth <= _az_json_stack_max_depth(json_stack));
 
   // true (i.e. 1) means _az_JSON_STACK_OBJECT, while false (i.e. 0) means _az_JSON_STACK_ARRAY
   return (json_stack->_internal.az_json_stack & 1U) != 0 ? _az_JSON_STACK_OBJECT
                                                          : _az_JSON_STACK_ARRAY;
 }
 
+/**
+ * @brief Validates a JSON value, including the UTF-8 encoding of its strings, without reading it
+ * token by token, and returns the kind of its last token.
+ */
+AZ_NODISCARD az_result
+_az_json_validate(az_span json_text, az_json_token_kind* out_last_token_kind);
+
+// Returns the number of continuation bytes that follow the first byte of a well-formed UTF-8
+// sequence (RFC 3629), which is 0x80 or more, and the range the second byte must be in. Returns 0
+// if the byte can't start a sequence.
+AZ_NODISCARD AZ_INLINE int32_t _az_json_utf8_continuation_size(
+    uint8_t first_byte,
+    uint8_t* out_second_byte_min,
+    uint8_t* out_second_byte_max)
+{
+  *out_second_byte_min = 0x80;
+  *out_second_byte_max = 0xBF;
+
+  if (first_byte >= 0xC2 && first_byte <= 0xDF)
+  {
+    return 1;
+  }
+  if (first_byte >= 0xE0 && first_byte <= 0xEF)
+  {
+    // Reject overlong encodings, and UTF-16 surrogates (U+D800 to U+DFFF).
+    *out_second_byte_min = first_byte == 0xE0 ? 0xA0 : 0x80;
+    *out_second_byte_max = first_byte == 0xED ? 0x9F : 0xBF;
+    return 2;
+  }
+  if (first_byte >= 0xF0 && first_byte <= 0xF4)
+  {
+    // Reject overlong encodings, and code points above U+10FFFF.
+    *out_second_byte_min = first_byte == 0xF0 ? 0x90 : 0x80;
+    *out_second_byte_max = first_byte == 0xF4 ? 0x8F : 0xBF;
+    return 3;
+  }
+  return 0;
+}
+
+// Returns the size of the well-formed UTF-8 sequence (RFC 3629) at ptr, which starts with a byte of
+// 0x80 or more: 0 if it isn't well-formed, or -1 if the bytes so far are valid but it is cut off at
+// size.
+AZ_NODISCARD AZ_INLINE int32_t _az_json_utf8_sequence_size(uint8_t const* ptr, int32_t size)
+{
+  uint8_t byte_min = 0;
+  uint8_t byte_max = 0;
+  int32_t const sequence_size
+      = _az_json_utf8_continuation_size(ptr[0], &byte_min, &byte_max) + 1;
+  if (sequence_size == 1)
+  {
+    return 0;
+  }
+
+  for (int32_t i = 1; i < sequence_size; i++)
+  {
+    if (i >= size)
+    {
+      return -1;
+    }
+
+    uint8_t const next_byte = ptr[i];
+    if (next_byte < byte_min || next_byte > byte_max)
+    {
+      return 0;
+    }
+
+    byte_min = 0x80;
+    byte_max = 0xBF;
+  }
+
+  return sequence_size;
+}
+
 #include <azure/core/_az_cfg_suffix.h>
 
 #endif // _az_SPAN_PRIVATE_H
@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: MIT
 
 #include "az_json_private.h"
+#include "az_simd_private.h"
 #include "az_span_private.h"
 #include <azure/core/az_precondition.h>
 #include <azure/core/internal/az_result_internal.h>
@@ -41,7 +42,11 @@ AZ_NODISCARD az_result az_json_reader_init(
       .bytes_consumed = 0,
       .total_bytes_consumed = 0,
       .is_complex_json = false,
-      .bit_stack = { 0 },
+      .bit_stack = {
+        ._internal = {
+          .overflow_bits = options == NULL ? AZ_SPAN_EMPTY : options->nesting_buffer,
+        },
+      },
       .options = options == NULL ? az_json_reader_options_default() : *options,
     },
   };
@@ -80,13 +85,128 @@ AZ_NODISCARD az_result az_json_reader_chunked_init(
       .bytes_consumed = 0,
       .total_bytes_consumed = 0,
       .is_complex_json = false,
-      .bit_stack = { 0 },
+      .bit_stack = {
+        ._internal = {
+          .overflow_bits = options == NULL ? AZ_SPAN_EMPTY : options->nesting_buffer,
+        },
+      },
       .options = options == NULL ? az_json_reader_options_default() : *options,
     },
   };
   return AZ_OK;
 }
 
+AZ_NODISCARD az_result az_json_reader_push_init(
+    az_json_reader* out_json_reader,
+    az_span json_buffers[],
+    int32_t buffers_capacity,
+    az_json_reader_options const* options)
+{
+  _az_PRECONDITION_NOT_NULL(json_buffers);
+  _az_PRECONDITION(buffers_capacity >= 1);
+
+  *out_json_reader = (az_json_reader){
+    .token = (az_json_token){
+      .kind = AZ_JSON_TOKEN_NONE,
+      .slice = AZ_SPAN_EMPTY,
+      .size = 0,
+      ._internal = {
+        .is_multisegment = false,
+        .string_has_escaped_chars = false,
+        .pointer_to_first_buffer = json_buffers,
+        .start_buffer_index = -1,
+        .start_buffer_offset = -1,
+        .end_buffer_index = -1,
+        .end_buffer_offset = -1,
+      },
+    },
+    ._internal = {
+      .json_buffer = AZ_SPAN_EMPTY,
+      .json_buffers = json_buffers,
+      .number_of_buffers = 0,
+      .buffer_index = 0,
+      .bytes_consumed = 0,
+      .total_bytes_consumed = 0,
+      .is_complex_json = false,
+      .bit_stack = {
+        ._internal = {
+          .overflow_bits = options == NULL ? AZ_SPAN_EMPTY : options->nesting_buffer,
+        },
+      },
+      .options = options == NULL ? az_json_reader_options_default() : *options,
+      .buffers_capacity = buffers_capacity,
+      .is_more_data_expected = true,
+    },
+  };
+  return AZ_OK;
+}
+
+// Drops the buffers which end before the current token, since nothing refers to them anymore.
+AZ_NODISCARD static az_result _az_json_reader_drop_consumed_buffers(az_json_reader* ref_json_reader)
+{
+  int32_t first_needed = ref_json_reader->_internal.buffer_index;
+  int32_t const start_buffer_index = ref_json_reader->token._internal.start_buffer_index;
+  if (start_buffer_index != -1 && start_buffer_index < first_needed)
+  {
+    first_needed = start_buffer_index;
+  }
+
+  if (first_needed == 0)
+  {
+    return AZ_ERROR_NOT_ENOUGH_SPACE;
+  }
+
+  az_span* const json_buffers = ref_json_reader->_internal.json_buffers;
+  int32_t const number_of_buffers = ref_json_reader->_internal.number_of_buffers;
+  for (int32_t i = first_needed; i < number_of_buffers; i++)
+  {
+    json_buffers[i - first_needed] = json_buffers[i];
+  }
+
+  ref_json_reader->_internal.number_of_buffers -= first_needed;
+  ref_json_reader->_internal.buffer_index -= first_needed;
+  if (start_buffer_index != -1)
+  {
+    ref_json_reader->token._internal.start_buffer_index -= first_needed;
+  }
+  if (ref_json_reader->token._internal.end_buffer_index != -1)
+  {
+    ref_json_reader->token._internal.end_buffer_index -= first_needed;
+  }
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_json_reader_push_buffer(
+    az_json_reader* ref_json_reader,
+    az_span json_buffer,
+    bool is_final_buffer)
+{
+  _az_PRECONDITION_NOT_NULL(ref_json_reader);
+  _az_PRECONDITION(ref_json_reader->_internal.buffers_capacity > 0);
+  _az_PRECONDITION(ref_json_reader->_internal.is_more_data_expected);
+
+  // Empty segments aren't allowed within the buffers, so there is nothing to add.
+  if (az_span_size(json_buffer) > 0)
+  {
+    if (ref_json_reader->_internal.number_of_buffers
+        == ref_json_reader->_internal.buffers_capacity)
+    {
+      _az_RETURN_IF_FAILED(_az_json_reader_drop_consumed_buffers(ref_json_reader));
+    }
+
+    int32_t const number_of_buffers = ref_json_reader->_internal.number_of_buffers;
+    ref_json_reader->_internal.json_buffers[number_of_buffers] = json_buffer;
+    if (number_of_buffers == 0)
+    {
+      ref_json_reader->_internal.json_buffer = json_buffer;
+    }
+    ref_json_reader->_internal.number_of_buffers++;
+  }
+
+  ref_json_reader->_internal.is_more_data_expected = !is_final_buffer;
+  return AZ_OK;
+}
+
 AZ_NODISCARD static az_span _get_remaining_json(az_json_reader* json_reader)
 {
   _az_PRECONDITION_NOT_NULL(json_reader);
@@ -164,27 +284,35 @@ AZ_NODISCARD static az_result _az_json_reader_get_next_buffer(
 
 AZ_NODISCARD static az_span _az_json_reader_skip_whitespace(az_json_reader* ref_json_reader)
 {
-  az_span json;
   az_span remaining = _get_remaining_json(ref_json_reader);
 
   while (true)
   {
-    json = _az_span_trim_whitespace_from_start(remaining);
+    uint8_t* const ptr = az_span_ptr(remaining);
+    int32_t const size = az_span_size(remaining);
+    int32_t consumed = 0;
 
-    // Find out how many whitespace characters were trimmed.
-    int32_t consumed = _az_span_diff(json, remaining);
+    // Compact JSON rarely has whitespace between tokens, so only start a block scan once the first
+    // byte is known to be whitespace.
+    if (size > 0 && _az_is_whitespace(ptr[0]))
+    {
+      consumed = 1;
+      consumed += _az_simd_json_whitespace_prefix(ptr + consumed, size - consumed);
+      while (consumed < size && _az_is_whitespace(ptr[consumed]))
+      {
+        consumed++;
+      }
+    }
 
     ref_json_reader->_internal.bytes_consumed += consumed;
     ref_json_reader->_internal.total_bytes_consumed += consumed;
 
-    if (az_span_size(json) >= 1
+    if (consumed < size
         || az_result_failed(_az_json_reader_get_next_buffer(ref_json_reader, &remaining, true)))
     {
-      break;
+      return az_span_slice_to_end(remaining, consumed);
     }
   }
-
-  return json;
 }
 
 AZ_NODISCARD static az_result _az_json_reader_process_container_end(
@@ -211,9 +339,10 @@ AZ_NODISCARD static az_result _az_json_reader_process_container_start(
     az_json_token_kind token_kind,
     _az_json_stack_item container_kind)
 {
-  // The current depth is equal to or larger than the maximum allowed depth of 64. Cannot read the
-  // next JSON object or array.
-  if (ref_json_reader->_internal.bit_stack._internal.current_depth >= _az_MAX_JSON_STACK_SIZE)
+  // The current depth is equal to or larger than the maximum allowed depth of 64, plus the levels
+  // allowed by the nesting buffer. Cannot read the next JSON object or array.
+  if (ref_json_reader->_internal.bit_stack._internal.current_depth
+      >= _az_json_stack_max_depth(&ref_json_reader->_internal.bit_stack))
   {
     return AZ_ERROR_JSON_NESTING_OVERFLOW;
   }
@@ -265,14 +394,30 @@ AZ_NODISCARD static az_result _az_json_reader_process_string(az_json_reader* ref
   // Clear the state of any previous string token.
   ref_json_reader->token._internal.string_has_escaped_chars = false;
 
+  // While validating UTF-8, the number of continuation bytes still expected within the current
+  // multibyte sequence, and the range the next one must be in. The sequence can span buffers.
+  bool const validate_utf8 = ref_json_reader->_internal.options.validate_utf8;
+  int32_t utf8_bytes_expected = 0;
+  uint8_t utf8_byte_min = 0x80;
+  uint8_t utf8_byte_max = 0xBF;
+
   while (true)
   {
-    if (next_byte == '"')
+    if (utf8_bytes_expected > 0)
+    {
+      if (next_byte < utf8_byte_min || next_byte > utf8_byte_max)
+      {
+        return AZ_ERROR_UNEXPECTED_CHAR;
+      }
+      utf8_bytes_expected--;
+      utf8_byte_min = 0x80;
+      utf8_byte_max = 0xBF;
+    }
+    else if (next_byte == '"')
     {
       break;
     }
-
-    if (next_byte == '\\')
+    else if (next_byte == '\\')
     {
       ref_json_reader->token._internal.string_has_escaped_chars = true;
       current_index++;
@@ -324,10 +469,16 @@ AZ_NODISCARD static az_result _az_json_reader_process_string(az_json_reader* ref
         }
       }
     }
-    else
+    else if (next_byte < _az_ASCII_SPACE_CHARACTER)
     {
       // Control characters are invalid within a JSON string and should be correctly escaped.
-      if (next_byte < _az_ASCII_SPACE_CHARACTER)
+      return AZ_ERROR_UNEXPECTED_CHAR;
+    }
+    else if (validate_utf8 && next_byte >= 0x80)
+    {
+      utf8_bytes_expected
+          = _az_json_utf8_continuation_size(next_byte, &utf8_byte_min, &utf8_byte_max);
+      if (utf8_bytes_expected == 0)
       {
         return AZ_ERROR_UNEXPECTED_CHAR;
       }
@@ -336,6 +487,24 @@ AZ_NODISCARD static az_result _az_json_reader_process_string(az_json_reader* ref
     current_index++;
     string_length++;
 
+    // Skip over the run of bytes that don't need any special handling, a block at a time. While
+    // validating UTF-8, that's only ASCII bytes, and the bytes of a multibyte sequence are checked
+    // one at a time.
+    if (!validate_utf8)
+    {
+      int32_t const clean_bytes = _az_simd_json_string_clean_prefix(
+          token_ptr + current_index, remaining_size - current_index);
+      current_index += clean_bytes;
+      string_length += clean_bytes;
+    }
+    else if (utf8_bytes_expected == 0)
+    {
+      int32_t const clean_bytes = _az_simd_json_string_ascii_clean_prefix(
+          token_ptr + current_index, remaining_size - current_index);
+      current_index += clean_bytes;
+      string_length += clean_bytes;
+    }
+
     if (current_index >= remaining_size)
     {
       _az_RETURN_IF_FAILED(_az_json_reader_get_next_buffer(ref_json_reader, &token, false));
@@ -387,21 +556,29 @@ AZ_NODISCARD static az_result _az_json_reader_process_property_name(az_json_read
   return AZ_OK;
 }
 
-// Used to search for possible valid end of a number character, when we have complex JSON payloads
+// Used to check for a possible valid end of a number character, when we have complex JSON payloads
 // (i.e. not a single JSON value).
 // Whitespace characters, comma, or a container end character indicate the end of a JSON number.
-static const az_span json_delimiters = AZ_SPAN_LITERAL_FROM_STR(",}] \n\r\t");
+AZ_NODISCARD AZ_INLINE bool _az_is_json_number_delimiter(uint8_t byte)
+{
+  switch (byte)
+  {
+    case ',':
+    case '}':
+    case ']':
+      return true;
+    default:
+      return _az_is_whitespace(byte);
+  }
+}
 
 AZ_NODISCARD static bool _az_finished_consuming_json_number(
     uint8_t next_byte,
     az_span expected_next_bytes,
     az_result* out_result)
 {
-  az_span next_byte_span = az_span_create(&next_byte, 1);
-
   // Checking if we are done processing a JSON number
-  int32_t index = az_span_find(json_delimiters, next_byte_span);
-  if (index != -1)
+  if (_az_is_json_number_delimiter(next_byte))
   {
     *out_result = AZ_OK;
     return true;
@@ -411,8 +588,7 @@ AZ_NODISCARD static bool _az_finished_consuming_json_number(
   // indicate scientific notation. For example "01" or "123f" is invalid.
   // The next character after "[-][digits].[digits]" must be 'e'/'E' if we haven't reached the end
   // of the number yet. For example, "1.1f" or "1.1-" are invalid.
-  index = az_span_find(expected_next_bytes, next_byte_span);
-  if (index == -1)
+  if (az_span_find(expected_next_bytes, az_span_create(&next_byte, 1)) == -1)
   {
     *out_result = AZ_ERROR_UNEXPECTED_CHAR;
     return true;
@@ -468,7 +644,9 @@ AZ_NODISCARD static az_result _az_json_reader_update_number_state_if_single_valu
     int32_t current_consumed,
     int32_t total_consumed)
 {
-  if (ref_json_reader->_internal.is_complex_json)
+  // More digits might still be pushed, so the number isn't complete yet.
+  if (ref_json_reader->_internal.is_complex_json
+      || ref_json_reader->_internal.is_more_data_expected)
   {
     return AZ_ERROR_UNEXPECTED_END;
   }
@@ -658,12 +836,12 @@ AZ_NODISCARD static az_result _az_json_reader_process_number(az_json_reader* ref
   {
     total_consumed++;
     current_consumed++;
-
-    // A sign must be followed by at least one digit.
-    _az_RETURN_IF_FAILED(
-        _az_validate_next_byte_is_digit(ref_json_reader, &token, &current_consumed));
   }
 
+  // The exponent must have at least one digit, after the optional sign. For example "1e" or "1e+"
+  // followed by a delimiter are invalid.
+  _az_RETURN_IF_FAILED(_az_validate_next_byte_is_digit(ref_json_reader, &token, &current_consumed));
+
   // Integer part after the 'e'/'E'
   _az_json_reader_consume_digits(ref_json_reader, &token, &current_consumed, &total_consumed);
 
@@ -686,8 +864,7 @@ AZ_NODISCARD static az_result _az_json_reader_process_number(az_json_reader* ref
 
   // Checking if we are done processing a JSON number
   next_byte = az_span_ptr(token)[current_consumed];
-  int32_t index = az_span_find(json_delimiters, az_span_create(&next_byte, 1));
-  if (index == -1)
+  if (!_az_is_json_number_delimiter(next_byte))
   {
     return AZ_ERROR_UNEXPECTED_CHAR;
   }
@@ -877,10 +1054,8 @@ AZ_NODISCARD static az_result _az_json_reader_process_next_byte(
   return AZ_ERROR_UNEXPECTED_CHAR;
 }
 
-AZ_NODISCARD az_result az_json_reader_next_token(az_json_reader* ref_json_reader)
+AZ_NODISCARD static az_result _az_json_reader_read_next_token(az_json_reader* ref_json_reader)
 {
-  _az_PRECONDITION_NOT_NULL(ref_json_reader);
-
   az_span json = _az_json_reader_skip_whitespace(ref_json_reader);
 
   if (az_span_size(json) < 1)
@@ -949,10 +1124,29 @@ AZ_NODISCARD az_result az_json_reader_next_token(az_json_reader* ref_json_reader
   }
 }
 
-AZ_NODISCARD az_result az_json_reader_skip_children(az_json_reader* ref_json_reader)
+AZ_NODISCARD az_result az_json_reader_next_token(az_json_reader* ref_json_reader)
 {
   _az_PRECONDITION_NOT_NULL(ref_json_reader);
 
+  if (!ref_json_reader->_internal.is_more_data_expected)
+  {
+    return _az_json_reader_read_next_token(ref_json_reader);
+  }
+
+  // Running out of data isn't an error while more buffers can be pushed. Restore the state from
+  // before the token, so that it is read again from its start once there is more data.
+  az_json_reader const saved_json_reader = *ref_json_reader;
+  az_result const result = _az_json_reader_read_next_token(ref_json_reader);
+  if (result == AZ_ERROR_UNEXPECTED_END || result == AZ_ERROR_JSON_READER_DONE)
+  {
+    *ref_json_reader = saved_json_reader;
+    return AZ_ERROR_JSON_NEED_MORE_DATA;
+  }
+  return result;
+}
+
+AZ_NODISCARD static az_result _az_json_reader_skip_children(az_json_reader* ref_json_reader)
+{
   if (ref_json_reader->token.kind == AZ_JSON_TOKEN_PROPERTY_NAME)
   {
     _az_RETURN_IF_FAILED(az_json_reader_next_token(ref_json_reader));
@@ -970,3 +1164,23 @@ AZ_NODISCARD az_result az_json_reader_skip_children(az_json_reader* ref_json_rea
   }
   return AZ_OK;
 }
+
+AZ_NODISCARD az_result az_json_reader_skip_children(az_json_reader* ref_json_reader)
+{
+  _az_PRECONDITION_NOT_NULL(ref_json_reader);
+
+  if (!ref_json_reader->_internal.is_more_data_expected)
+  {
+    return _az_json_reader_skip_children(ref_json_reader);
+  }
+
+  // Skipping the children reads several tokens, so start over from the current token when some of
+  // them haven't been pushed yet.
+  az_json_reader const saved_json_reader = *ref_json_reader;
+  az_result const result = _az_json_reader_skip_children(ref_json_reader);
+  if (result == AZ_ERROR_JSON_NEED_MORE_DATA)
+  {
+    *ref_json_reader = saved_json_reader;
+  }
+  return result;
+}
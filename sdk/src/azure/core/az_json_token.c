@@ -6,6 +6,7 @@
 #include <azure/core/internal/az_span_internal.h>
 
 #include "az_json_private.h"
+#include "az_simd_private.h"
 
 #include "az_span_private.h"
 #include <azure/core/_az_cfg.h>
@@ -243,6 +244,183 @@ AZ_NODISCARD bool az_json_token_is_text_equal(
   return az_span_size(expected_text) == 0;
 }
 
+// FNV-1a, which is cheap to update one byte at a time, including across buffer segments.
+#define _az_FNV_OFFSET_BASIS 2166136261U
+#define _az_FNV_PRIME 16777619U
+
+AZ_NODISCARD AZ_INLINE uint32_t _az_json_property_name_hash_byte(uint32_t hash, uint8_t next_byte)
+{
+  return (hash ^ next_byte) * _az_FNV_PRIME;
+}
+
+AZ_NODISCARD static uint32_t _az_json_property_name_hash(az_span name)
+{
+  uint32_t hash = _az_FNV_OFFSET_BASIS;
+  int32_t const size = az_span_size(name);
+  uint8_t const* const ptr = az_span_ptr(name);
+  for (int32_t i = 0; i < size; i++)
+  {
+    hash = _az_json_property_name_hash_byte(hash, ptr[i]);
+  }
+  return hash;
+}
+
+// Hashes the unescaped bytes of a segment of the token. Returns false for characters escaped in
+// the form of \uXXXX, which can't match any name, similar to az_json_token_is_text_equal.
+AZ_NODISCARD static bool _az_json_property_name_hash_escaped(
+    az_span token_slice,
+    uint32_t* ref_hash,
+    bool* next_char_escaped)
+{
+  int32_t const size = az_span_size(token_slice);
+  uint8_t const* const ptr = az_span_ptr(token_slice);
+  uint32_t hash = *ref_hash;
+  for (int32_t i = 0; i < size; i++)
+  {
+    uint8_t token_byte = ptr[i];
+    if (*next_char_escaped)
+    {
+      if (token_byte == 'u')
+      {
+        return false;
+      }
+      token_byte = _az_json_unescape_single_byte(token_byte);
+      *next_char_escaped = false;
+    }
+    else if (token_byte == '\\')
+    {
+      *next_char_escaped = true;
+      continue;
+    }
+    hash = _az_json_property_name_hash_byte(hash, token_byte);
+  }
+  *ref_hash = hash;
+  return true;
+}
+
+AZ_NODISCARD static bool _az_json_token_property_name_hash(
+    az_json_token const* json_token,
+    uint32_t* out_hash)
+{
+  // Contiguous token, with nothing to unescape
+  if (!json_token->_internal.is_multisegment && !json_token->_internal.string_has_escaped_chars)
+  {
+    *out_hash = _az_json_property_name_hash(json_token->slice);
+    return true;
+  }
+
+  uint32_t hash = _az_FNV_OFFSET_BASIS;
+  bool next_char_escaped = false;
+
+  if (!json_token->_internal.is_multisegment)
+  {
+    if (!_az_json_property_name_hash_escaped(json_token->slice, &hash, &next_char_escaped))
+    {
+      return false;
+    }
+    *out_hash = hash;
+    return true;
+  }
+
+  // Token straddles more than one segment
+  for (int32_t i = json_token->_internal.start_buffer_index;
+       i <= json_token->_internal.end_buffer_index;
+       i++)
+  {
+    az_span source = json_token->_internal.pointer_to_first_buffer[i];
+    if (i == json_token->_internal.start_buffer_index)
+    {
+      source = az_span_slice_to_end(source, json_token->_internal.start_buffer_offset);
+    }
+    else if (i == json_token->_internal.end_buffer_index)
+    {
+      source = az_span_slice(source, 0, json_token->_internal.end_buffer_offset);
+    }
+
+    if (!_az_json_property_name_hash_escaped(source, &hash, &next_char_escaped))
+    {
+      return false;
+    }
+  }
+  *out_hash = hash;
+  return true;
+}
+
+AZ_NODISCARD az_result az_json_property_name_table_init(
+    az_json_property_name_table* out_table,
+    az_span const* names,
+    int32_t names_length,
+    uint8_t* slots,
+    int32_t slots_length)
+{
+  _az_PRECONDITION_NOT_NULL(out_table);
+  _az_PRECONDITION_NOT_NULL(names);
+  _az_PRECONDITION_RANGE(0, names_length, UINT8_MAX);
+  _az_PRECONDITION_NOT_NULL(slots);
+  _az_PRECONDITION(slots_length > 0 && (slots_length & (slots_length - 1)) == 0);
+
+  // At least one slot must stay empty, so that every lookup ends.
+  if (slots_length <= names_length)
+  {
+    return AZ_ERROR_NOT_ENOUGH_SPACE;
+  }
+
+  out_table->_internal.names = names;
+  out_table->_internal.slots = slots;
+  out_table->_internal.slots_length = slots_length;
+
+  uint32_t const mask = (uint32_t)slots_length - 1;
+  for (int32_t i = 0; i < slots_length; i++)
+  {
+    slots[i] = 0;
+  }
+
+  // Open addressing with linear probing. Names are inserted in order, so that the first of any
+  // repeated names is found first.
+  for (int32_t i = 0; i < names_length; i++)
+  {
+    uint32_t slot = _az_json_property_name_hash(names[i]) & mask;
+    while (slots[slot] != 0)
+    {
+      slot = (slot + 1) & mask;
+    }
+    slots[slot] = (uint8_t)(i + 1);
+  }
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_json_property_name_table_find(
+    az_json_property_name_table const* table,
+    az_json_token const* json_token,
+    int32_t* out_index)
+{
+  _az_PRECONDITION_NOT_NULL(table);
+  _az_PRECONDITION_NOT_NULL(json_token);
+  _az_PRECONDITION_NOT_NULL(out_index);
+
+  uint32_t hash = 0;
+  if ((json_token->kind != AZ_JSON_TOKEN_STRING && json_token->kind != AZ_JSON_TOKEN_PROPERTY_NAME)
+      || !_az_json_token_property_name_hash(json_token, &hash))
+  {
+    return AZ_ERROR_ITEM_NOT_FOUND;
+  }
+
+  uint8_t const* const slots = table->_internal.slots;
+  uint32_t const mask = (uint32_t)table->_internal.slots_length - 1;
+  for (uint32_t slot = hash & mask; slots[slot] != 0; slot = (slot + 1) & mask)
+  {
+    int32_t const index = slots[slot] - 1;
+    if (az_json_token_is_text_equal(json_token, table->_internal.names[index]))
+    {
+      *out_index = index;
+      return AZ_OK;
+    }
+  }
+
+  return AZ_ERROR_ITEM_NOT_FOUND;
+}
+
 AZ_NODISCARD az_result az_json_token_get_boolean(az_json_token const* json_token, bool* out_value)
 {
   _az_PRECONDITION_NOT_NULL(json_token);
@@ -274,57 +452,194 @@ AZ_NODISCARD az_result az_json_token_get_boolean(az_json_token const* json_token
   return AZ_OK;
 }
 
-AZ_NODISCARD static az_result _az_json_token_get_string_helper(
-    az_span source,
-    char* destination,
-    int32_t destination_max_size,
-    int32_t* dest_idx,
-    bool* next_char_escaped)
+enum
+{
+  // The size of a character escaped in the form of \uXXXX.
+  _az_JSON_UNICODE_ESCAPE_SIZE = 6,
+  _az_UTF16_HIGH_SURROGATE_START = 0xD800,
+  _az_UTF16_LOW_SURROGATE_START = 0xDC00,
+  _az_UTF16_SURROGATE_END = 0xDFFF,
+  _az_UTF16_SUPPLEMENTARY_PLANES_START = 0x10000,
+};
+
+// Gets the UTF-16 code unit of a character escaped in the form of \uXXXX, which the reader already
+// validated to be followed by 4 hexadecimal digits.
+AZ_NODISCARD static uint32_t _az_json_unescape_code_unit(uint8_t const* escape)
 {
-  int32_t source_size = az_span_size(source);
-  uint8_t* source_ptr = az_span_ptr(source);
-  for (int32_t i = 0; i < source_size; i++)
+  uint32_t code_unit = 0;
+  for (int32_t i = 2; i < _az_JSON_UNICODE_ESCAPE_SIZE; i++)
+  {
+    uint8_t const hex_digit = escape[i];
+    // Upper case and lower case letters are 0x20 away from each other.
+    uint32_t const value = hex_digit <= '9'
+        ? (uint32_t)(hex_digit - '0')
+        : (uint32_t)((hex_digit | _az_ASCII_SPACE_CHARACTER) - 'a' + 10);
+    code_unit = code_unit * _az_NUMBER_OF_HEX_VALUES + value;
+  }
+  return code_unit;
+}
+
+// Writes the code point as UTF-8, and returns the number of bytes written, from 1 to 4.
+AZ_NODISCARD static int32_t _az_json_write_utf8(uint8_t* destination, uint32_t code_point)
+{
+  if (code_point < 0x80)
+  {
+    destination[0] = (uint8_t)code_point;
+    return 1;
+  }
+  if (code_point < 0x800)
+  {
+    destination[0] = (uint8_t)(0xC0 | (code_point >> 6));
+    destination[1] = (uint8_t)(0x80 | (code_point & 0x3F));
+    return 2;
+  }
+  if (code_point < _az_UTF16_SUPPLEMENTARY_PLANES_START)
   {
-    if (*dest_idx >= destination_max_size)
+    destination[0] = (uint8_t)(0xE0 | (code_point >> 12));
+    destination[1] = (uint8_t)(0x80 | ((code_point >> 6) & 0x3F));
+    destination[2] = (uint8_t)(0x80 | (code_point & 0x3F));
+    return 3;
+  }
+  destination[0] = (uint8_t)(0xF0 | (code_point >> 18));
+  destination[1] = (uint8_t)(0x80 | ((code_point >> 12) & 0x3F));
+  destination[2] = (uint8_t)(0x80 | ((code_point >> 6) & 0x3F));
+  destination[3] = (uint8_t)(0x80 | (code_point & 0x3F));
+  return 4;
+}
+
+// Decodes the \uXXXX escaped character at the start of escape, along with the escaped low surrogate
+// that follows a high surrogate, and sets the number of escaped bytes it took.
+AZ_NODISCARD static az_result _az_json_unescape_unicode(
+    uint8_t const* escape,
+    int32_t escape_size,
+    uint32_t* out_code_point,
+    int32_t* out_escape_size)
+{
+  uint32_t code_point = _az_json_unescape_code_unit(escape);
+
+  if (code_point >= _az_UTF16_HIGH_SURROGATE_START && code_point <= _az_UTF16_SURROGATE_END)
+  {
+    // A high surrogate must be immediately followed by an escaped low surrogate.
+    uint8_t const* const low_escape = escape + _az_JSON_UNICODE_ESCAPE_SIZE;
+    if (code_point >= _az_UTF16_LOW_SURROGATE_START
+        || escape_size < 2 * _az_JSON_UNICODE_ESCAPE_SIZE || low_escape[0] != '\\'
+        || low_escape[1] != 'u')
     {
-      return AZ_ERROR_NOT_ENOUGH_SPACE;
+      return AZ_ERROR_UNEXPECTED_CHAR;
     }
-    uint8_t token_byte = source_ptr[i];
 
-    if (token_byte == '\\' || *next_char_escaped)
+    uint32_t const low_surrogate = _az_json_unescape_code_unit(low_escape);
+    if (low_surrogate < _az_UTF16_LOW_SURROGATE_START || low_surrogate > _az_UTF16_SURROGATE_END)
     {
-      if (*next_char_escaped)
-      {
-        token_byte = _az_json_unescape_single_byte(token_byte);
-      }
-      else
-      {
-        i++;
-        if (i >= source_size)
-        {
-          *next_char_escaped = true;
-          break;
-        }
-        token_byte = _az_json_unescape_single_byte(source_ptr[i]);
-      }
-      *next_char_escaped = false;
-
-      // TODO: Characters escaped in the form of \uXXXX where XXXX is the UTF-16 code point, is
-      // not currently supported.
-      // To do this, we need to encode UTF-16 codepoints (including surrogate pairs) into UTF-8.
-      if (token_byte == 'u')
-      {
-        return AZ_ERROR_NOT_IMPLEMENTED;
-      }
+      return AZ_ERROR_UNEXPECTED_CHAR;
     }
 
-    destination[*dest_idx] = (char)token_byte;
-    *dest_idx = *dest_idx + 1;
+    *out_code_point = _az_UTF16_SUPPLEMENTARY_PLANES_START
+        + ((code_point - _az_UTF16_HIGH_SURROGATE_START) << 10)
+        + (low_surrogate - _az_UTF16_LOW_SURROGATE_START);
+    *out_escape_size = 2 * _az_JSON_UNICODE_ESCAPE_SIZE;
+    return AZ_OK;
   }
 
+  *out_code_point = code_point;
+  *out_escape_size = _az_JSON_UNICODE_ESCAPE_SIZE;
   return AZ_OK;
 }
 
+// Reads the bytes of a token one at a time, across the segments it straddles.
+typedef struct
+{
+  az_json_token const* token;
+  uint8_t const* ptr; // The bytes of the current segment that weren't read yet.
+  int32_t size;
+  int32_t buffer_index; // The index of the current segment.
+  int32_t end_buffer_index;
+} _az_json_token_byte_cursor;
+
+static void _az_json_token_byte_cursor_init(
+    _az_json_token_byte_cursor* out_cursor,
+    az_json_token const* json_token)
+{
+  az_span first_segment = json_token->slice;
+  int32_t buffer_index = 0;
+  int32_t end_buffer_index = 0;
+
+  if (json_token->_internal.is_multisegment)
+  {
+    buffer_index = json_token->_internal.start_buffer_index;
+    end_buffer_index = json_token->_internal.end_buffer_index;
+    first_segment = az_span_slice_to_end(
+        json_token->_internal.pointer_to_first_buffer[buffer_index],
+        json_token->_internal.start_buffer_offset);
+  }
+
+  *out_cursor = (_az_json_token_byte_cursor){
+    .token = json_token,
+    .ptr = az_span_ptr(first_segment),
+    .size = az_span_size(first_segment),
+    .buffer_index = buffer_index,
+    .end_buffer_index = end_buffer_index,
+  };
+}
+
+// Returns false once every byte of the token was read.
+AZ_NODISCARD static bool
+_az_json_token_byte_cursor_next(_az_json_token_byte_cursor* ref_cursor, uint8_t* out_byte)
+{
+  while (ref_cursor->size == 0)
+  {
+    if (ref_cursor->buffer_index >= ref_cursor->end_buffer_index)
+    {
+      return false;
+    }
+
+    ref_cursor->buffer_index++;
+    az_span segment
+        = ref_cursor->token->_internal.pointer_to_first_buffer[ref_cursor->buffer_index];
+    if (ref_cursor->buffer_index == ref_cursor->end_buffer_index)
+    {
+      segment = az_span_slice(segment, 0, ref_cursor->token->_internal.end_buffer_offset);
+    }
+    ref_cursor->ptr = az_span_ptr(segment);
+    ref_cursor->size = az_span_size(segment);
+  }
+
+  *out_byte = *ref_cursor->ptr;
+  ref_cursor->ptr++;
+  ref_cursor->size--;
+  return true;
+}
+
+// Reads the \uXXXX escaped character whose backslash and 'u' were just read, along with the
+// escaped low surrogate that may follow it, and decodes it.
+AZ_NODISCARD static az_result _az_json_token_byte_cursor_read_unicode(
+    _az_json_token_byte_cursor* ref_cursor,
+    uint32_t* out_code_point)
+{
+  uint8_t escape[2 * _az_JSON_UNICODE_ESCAPE_SIZE] = { '\\', 'u' };
+  int32_t escape_size = 2;
+
+  // The reader already validated that the 4 hexadecimal digits are there.
+  while (escape_size < _az_JSON_UNICODE_ESCAPE_SIZE
+         && _az_json_token_byte_cursor_next(ref_cursor, &escape[escape_size]))
+  {
+    escape_size++;
+  }
+
+  uint32_t const code_unit = _az_json_unescape_code_unit(escape);
+  if (code_unit >= _az_UTF16_HIGH_SURROGATE_START && code_unit < _az_UTF16_LOW_SURROGATE_START)
+  {
+    while (escape_size < 2 * _az_JSON_UNICODE_ESCAPE_SIZE
+           && _az_json_token_byte_cursor_next(ref_cursor, &escape[escape_size]))
+    {
+      escape_size++;
+    }
+  }
+
+  int32_t ignore = 0;
+  return _az_json_unescape_unicode(escape, escape_size, out_code_point, &ignore);
+}
+
 AZ_NODISCARD az_result az_json_token_get_string(
     az_json_token const* json_token,
     char* destination,
@@ -384,34 +699,44 @@ AZ_NODISCARD az_result az_json_token_get_string(
   }
 
   int32_t dest_idx = 0;
-  bool next_char_escaped = false;
+  _az_json_token_byte_cursor cursor = { 0 };
+  _az_json_token_byte_cursor_init(&cursor, json_token);
 
-  // Contiguous token
-  if (!json_token->_internal.is_multisegment)
+  uint8_t token_byte = 0;
+  while (_az_json_token_byte_cursor_next(&cursor, &token_byte))
   {
-    _az_RETURN_IF_FAILED(_az_json_token_get_string_helper(
-        token_slice, destination, destination_max_size, &dest_idx, &next_char_escaped));
-  }
-  else
-  {
-    // Token straddles more than one segment
-    for (int32_t i = json_token->_internal.start_buffer_index;
-         i <= json_token->_internal.end_buffer_index;
-         i++)
+    // The reader already validated that every backslash is followed by an escaped character.
+    if (token_byte == '\\' && _az_json_token_byte_cursor_next(&cursor, &token_byte))
     {
-      az_span source = json_token->_internal.pointer_to_first_buffer[i];
-      if (i == json_token->_internal.start_buffer_index)
-      {
-        source = az_span_slice_to_end(source, json_token->_internal.start_buffer_offset);
-      }
-      else if (i == json_token->_internal.end_buffer_index)
+      if (token_byte == 'u')
       {
-        source = az_span_slice(source, 0, json_token->_internal.end_buffer_offset);
+        uint32_t code_point = 0;
+        _az_RETURN_IF_FAILED(_az_json_token_byte_cursor_read_unicode(&cursor, &code_point));
+
+        uint8_t utf8[4] = { 0 };
+        int32_t const utf8_size = _az_json_write_utf8(utf8, code_point);
+        if (destination_max_size - dest_idx < utf8_size)
+        {
+          return AZ_ERROR_NOT_ENOUGH_SPACE;
+        }
+
+        for (int32_t i = 0; i < utf8_size; i++)
+        {
+          destination[dest_idx + i] = (char)utf8[i];
+        }
+        dest_idx += utf8_size;
+        continue;
       }
 
-      _az_RETURN_IF_FAILED(_az_json_token_get_string_helper(
-          source, destination, destination_max_size, &dest_idx, &next_char_escaped));
+      token_byte = _az_json_unescape_single_byte(token_byte);
     }
+
+    if (dest_idx >= destination_max_size)
+    {
+      return AZ_ERROR_NOT_ENOUGH_SPACE;
+    }
+    destination[dest_idx] = (char)token_byte;
+    dest_idx++;
   }
 
   if (dest_idx >= destination_max_size)
@@ -428,6 +753,107 @@ AZ_NODISCARD az_result az_json_token_get_string(
   return AZ_OK;
 }
 
+// Unescapes the \uXXXX escaped character at read_index, along with the escaped low surrogate that
+// follows a high surrogate, into UTF-8 at write_index. The UTF-8 bytes are always fewer than the
+// escaped ones: at most 3 for one escape, and 4 for a surrogate pair.
+AZ_NODISCARD static az_result _az_json_unescape_unicode_in_place(
+    uint8_t* token_ptr,
+    int32_t token_size,
+    int32_t* ref_read_index,
+    int32_t* ref_write_index)
+{
+  uint32_t code_point = 0;
+  int32_t escape_size = 0;
+  _az_RETURN_IF_FAILED(_az_json_unescape_unicode(
+      token_ptr + *ref_read_index, token_size - *ref_read_index, &code_point, &escape_size));
+
+  *ref_write_index += _az_json_write_utf8(token_ptr + *ref_write_index, code_point);
+  *ref_read_index += escape_size;
+  return AZ_OK;
+}
+
+// Returns the number of leading bytes of the token slice which aren't a backslash.
+AZ_NODISCARD static int32_t _az_json_token_unescaped_run(uint8_t const* ptr, int32_t size)
+{
+  // Skip over the bytes that don't need unescaping a block at a time, and then byte by byte.
+  int32_t index = _az_simd_find_byte(ptr, size, '\\');
+  while (index < size && ptr[index] != '\\')
+  {
+    index++;
+  }
+  return index;
+}
+
+AZ_NODISCARD az_result
+az_json_token_unescape_in_place(az_json_token const* json_token, az_span* out_string)
+{
+  _az_PRECONDITION_NOT_NULL(json_token);
+  _az_PRECONDITION_NOT_NULL(out_string);
+
+  if (json_token->kind != AZ_JSON_TOKEN_STRING && json_token->kind != AZ_JSON_TOKEN_PROPERTY_NAME)
+  {
+    return AZ_ERROR_JSON_INVALID_STATE;
+  }
+
+  // The bytes of a token that straddles segments can't be turned into a single span.
+  if (json_token->_internal.is_multisegment)
+  {
+    return AZ_ERROR_NOT_SUPPORTED;
+  }
+
+  az_span const token_slice = json_token->slice;
+
+  // There is nothing to unescape here, use the token slice directly.
+  if (!json_token->_internal.string_has_escaped_chars)
+  {
+    *out_string = token_slice;
+    return AZ_OK;
+  }
+
+  uint8_t* const token_ptr = az_span_ptr(token_slice);
+  int32_t const token_size = az_span_size(token_slice);
+
+  // Unescaping only ever shrinks the string, so the unescaped bytes are written behind the ones
+  // still to be read.
+  int32_t read_index = 0;
+  int32_t write_index = 0;
+  while (true)
+  {
+    int32_t const run_size
+        = _az_json_token_unescaped_run(token_ptr + read_index, token_size - read_index);
+    if (read_index != write_index)
+    {
+      az_span_copy(
+          az_span_slice(token_slice, write_index, write_index + run_size),
+          az_span_slice(token_slice, read_index, read_index + run_size));
+    }
+    read_index += run_size;
+    write_index += run_size;
+
+    if (read_index >= token_size)
+    {
+      break;
+    }
+
+    // The reader already validated that every backslash is followed by an escaped character.
+    uint8_t const token_byte = token_ptr[read_index + 1];
+
+    if (token_byte == 'u')
+    {
+      _az_RETURN_IF_FAILED(
+          _az_json_unescape_unicode_in_place(token_ptr, token_size, &read_index, &write_index));
+      continue;
+    }
+
+    token_ptr[write_index] = _az_json_unescape_single_byte(token_byte);
+    write_index++;
+    read_index += 2;
+  }
+
+  *out_string = az_span_slice(token_slice, 0, write_index);
+  return AZ_OK;
+}
+
 AZ_NODISCARD az_result
 az_json_token_get_uint64(az_json_token const* json_token, uint64_t* out_value)
 {
@@ -0,0 +1,422 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <azure/core/az_json.h>
+#include <azure/core/internal/az_precondition_internal.h>
+#include <azure/core/internal/az_result_internal.h>
+
+#include "az_json_private.h"
+#include "az_simd_private.h"
+#include "az_span_private.h"
+
+#include <ctype.h>
+
+#include <azure/core/_az_cfg.h>
+
+// Instead of producing tokens like az_json_reader does, the validator walks the JSON text with a
+// single index, and only tracks whether each open container is an object or an array. It accepts
+// exactly the JSON that az_json_reader accepts, with the same results for invalid JSON, except that
+// the strings must also be well-formed UTF-8.
+
+AZ_NODISCARD static int32_t
+_az_json_validator_skip_whitespace(uint8_t const* json_ptr, int32_t json_size, int32_t index)
+{
+  // Most tokens aren't preceded by any white space, which doesn't need scanning a whole block.
+  if (index < json_size && !_az_is_whitespace(json_ptr[index]))
+  {
+    return index;
+  }
+
+  index += _az_simd_json_whitespace_prefix(json_ptr + index, json_size - index);
+  while (index < json_size && _az_is_whitespace(json_ptr[index]))
+  {
+    index++;
+  }
+  return index;
+}
+
+enum
+{
+  // The number of string bytes checked one at a time before scanning a block at a time.
+  _az_JSON_VALIDATOR_SHORT_RUN = 16,
+};
+
+AZ_NODISCARD AZ_INLINE bool _az_json_is_clean_ascii(uint8_t byte)
+{
+  return byte >= _az_ASCII_SPACE_CHARACTER && byte < 0x80 && byte != '"' && byte != '\\';
+}
+
+// Validates the string which starts with the quote at *ref_index, and moves past its closing quote.
+AZ_NODISCARD static az_result
+_az_json_validator_skip_string(uint8_t const* json_ptr, int32_t json_size, int32_t* ref_index)
+{
+  int32_t index = *ref_index + 1;
+
+  while (true)
+  {
+    // Skip over the run of ASCII bytes that don't need any special handling. Most strings are
+    // short, so the first bytes are checked one at a time, and only a longer run is scanned a block
+    // at a time.
+    int32_t const short_run_end
+        = json_size - index < _az_JSON_VALIDATOR_SHORT_RUN ? json_size
+                                                           : index + _az_JSON_VALIDATOR_SHORT_RUN;
+    while (index < short_run_end && _az_json_is_clean_ascii(json_ptr[index]))
+    {
+      index++;
+    }
+    if (index == short_run_end)
+    {
+      index += _az_simd_json_string_ascii_clean_prefix(json_ptr + index, json_size - index);
+      while (index < json_size && _az_json_is_clean_ascii(json_ptr[index]))
+      {
+        index++;
+      }
+    }
+    if (index >= json_size)
+    {
+      return AZ_ERROR_UNEXPECTED_END;
+    }
+
+    uint8_t const next_byte = json_ptr[index];
+    if (next_byte == '"')
+    {
+      *ref_index = index + 1;
+      return AZ_OK;
+    }
+
+    if (next_byte == '\\')
+    {
+      index++;
+      if (index >= json_size)
+      {
+        return AZ_ERROR_UNEXPECTED_END;
+      }
+
+      switch (json_ptr[index])
+      {
+        case '\\':
+        case '"':
+        case '/':
+        case 'b':
+        case 'f':
+        case 'n':
+        case 'r':
+        case 't':
+          index++;
+          break;
+        case 'u':
+          // Expecting 4 hex digits to follow the escaped 'u'
+          for (int32_t i = 0; i < 4; i++)
+          {
+            index++;
+            if (index >= json_size)
+            {
+              return AZ_ERROR_UNEXPECTED_END;
+            }
+            if (!isxdigit(json_ptr[index]))
+            {
+              return AZ_ERROR_UNEXPECTED_CHAR;
+            }
+          }
+          index++;
+          break;
+        default:
+          return AZ_ERROR_UNEXPECTED_CHAR;
+      }
+    }
+    else if (next_byte < _az_ASCII_SPACE_CHARACTER)
+    {
+      // Control characters are invalid within a JSON string and should be correctly escaped.
+      return AZ_ERROR_UNEXPECTED_CHAR;
+    }
+    else
+    {
+      int32_t const sequence_size
+          = _az_json_utf8_sequence_size(json_ptr + index, json_size - index);
+      if (sequence_size == 0)
+      {
+        return AZ_ERROR_UNEXPECTED_CHAR;
+      }
+      if (sequence_size < 0)
+      {
+        return AZ_ERROR_UNEXPECTED_END;
+      }
+      index += sequence_size;
+    }
+  }
+}
+
+AZ_NODISCARD AZ_INLINE int32_t
+_az_json_validator_skip_digits(uint8_t const* json_ptr, int32_t json_size, int32_t index)
+{
+  while (index < json_size && isdigit(json_ptr[index]))
+  {
+    index++;
+  }
+  return index;
+}
+
+// Validates the number which starts at *ref_index, and moves past it. Whether the number can end
+// where it does is checked by the caller, along with what follows any other value.
+AZ_NODISCARD static az_result
+_az_json_validator_skip_number(uint8_t const* json_ptr, int32_t json_size, int32_t* ref_index)
+{
+  int32_t index = *ref_index;
+
+  if (json_ptr[index] == '-')
+  {
+    index++;
+  }
+
+  // A negative sign must be followed by at least one digit, and a leading 0 by a fraction or an
+  // exponent, if anything.
+  if (index >= json_size)
+  {
+    return AZ_ERROR_UNEXPECTED_END;
+  }
+  if (json_ptr[index] == '0')
+  {
+    index++;
+  }
+  else if (isdigit(json_ptr[index]))
+  {
+    index = _az_json_validator_skip_digits(json_ptr, json_size, index);
+  }
+  else
+  {
+    return AZ_ERROR_UNEXPECTED_CHAR;
+  }
+
+  if (index < json_size && json_ptr[index] == '.')
+  {
+    // A decimal point must be followed by at least one digit.
+    index++;
+    if (index >= json_size)
+    {
+      return AZ_ERROR_UNEXPECTED_END;
+    }
+    if (!isdigit(json_ptr[index]))
+    {
+      return AZ_ERROR_UNEXPECTED_CHAR;
+    }
+    index = _az_json_validator_skip_digits(json_ptr, json_size, index);
+  }
+
+  if (index < json_size && (json_ptr[index] == 'e' || json_ptr[index] == 'E'))
+  {
+    // The 'e'/'E' character must be followed by a sign or at least one digit.
+    index++;
+    if (index < json_size && (json_ptr[index] == '-' || json_ptr[index] == '+'))
+    {
+      index++;
+    }
+    if (index >= json_size)
+    {
+      return AZ_ERROR_UNEXPECTED_END;
+    }
+    if (!isdigit(json_ptr[index]))
+    {
+      return AZ_ERROR_UNEXPECTED_CHAR;
+    }
+    index = _az_json_validator_skip_digits(json_ptr, json_size, index);
+  }
+
+  *ref_index = index;
+  return AZ_OK;
+}
+
+AZ_NODISCARD static az_result
+_az_json_validator_skip_literal(az_span json_text, int32_t* ref_index, az_span literal)
+{
+  int32_t const index = *ref_index;
+  int32_t const literal_size = az_span_size(literal);
+  int32_t const available_size = az_span_size(json_text) - index;
+
+  // If the text matches but is shorter than the literal, the JSON ends too early.
+  int32_t const compared_size = available_size < literal_size ? available_size : literal_size;
+  if (!az_span_is_content_equal(
+          az_span_slice(json_text, index, index + compared_size),
+          az_span_slice(literal, 0, compared_size)))
+  {
+    return AZ_ERROR_UNEXPECTED_CHAR;
+  }
+  if (compared_size < literal_size)
+  {
+    return AZ_ERROR_UNEXPECTED_END;
+  }
+
+  *ref_index = index + literal_size;
+  return AZ_OK;
+}
+
+// Validates the property name at *ref_index along with the colon that follows it, and moves to the
+// property value.
+AZ_NODISCARD static az_result _az_json_validator_skip_property_name(
+    uint8_t const* json_ptr,
+    int32_t json_size,
+    int32_t* ref_index)
+{
+  int32_t index = *ref_index;
+  if (index >= json_size)
+  {
+    return AZ_ERROR_UNEXPECTED_END;
+  }
+  if (json_ptr[index] != '"')
+  {
+    return AZ_ERROR_UNEXPECTED_CHAR;
+  }
+
+  _az_RETURN_IF_FAILED(_az_json_validator_skip_string(json_ptr, json_size, &index));
+  index = _az_json_validator_skip_whitespace(json_ptr, json_size, index);
+  if (index >= json_size)
+  {
+    return AZ_ERROR_UNEXPECTED_END;
+  }
+  if (json_ptr[index] != ':')
+  {
+    return AZ_ERROR_UNEXPECTED_CHAR;
+  }
+
+  *ref_index = _az_json_validator_skip_whitespace(json_ptr, json_size, index + 1);
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result
+_az_json_validate(az_span json_text, az_json_token_kind* out_last_token_kind)
+{
+  uint8_t const* const json_ptr = az_span_ptr(json_text);
+  int32_t const json_size = az_span_size(json_text);
+
+  _az_json_bit_stack bit_stack = { 0 };
+  az_json_token_kind last_token_kind = AZ_JSON_TOKEN_NONE;
+  bool is_property_name_expected = false;
+  int32_t index = _az_json_validator_skip_whitespace(json_ptr, json_size, 0);
+
+  while (true)
+  {
+    if (is_property_name_expected)
+    {
+      _az_RETURN_IF_FAILED(_az_json_validator_skip_property_name(json_ptr, json_size, &index));
+      is_property_name_expected = false;
+    }
+
+    // Expecting a value.
+    if (index >= json_size)
+    {
+      return AZ_ERROR_UNEXPECTED_END;
+    }
+
+    uint8_t const next_byte = json_ptr[index];
+    if (next_byte == '{' || next_byte == '[')
+    {
+      if (bit_stack._internal.current_depth >= _az_json_stack_max_depth(&bit_stack))
+      {
+        return AZ_ERROR_JSON_NESTING_OVERFLOW;
+      }
+
+      bool const is_object = next_byte == '{';
+      _az_json_stack_push(&bit_stack, is_object ? _az_JSON_STACK_OBJECT : _az_JSON_STACK_ARRAY);
+      index = _az_json_validator_skip_whitespace(json_ptr, json_size, index + 1);
+      if (index >= json_size)
+      {
+        return AZ_ERROR_UNEXPECTED_END;
+      }
+
+      // Unless the object or array is empty, continue with its first property or element.
+      if (json_ptr[index] != (is_object ? '}' : ']'))
+      {
+        is_property_name_expected = is_object;
+        continue;
+      }
+
+      _az_json_stack_pop(&bit_stack);
+      last_token_kind = is_object ? AZ_JSON_TOKEN_END_OBJECT : AZ_JSON_TOKEN_END_ARRAY;
+      index++;
+    }
+    else if (next_byte == '"')
+    {
+      _az_RETURN_IF_FAILED(_az_json_validator_skip_string(json_ptr, json_size, &index));
+      last_token_kind = AZ_JSON_TOKEN_STRING;
+    }
+    else if (next_byte == 't')
+    {
+      _az_RETURN_IF_FAILED(
+          _az_json_validator_skip_literal(json_text, &index, AZ_SPAN_FROM_STR("true")));
+      last_token_kind = AZ_JSON_TOKEN_TRUE;
+    }
+    else if (next_byte == 'f')
+    {
+      _az_RETURN_IF_FAILED(
+          _az_json_validator_skip_literal(json_text, &index, AZ_SPAN_FROM_STR("false")));
+      last_token_kind = AZ_JSON_TOKEN_FALSE;
+    }
+    else if (next_byte == 'n')
+    {
+      _az_RETURN_IF_FAILED(
+          _az_json_validator_skip_literal(json_text, &index, AZ_SPAN_FROM_STR("null")));
+      last_token_kind = AZ_JSON_TOKEN_NULL;
+    }
+    else if (next_byte == '-' || isdigit(next_byte))
+    {
+      _az_RETURN_IF_FAILED(_az_json_validator_skip_number(json_ptr, json_size, &index));
+      last_token_kind = AZ_JSON_TOKEN_NUMBER;
+
+      // A number nested within an object or array can't be the end of the JSON.
+      if (index >= json_size && bit_stack._internal.current_depth > 0)
+      {
+        return AZ_ERROR_UNEXPECTED_END;
+      }
+    }
+    else
+    {
+      return AZ_ERROR_UNEXPECTED_CHAR;
+    }
+
+    // After a value, expecting a comma separator or the end of the enclosing object or array, if
+    // any.
+    while (true)
+    {
+      index = _az_json_validator_skip_whitespace(json_ptr, json_size, index);
+      if (bit_stack._internal.current_depth == 0)
+      {
+        if (index < json_size)
+        {
+          return AZ_ERROR_UNEXPECTED_CHAR;
+        }
+        *out_last_token_kind = last_token_kind;
+        return AZ_OK;
+      }
+
+      if (index >= json_size)
+      {
+        return AZ_ERROR_UNEXPECTED_END;
+      }
+
+      bool const is_object = _az_json_stack_peek(&bit_stack) == _az_JSON_STACK_OBJECT;
+      if (json_ptr[index] != (is_object ? '}' : ']'))
+      {
+        break;
+      }
+
+      _az_json_stack_pop(&bit_stack);
+      last_token_kind = is_object ? AZ_JSON_TOKEN_END_OBJECT : AZ_JSON_TOKEN_END_ARRAY;
+      index++;
+    }
+
+    if (json_ptr[index] != ',')
+    {
+      return AZ_ERROR_UNEXPECTED_CHAR;
+    }
+
+    index = _az_json_validator_skip_whitespace(json_ptr, json_size, index + 1);
+    is_property_name_expected = _az_json_stack_peek(&bit_stack) == _az_JSON_STACK_OBJECT;
+  }
+}
+
+AZ_NODISCARD az_result az_json_validate(az_span json_text)
+{
+  _az_PRECONDITION_VALID_SPAN(json_text, 0, true);
+
+  az_json_token_kind last_token_kind = AZ_JSON_TOKEN_NONE;
+  return _az_json_validate(json_text, &last_token_kind);
+}
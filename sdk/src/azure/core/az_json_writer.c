@@ -3,6 +3,7 @@
 
 #include "az_hex_private.h"
 #include "az_json_private.h"
+#include "az_simd_private.h"
 #include "az_span_private.h"
 #include <azure/core/az_json.h>
 #include <azure/core/internal/az_result_internal.h>
@@ -24,11 +25,20 @@ AZ_NODISCARD az_result az_json_writer_init(
       .destination_buffer = destination_buffer,
       .allocator_callback = NULL,
       .user_context = NULL,
+      .flush_callback = NULL,
+      .buffers = NULL,
+      .buffers_length = 0,
+      .buffer_index = 0,
+      .is_measuring = false,
       .bytes_written = 0,
       .total_bytes_written = 0,
       .need_comma = false,
       .token_kind = AZ_JSON_TOKEN_NONE,
-      .bit_stack = { 0 },
+      .bit_stack = {
+        ._internal = {
+          .overflow_bits = options == NULL ? AZ_SPAN_EMPTY : options->nesting_buffer,
+        },
+      },
       .options = options == NULL ? az_json_writer_options_default() : *options,
     },
   };
@@ -50,17 +60,130 @@ AZ_NODISCARD az_result az_json_writer_chunked_init(
       .destination_buffer = first_destination_buffer,
       .allocator_callback = allocator_callback,
       .user_context = user_context,
+      .flush_callback = NULL,
+      .buffers = NULL,
+      .buffers_length = 0,
+      .buffer_index = 0,
+      .is_measuring = false,
       .bytes_written = 0,
       .total_bytes_written = 0,
       .need_comma = false,
       .token_kind = AZ_JSON_TOKEN_NONE,
-      .bit_stack = { 0 },
+      .bit_stack = {
+        ._internal = {
+          .overflow_bits = options == NULL ? AZ_SPAN_EMPTY : options->nesting_buffer,
+        },
+      },
       .options = options == NULL ? az_json_writer_options_default() : *options,
     },
   };
   return AZ_OK;
 }
 
+AZ_NODISCARD az_result az_json_writer_buffered_init(
+    az_json_writer* out_json_writer,
+    az_span const buffers[],
+    int32_t buffers_length,
+    az_json_writer_flush_fn flush_callback,
+    void* user_context,
+    az_json_writer_options const* options)
+{
+  _az_PRECONDITION_NOT_NULL(out_json_writer);
+  _az_PRECONDITION_NOT_NULL(buffers);
+  _az_PRECONDITION(buffers_length > 0);
+  _az_PRECONDITION_NOT_NULL(flush_callback);
+#ifndef AZ_NO_PRECONDITION_CHECKING
+  for (int32_t i = 0; i < buffers_length; i++)
+  {
+    // Any single token, or string chunk, fits in an empty buffer of this size.
+    _az_PRECONDITION_VALID_SPAN(buffers[i], _az_MINIMUM_STRING_CHUNK_SIZE, false);
+  }
+#endif // AZ_NO_PRECONDITION_CHECKING
+
+  *out_json_writer = (az_json_writer){
+    ._internal = {
+      .destination_buffer = buffers[0],
+      .allocator_callback = NULL,
+      .user_context = user_context,
+      .flush_callback = flush_callback,
+      .buffers = buffers,
+      .buffers_length = buffers_length,
+      .buffer_index = 0,
+      .is_measuring = false,
+      .bytes_written = 0,
+      .total_bytes_written = 0,
+      .need_comma = false,
+      .token_kind = AZ_JSON_TOKEN_NONE,
+      .bit_stack = {
+        ._internal = {
+          .overflow_bits = options == NULL ? AZ_SPAN_EMPTY : options->nesting_buffer,
+        },
+      },
+      .options = options == NULL ? az_json_writer_options_default() : *options,
+    },
+  };
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result
+az_json_writer_measure_init(az_json_writer* out_json_writer, az_json_writer_options const* options)
+{
+  _az_PRECONDITION_NOT_NULL(out_json_writer);
+
+  *out_json_writer = (az_json_writer){
+    ._internal = {
+      .destination_buffer = AZ_SPAN_EMPTY,
+      .allocator_callback = NULL,
+      .user_context = NULL,
+      .flush_callback = NULL,
+      .buffers = NULL,
+      .buffers_length = 0,
+      .buffer_index = 0,
+      .is_measuring = true,
+      .bytes_written = 0,
+      .total_bytes_written = 0,
+      .need_comma = false,
+      .token_kind = AZ_JSON_TOKEN_NONE,
+      .bit_stack = {
+        ._internal = {
+          .overflow_bits = options == NULL ? AZ_SPAN_EMPTY : options->nesting_buffer,
+        },
+      },
+      .options = options == NULL ? az_json_writer_options_default() : *options,
+    },
+  };
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_json_writer_flush(az_json_writer* ref_json_writer)
+{
+  _az_PRECONDITION_NOT_NULL(ref_json_writer);
+  _az_PRECONDITION_NOT_NULL(ref_json_writer->_internal.flush_callback);
+
+  int32_t const bytes_written = ref_json_writer->_internal.bytes_written;
+  if (bytes_written == 0)
+  {
+    return AZ_OK;
+  }
+
+  _az_RETURN_IF_FAILED(ref_json_writer->_internal.flush_callback(
+      ref_json_writer->_internal.user_context,
+      az_span_slice(ref_json_writer->_internal.destination_buffer, 0, bytes_written)));
+
+  // The chunk may still be in use, for instance while it is being sent, so move on to the buffer
+  // which was handed to the callback the longest time ago.
+  int32_t buffer_index = ref_json_writer->_internal.buffer_index + 1;
+  if (buffer_index == ref_json_writer->_internal.buffers_length)
+  {
+    buffer_index = 0;
+  }
+
+  ref_json_writer->_internal.buffer_index = buffer_index;
+  ref_json_writer->_internal.destination_buffer = ref_json_writer->_internal.buffers[buffer_index];
+  ref_json_writer->_internal.bytes_written = 0;
+  return AZ_OK;
+}
+
 static AZ_NODISCARD az_span
 _get_remaining_span(az_json_writer* ref_json_writer, int32_t required_size)
 {
@@ -70,7 +193,17 @@ _get_remaining_span(az_json_writer* ref_json_writer, int32_t required_size)
   az_span remaining = az_span_slice_to_end(
       ref_json_writer->_internal.destination_buffer, ref_json_writer->_internal.bytes_written);
 
-  if (az_span_size(remaining) < required_size
+  if (az_span_size(remaining) < required_size && ref_json_writer->_internal.flush_callback != NULL)
+  {
+    // No more space left in the destination, let the caller fail with AZ_ERROR_NOT_ENOUGH_SPACE.
+    if (az_result_failed(az_json_writer_flush(ref_json_writer)))
+    {
+      return AZ_SPAN_EMPTY;
+    }
+    remaining = ref_json_writer->_internal.destination_buffer;
+  }
+  else if (
+      az_span_size(remaining) < required_size
       && ref_json_writer->_internal.allocator_callback != NULL)
   {
     az_span_allocator_context context = {
@@ -91,6 +224,15 @@ _get_remaining_span(az_json_writer* ref_json_writer, int32_t required_size)
   return remaining;
 }
 
+// Whether the writer moves on to another destination buffer once the current one is full, in which
+// case large tokens are written in chunks that each fit within _az_MINIMUM_STRING_CHUNK_SIZE bytes.
+// Otherwise, every token is written at once, using only as many bytes as it takes.
+AZ_INLINE bool _az_json_writer_is_chunked(az_json_writer const* json_writer)
+{
+  return json_writer->_internal.flush_callback != NULL
+      || json_writer->_internal.allocator_callback != NULL;
+}
+
 // This validation method is used outside of just preconditions, within
 // az_json_writer_append_json_text.
 static AZ_NODISCARD bool _az_is_appending_value_valid(az_json_writer const* json_writer)
@@ -223,6 +365,15 @@ static int32_t _az_json_writer_escaped_length(
 
   while (i < value_size)
   {
+    // Skip over whole blocks that don't contain any character which needs to be escaped.
+    int32_t const clean_bytes = _az_simd_json_string_clean_prefix(value_ptr + i, value_size - i);
+    i += clean_bytes;
+    escaped_length += clean_bytes;
+    if (i >= value_size)
+    {
+      break;
+    }
+
     uint8_t const ch = value_ptr[i];
 
     switch (ch)
@@ -362,7 +513,7 @@ static int32_t _az_json_writer_escape_next_byte_and_copy(
 
 static AZ_NODISCARD az_span _az_json_writer_escape_and_copy(az_span destination, az_span source)
 {
-  _az_PRECONDITION_VALID_SPAN(source, 1, false);
+  _az_PRECONDITION_VALID_SPAN(source, 0, true);
 
   int32_t src_size = az_span_size(source);
   _az_PRECONDITION(src_size <= _az_MAX_UNESCAPED_STRING_SIZE);
@@ -375,6 +526,20 @@ static AZ_NODISCARD az_span _az_json_writer_escape_and_copy(az_span destination,
 
   while (i < src_size)
   {
+    // Bulk copy whole blocks that don't need escaping, and only go byte-by-byte from the block that
+    // contains a character to escape.
+    int32_t const clean_bytes = _az_simd_json_string_clean_prefix(value_ptr + i, src_size - i);
+    if (clean_bytes > 0)
+    {
+      remaining_destination
+          = az_span_copy(remaining_destination, az_span_slice(source, i, i + clean_bytes));
+      i += clean_bytes;
+      if (i >= src_size)
+      {
+        break;
+      }
+    }
+
     uint8_t const ch = value_ptr[i];
     _az_json_writer_escape_next_byte_and_copy(&remaining_destination, ch);
     i++;
@@ -396,12 +561,221 @@ AZ_INLINE void _az_update_json_writer_state(
   ref_json_writer->_internal.token_kind = token_kind;
 }
 
+// Writes the JSON string in a single escape and copy pass, without computing its escaped length
+// first, if the current destination buffer can hold it even when every character needs the longest
+// escape sequence. Returns false, without writing anything, if there isn't enough room.
+static AZ_NODISCARD bool _az_json_writer_try_append_escaped_in_place(
+    az_json_writer* ref_json_writer,
+    az_span value,
+    bool is_property_name)
+{
+  bool const need_comma = ref_json_writer->_internal.need_comma;
+
+  // For the surrounding quotes, the optional key:value separator colon, and the leading comma.
+  int32_t const delimiters_size = 2 + (is_property_name ? 1 : 0) + (need_comma ? 1 : 0);
+
+  az_span remaining_json = az_span_slice_to_end(
+      ref_json_writer->_internal.destination_buffer, ref_json_writer->_internal.bytes_written);
+
+  // This can't overflow since the value is at most _az_MAX_UNESCAPED_STRING_SIZE bytes.
+  if (az_span_size(remaining_json)
+      < az_span_size(value) * _az_MAX_EXPANSION_FACTOR_WHILE_ESCAPING + delimiters_size)
+  {
+    return false;
+  }
+
+  az_span const destination = remaining_json;
+  if (need_comma)
+  {
+    remaining_json = az_span_copy_u8(remaining_json, ',');
+  }
+
+  remaining_json = az_span_copy_u8(remaining_json, '"');
+  remaining_json = _az_json_writer_escape_and_copy(remaining_json, value);
+  remaining_json = az_span_copy_u8(remaining_json, '"');
+
+  if (is_property_name)
+  {
+    remaining_json = az_span_copy_u8(remaining_json, ':');
+  }
+
+  int32_t const written = _az_span_diff(remaining_json, destination);
+  _az_update_json_writer_state(
+      ref_json_writer,
+      written,
+      written,
+      !is_property_name,
+      is_property_name ? AZ_JSON_TOKEN_PROPERTY_NAME : AZ_JSON_TOKEN_STRING);
+  return true;
+}
+
+// Accounts for a token of the given size, without writing it, when only measuring the JSON text.
+static AZ_NODISCARD az_result _az_json_writer_count(
+    az_json_writer* ref_json_writer,
+    int32_t required_size,
+    bool need_comma,
+    az_json_token_kind token_kind)
+{
+  _az_PRECONDITION(ref_json_writer->_internal.is_measuring);
+
+  if (required_size > INT32_MAX - ref_json_writer->_internal.total_bytes_written)
+  {
+    return AZ_ERROR_NOT_ENOUGH_SPACE;
+  }
+
+  _az_update_json_writer_state(ref_json_writer, 0, required_size, need_comma, token_kind);
+  return AZ_OK;
+}
+
+// Accounts for a JSON string, or property name, using its escaped length.
+static AZ_NODISCARD az_result
+_az_json_writer_count_string(az_json_writer* ref_json_writer, az_span value, bool is_property_name)
+{
+  int32_t index_of_first_escaped_char = -1;
+  int32_t const escaped_length
+      = _az_json_writer_escaped_length(value, &index_of_first_escaped_char, false);
+
+  // For the surrounding quotes, the optional key:value separator colon, and the leading comma.
+  int32_t const delimiters_size
+      = 2 + (is_property_name ? 1 : 0) + (ref_json_writer->_internal.need_comma ? 1 : 0);
+
+  if (escaped_length > INT32_MAX - delimiters_size)
+  {
+    return AZ_ERROR_NOT_ENOUGH_SPACE;
+  }
+
+  return _az_json_writer_count(
+      ref_json_writer,
+      escaped_length + delimiters_size,
+      !is_property_name,
+      is_property_name ? AZ_JSON_TOKEN_PROPERTY_NAME : AZ_JSON_TOKEN_STRING);
+}
+
+// When writing indented JSON, writes the white space, and the comma separator if needed, that go
+// before the next token. Each value and property name within an object or array starts on a new
+// line, except for the end of an empty object or array, and a property value follows its name on
+// the same line.
+// The token_size is the size of the token that follows, without its comma separator, which is
+// written here instead. Within a single destination buffer, nothing is written unless both the
+// white space and the token fit.
+static AZ_NODISCARD az_result _az_json_writer_append_indentation(
+    az_json_writer* ref_json_writer,
+    bool is_container_end,
+    int32_t token_size)
+{
+  int32_t const indentation = ref_json_writer->_internal.options.indentation;
+  az_json_token_kind const token_kind = ref_json_writer->_internal.token_kind;
+
+  if (indentation == 0 || token_kind == AZ_JSON_TOKEN_NONE
+      || (is_container_end
+          && (token_kind == AZ_JSON_TOKEN_BEGIN_OBJECT
+              || token_kind == AZ_JSON_TOKEN_BEGIN_ARRAY)))
+  {
+    return AZ_OK;
+  }
+
+  uint8_t line_start[2] = { ',', '\n' };
+  az_span line_start_text = AZ_SPAN_FROM_BUFFER(line_start);
+  int32_t spaces = 0;
+
+  if (token_kind == AZ_JSON_TOKEN_PROPERTY_NAME)
+  {
+    line_start_text = AZ_SPAN_FROM_STR(" ");
+  }
+  else
+  {
+    // The end of an object or array never follows a comma separator.
+    if (!ref_json_writer->_internal.need_comma || is_container_end)
+    {
+      line_start_text = az_span_slice_to_end(line_start_text, 1);
+    }
+
+    int32_t depth = ref_json_writer->_internal.bit_stack._internal.current_depth;
+    if (is_container_end)
+    {
+      depth--;
+    }
+    spaces = depth * indentation;
+  }
+
+  int32_t const required_size = az_span_size(line_start_text) + spaces;
+  if (ref_json_writer->_internal.is_measuring)
+  {
+    return _az_json_writer_count(ref_json_writer, required_size, false, token_kind);
+  }
+
+  // With a flush or allocator callback, the white space and large tokens are written in chunks, so
+  // they only need to start within a buffer of the minimum chunk size. If the callback fails after
+  // part of them is written, that part stays written, as it does for a large token by itself.
+  int32_t reserved_size
+      = token_size > INT32_MAX - required_size ? INT32_MAX : required_size + token_size;
+  if (_az_json_writer_is_chunked(ref_json_writer) && reserved_size > _az_MINIMUM_STRING_CHUNK_SIZE)
+  {
+    reserved_size = _az_MINIMUM_STRING_CHUNK_SIZE;
+  }
+
+  az_span remaining_json = _get_remaining_span(ref_json_writer, reserved_size);
+  _az_RETURN_IF_NOT_ENOUGH_SIZE(remaining_json, reserved_size);
+  az_span_copy(remaining_json, line_start_text);
+  ref_json_writer->_internal.bytes_written += az_span_size(line_start_text);
+
+  // Deeply nested JSON can need more spaces than the minimum size of a chunk.
+  while (spaces > 0)
+  {
+    int32_t chunk_size = spaces < _az_MINIMUM_STRING_CHUNK_SIZE ? spaces
+                                                                : _az_MINIMUM_STRING_CHUNK_SIZE;
+    remaining_json = _get_remaining_span(ref_json_writer, chunk_size);
+    _az_RETURN_IF_NOT_ENOUGH_SIZE(remaining_json, chunk_size);
+
+    if (az_span_size(remaining_json) < spaces)
+    {
+      chunk_size = az_span_size(remaining_json);
+    }
+    else
+    {
+      chunk_size = spaces;
+    }
+
+    az_span_fill(az_span_slice(remaining_json, 0, chunk_size), ' ');
+    ref_json_writer->_internal.bytes_written += chunk_size;
+    spaces -= chunk_size;
+  }
+
+  // We already tracked and updated bytes_written while writing, so no need to update it here.
+  _az_update_json_writer_state(ref_json_writer, 0, required_size, false, token_kind);
+  return AZ_OK;
+}
+
+// Gets the size of a JSON string, or property name, written after indentation, for
+// _az_json_writer_append_indentation to check that it fits. The escaped length is only computed
+// when writing indented JSON.
+static AZ_NODISCARD int32_t _az_json_writer_indented_string_size(
+    az_json_writer const* json_writer,
+    az_span value,
+    bool is_property_name)
+{
+  if (json_writer->_internal.options.indentation == 0 || json_writer->_internal.is_measuring)
+  {
+    return 0;
+  }
+
+  // For the surrounding quotes, and the optional key:value separator colon.
+  int32_t const delimiters_size = 2 + (is_property_name ? 1 : 0);
+
+  int32_t index_of_first_escaped_char = -1;
+  int32_t const escaped_length
+      = _az_json_writer_escaped_length(value, &index_of_first_escaped_char, false);
+
+  return escaped_length > INT32_MAX - delimiters_size ? INT32_MAX
+                                                      : escaped_length + delimiters_size;
+}
+
 static AZ_NODISCARD az_result az_json_writer_span_copy_chunked(
     az_json_writer* ref_json_writer,
     az_span* remaining_json,
     az_span value)
 {
-  if (az_span_size(value) < az_span_size(*remaining_json))
+  if (az_span_size(value) <= az_span_size(*remaining_json))
   {
     *remaining_json = az_span_copy(*remaining_json, value);
     ref_json_writer->_internal.bytes_written += az_span_size(value);
@@ -431,7 +805,9 @@ static AZ_NODISCARD az_result az_json_writer_span_copy_chunked(
 static AZ_NODISCARD az_result
 az_json_writer_append_string_small(az_json_writer* ref_json_writer, az_span value)
 {
-  _az_PRECONDITION(az_span_size(value) <= _az_MAX_UNESCAPED_STRING_SIZE_PER_CHUNK);
+  _az_PRECONDITION(
+      az_span_size(value) <= _az_MAX_UNESCAPED_STRING_SIZE_PER_CHUNK
+      || !_az_json_writer_is_chunked(ref_json_writer));
 
   int32_t required_size = 2; // For the surrounding quotes.
 
@@ -443,7 +819,9 @@ az_json_writer_append_string_small(az_json_writer* ref_json_writer, az_span valu
   int32_t index_of_first_escaped_char = -1;
   required_size += _az_json_writer_escaped_length(value, &index_of_first_escaped_char, false);
 
-  _az_PRECONDITION(required_size <= _az_MINIMUM_STRING_CHUNK_SIZE);
+  _az_PRECONDITION(
+      required_size <= _az_MINIMUM_STRING_CHUNK_SIZE
+      || !_az_json_writer_is_chunked(ref_json_writer));
 
   az_span remaining_json = _get_remaining_span(ref_json_writer, required_size);
   _az_RETURN_IF_NOT_ENOUGH_SIZE(remaining_json, required_size);
@@ -561,7 +939,22 @@ AZ_NODISCARD az_result az_json_writer_append_string(az_json_writer* ref_json_wri
   _az_PRECONDITION(az_span_size(value) <= _az_MAX_UNESCAPED_STRING_SIZE);
   _az_PRECONDITION(_az_is_appending_value_valid(ref_json_writer));
 
-  if (az_span_size(value) <= _az_MAX_UNESCAPED_STRING_SIZE_PER_CHUNK)
+  _az_RETURN_IF_FAILED(_az_json_writer_append_indentation(
+      ref_json_writer, false, _az_json_writer_indented_string_size(ref_json_writer, value, false)));
+
+  if (ref_json_writer->_internal.is_measuring)
+  {
+    return _az_json_writer_count_string(ref_json_writer, value, false);
+  }
+
+  if (_az_json_writer_try_append_escaped_in_place(ref_json_writer, value, false))
+  {
+    return AZ_OK;
+  }
+
+  // Within a single destination buffer, the string only needs room for its escaped length.
+  if (az_span_size(value) <= _az_MAX_UNESCAPED_STRING_SIZE_PER_CHUNK
+      || !_az_json_writer_is_chunked(ref_json_writer))
   {
     return az_json_writer_append_string_small(ref_json_writer, value);
   }
@@ -572,7 +965,9 @@ AZ_NODISCARD az_result az_json_writer_append_string(az_json_writer* ref_json_wri
 static AZ_NODISCARD az_result
 az_json_writer_append_property_name_small(az_json_writer* ref_json_writer, az_span value)
 {
-  _az_PRECONDITION(az_span_size(value) <= _az_MAX_UNESCAPED_STRING_SIZE_PER_CHUNK);
+  _az_PRECONDITION(
+      az_span_size(value) <= _az_MAX_UNESCAPED_STRING_SIZE_PER_CHUNK
+      || !_az_json_writer_is_chunked(ref_json_writer));
 
   int32_t required_size = 3; // For the surrounding quotes and the key:value separator colon.
 
@@ -584,7 +979,9 @@ az_json_writer_append_property_name_small(az_json_writer* ref_json_writer, az_sp
   int32_t index_of_first_escaped_char = -1;
   required_size += _az_json_writer_escaped_length(value, &index_of_first_escaped_char, false);
 
-  _az_PRECONDITION(required_size <= _az_MINIMUM_STRING_CHUNK_SIZE);
+  _az_PRECONDITION(
+      required_size <= _az_MINIMUM_STRING_CHUNK_SIZE
+      || !_az_json_writer_is_chunked(ref_json_writer));
 
   az_span remaining_json = _get_remaining_span(ref_json_writer, required_size);
   _az_RETURN_IF_NOT_ENOUGH_SIZE(remaining_json, required_size);
@@ -706,47 +1103,27 @@ az_json_writer_append_property_name(az_json_writer* ref_json_writer, az_span nam
   _az_PRECONDITION(az_span_size(name) <= _az_MAX_UNESCAPED_STRING_SIZE);
   _az_PRECONDITION(_az_is_appending_property_name_valid(ref_json_writer));
 
-  if (az_span_size(name) <= _az_MAX_UNESCAPED_STRING_SIZE_PER_CHUNK)
+  _az_RETURN_IF_FAILED(_az_json_writer_append_indentation(
+      ref_json_writer, false, _az_json_writer_indented_string_size(ref_json_writer, name, true)));
+
+  if (ref_json_writer->_internal.is_measuring)
   {
-    return az_json_writer_append_property_name_small(ref_json_writer, name);
+    return _az_json_writer_count_string(ref_json_writer, name, true);
   }
 
-  return az_json_writer_append_property_name_chunked(ref_json_writer, name);
-}
-
-static AZ_NODISCARD az_result _az_validate_json(
-    az_span json_text,
-    az_json_token_kind* first_token_kind,
-    az_json_token_kind* last_token_kind)
-{
-  _az_PRECONDITION_NOT_NULL(first_token_kind);
-
-  az_json_reader reader = { 0 };
-  _az_RETURN_IF_FAILED(az_json_reader_init(&reader, json_text, NULL));
-
-  az_result result = az_json_reader_next_token(&reader);
-  _az_RETURN_IF_FAILED(result);
-
-  // This is guaranteed not to be a property name or end object/array.
-  // The first token of a valid JSON must either be a value or start object/array.
-  *first_token_kind = reader.token.kind;
-
-  // Keep reading until we have finished validating the entire JSON text and make sure it isn't
-  // incomplete.
-  while (az_result_succeeded(result = az_json_reader_next_token(&reader)))
+  if (_az_json_writer_try_append_escaped_in_place(ref_json_writer, name, true))
   {
+    return AZ_OK;
   }
 
-  if (result != AZ_ERROR_JSON_READER_DONE)
+  // Within a single destination buffer, the name only needs room for its escaped length.
+  if (az_span_size(name) <= _az_MAX_UNESCAPED_STRING_SIZE_PER_CHUNK
+      || !_az_json_writer_is_chunked(ref_json_writer))
   {
-    return result;
+    return az_json_writer_append_property_name_small(ref_json_writer, name);
   }
 
-  // This is guaranteed not to be a property name or start object/array.
-  // The last token of a valid JSON must either be a value or end object/array.
-  *last_token_kind = reader.token.kind;
-
-  return AZ_OK;
+  return az_json_writer_append_property_name_chunked(ref_json_writer, name);
 }
 
 AZ_NODISCARD az_result
@@ -756,17 +1133,13 @@ az_json_writer_append_json_text(az_json_writer* ref_json_writer, az_span json_te
   // A null or empty span is not allowed since that is invalid JSON.
   _az_PRECONDITION_VALID_SPAN(json_text, 0, false);
 
-  az_json_token_kind first_token_kind = AZ_JSON_TOKEN_NONE;
   az_json_token_kind last_token_kind = AZ_JSON_TOKEN_NONE;
 
   // This runtime validation is necessary since the input could be user defined and malformed.
   // This cannot be caught at dev time by a precondition, especially since they can be turned off.
-  _az_RETURN_IF_FAILED(_az_validate_json(json_text, &first_token_kind, &last_token_kind));
+  _az_RETURN_IF_FAILED(_az_json_validate(json_text, &last_token_kind));
 
-  // It is guaranteed that first_token_kind is NOT:
-  // AZ_JSON_TOKEN_NONE, AZ_JSON_TOKEN_END_ARRAY, AZ_JSON_TOKEN_END_OBJECT,
-  // AZ_JSON_TOKEN_PROPERTY_NAME
-  // And that last_token_kind is NOT:
+  // It is guaranteed that last_token_kind is NOT:
   // AZ_JSON_TOKEN_NONE, AZ_JSON_TOKEN_START_ARRAY, AZ_JSON_TOKEN_START_OBJECT,
   // AZ_JSON_TOKEN_PROPERTY_NAME
 
@@ -775,12 +1148,30 @@ az_json_writer_append_json_text(az_json_writer* ref_json_writer, az_span json_te
   if (!_az_is_appending_value_valid(ref_json_writer))
   {
     // All other tokens, including start array and object are validated here.
-    // Also first_token_kind cannot be AZ_JSON_TOKEN_NONE at this point.
     return AZ_ERROR_JSON_INVALID_STATE;
   }
 
-  az_span remaining_json = _get_remaining_span(ref_json_writer, _az_MINIMUM_STRING_CHUNK_SIZE);
-  _az_RETURN_IF_NOT_ENOUGH_SIZE(remaining_json, _az_MINIMUM_STRING_CHUNK_SIZE);
+  _az_RETURN_IF_FAILED(
+      _az_json_writer_append_indentation(ref_json_writer, false, az_span_size(json_text)));
+
+  int32_t const comma_size = ref_json_writer->_internal.need_comma ? 1 : 0;
+  if (ref_json_writer->_internal.is_measuring)
+  {
+    return _az_json_writer_count(
+        ref_json_writer, az_span_size(json_text) + comma_size, true, last_token_kind);
+  }
+
+  // Within a single destination buffer, the JSON text only needs room for itself.
+  int32_t reserved_size = _az_MINIMUM_STRING_CHUNK_SIZE;
+  if (!_az_json_writer_is_chunked(ref_json_writer))
+  {
+    reserved_size = az_span_size(json_text) > INT32_MAX - comma_size
+        ? INT32_MAX
+        : az_span_size(json_text) + comma_size;
+  }
+
+  az_span remaining_json = _get_remaining_span(ref_json_writer, reserved_size);
+  _az_RETURN_IF_NOT_ENOUGH_SIZE(remaining_json, reserved_size);
 
   if (ref_json_writer->_internal.need_comma)
   {
@@ -803,6 +1194,179 @@ az_json_writer_append_json_text(az_json_writer* ref_json_writer, az_span json_te
   return AZ_OK;
 }
 
+// Copies the text into as many destination buffers as needed.
+static AZ_NODISCARD az_result
+_az_json_writer_copy_text(az_json_writer* ref_json_writer, az_span text, int32_t required_size)
+{
+  while (az_span_size(text) > 0)
+  {
+    az_span remaining_json = _get_remaining_span(ref_json_writer, required_size);
+    _az_RETURN_IF_NOT_ENOUGH_SIZE(remaining_json, required_size);
+
+    int32_t const chunk_size = az_span_size(text) < az_span_size(remaining_json)
+        ? az_span_size(text)
+        : az_span_size(remaining_json);
+    az_span_copy(remaining_json, az_span_slice(text, 0, chunk_size));
+    ref_json_writer->_internal.bytes_written += chunk_size;
+    text = az_span_slice_to_end(text, chunk_size);
+  }
+  return AZ_OK;
+}
+
+// Appends a string, property name, or number token read by an az_json_reader, copying its text as
+// is, so that strings are neither unescaped nor escaped again.
+static AZ_NODISCARD az_result
+_az_json_writer_append_token_text(az_json_writer* ref_json_writer, az_json_token const* json_token)
+{
+  _az_PRECONDITION_NOT_NULL(ref_json_writer);
+  _az_PRECONDITION_NOT_NULL(json_token);
+
+  az_json_token_kind const token_kind = json_token->kind;
+  bool const is_property_name = token_kind == AZ_JSON_TOKEN_PROPERTY_NAME;
+  bool const is_string = is_property_name || token_kind == AZ_JSON_TOKEN_STRING;
+
+  _az_PRECONDITION(is_string || token_kind == AZ_JSON_TOKEN_NUMBER);
+  _az_PRECONDITION(
+      is_property_name ? _az_is_appending_property_name_valid(ref_json_writer)
+                       : _az_is_appending_value_valid(ref_json_writer));
+
+  // For the surrounding quotes of a string, and the key:value separator colon of a property name.
+  int32_t const delimiters_size = (is_string ? 2 : 0) + (is_property_name ? 1 : 0);
+  _az_RETURN_IF_FAILED(_az_json_writer_append_indentation(
+      ref_json_writer, false, json_token->size + delimiters_size));
+
+  uint8_t prefix[2] = { ',', '"' };
+  az_span prefix_text = AZ_SPAN_FROM_BUFFER(prefix);
+  if (!ref_json_writer->_internal.need_comma)
+  {
+    prefix_text = az_span_slice_to_end(prefix_text, 1);
+  }
+  if (!is_string)
+  {
+    prefix_text = az_span_slice(prefix_text, 0, az_span_size(prefix_text) - 1);
+  }
+
+  az_span suffix_text = AZ_SPAN_FROM_STR("\":");
+  if (!is_property_name)
+  {
+    suffix_text = az_span_slice(suffix_text, 0, is_string ? 1 : 0);
+  }
+
+  int32_t const required_size
+      = az_span_size(prefix_text) + json_token->size + az_span_size(suffix_text);
+  if (ref_json_writer->_internal.is_measuring)
+  {
+    return _az_json_writer_count(ref_json_writer, required_size, !is_property_name, token_kind);
+  }
+
+  // Small tokens are kept within a single destination buffer, like any other token.
+  if (required_size <= _az_MINIMUM_STRING_CHUNK_SIZE)
+  {
+    az_span remaining_json = _get_remaining_span(ref_json_writer, required_size);
+    _az_RETURN_IF_NOT_ENOUGH_SIZE(remaining_json, required_size);
+  }
+
+  _az_RETURN_IF_FAILED(
+      _az_json_writer_copy_text(ref_json_writer, prefix_text, az_span_size(prefix_text)));
+
+  if (!json_token->_internal.is_multisegment)
+  {
+    _az_RETURN_IF_FAILED(_az_json_writer_copy_text(ref_json_writer, json_token->slice, 1));
+  }
+  else
+  {
+    for (int32_t i = json_token->_internal.start_buffer_index;
+         i <= json_token->_internal.end_buffer_index;
+         i++)
+    {
+      az_span source = json_token->_internal.pointer_to_first_buffer[i];
+      if (i == json_token->_internal.end_buffer_index)
+      {
+        source = az_span_slice(source, 0, json_token->_internal.end_buffer_offset);
+      }
+      if (i == json_token->_internal.start_buffer_index)
+      {
+        source = az_span_slice_to_end(source, json_token->_internal.start_buffer_offset);
+      }
+      _az_RETURN_IF_FAILED(_az_json_writer_copy_text(ref_json_writer, source, 1));
+    }
+  }
+
+  _az_RETURN_IF_FAILED(
+      _az_json_writer_copy_text(ref_json_writer, suffix_text, az_span_size(suffix_text)));
+
+  // We already tracked and updated bytes_written while writing, so no need to update it here.
+  _az_update_json_writer_state(ref_json_writer, 0, required_size, !is_property_name, token_kind);
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result
+az_json_writer_transcode(az_json_writer* ref_json_writer, az_json_reader* ref_json_reader)
+{
+  _az_PRECONDITION_NOT_NULL(ref_json_writer);
+  _az_PRECONDITION_NOT_NULL(ref_json_reader);
+
+  if (ref_json_reader->token.kind == AZ_JSON_TOKEN_NONE)
+  {
+    _az_RETURN_IF_FAILED(az_json_reader_next_token(ref_json_reader));
+  }
+
+  if (ref_json_reader->token.kind == AZ_JSON_TOKEN_PROPERTY_NAME)
+  {
+    _az_RETURN_IF_FAILED(az_json_reader_next_token(ref_json_reader));
+  }
+
+  // Stop once the reader is back to the depth of the value it started on, which doesn't include the
+  // object or array that the value itself begins.
+  int32_t depth = ref_json_reader->_internal.bit_stack._internal.current_depth;
+  if (ref_json_reader->token.kind == AZ_JSON_TOKEN_BEGIN_OBJECT
+      || ref_json_reader->token.kind == AZ_JSON_TOKEN_BEGIN_ARRAY)
+  {
+    depth--;
+  }
+
+  while (true)
+  {
+    az_json_token const* const token = &ref_json_reader->token;
+    switch (token->kind)
+    {
+      case AZ_JSON_TOKEN_BEGIN_OBJECT:
+        _az_RETURN_IF_FAILED(az_json_writer_append_begin_object(ref_json_writer));
+        break;
+      case AZ_JSON_TOKEN_END_OBJECT:
+        _az_RETURN_IF_FAILED(az_json_writer_append_end_object(ref_json_writer));
+        break;
+      case AZ_JSON_TOKEN_BEGIN_ARRAY:
+        _az_RETURN_IF_FAILED(az_json_writer_append_begin_array(ref_json_writer));
+        break;
+      case AZ_JSON_TOKEN_END_ARRAY:
+        _az_RETURN_IF_FAILED(az_json_writer_append_end_array(ref_json_writer));
+        break;
+      case AZ_JSON_TOKEN_TRUE:
+        _az_RETURN_IF_FAILED(az_json_writer_append_bool(ref_json_writer, true));
+        break;
+      case AZ_JSON_TOKEN_FALSE:
+        _az_RETURN_IF_FAILED(az_json_writer_append_bool(ref_json_writer, false));
+        break;
+      case AZ_JSON_TOKEN_NULL:
+        _az_RETURN_IF_FAILED(az_json_writer_append_null(ref_json_writer));
+        break;
+      default:
+        _az_RETURN_IF_FAILED(_az_json_writer_append_token_text(ref_json_writer, token));
+        break;
+    }
+
+    if (ref_json_reader->_internal.bit_stack._internal.current_depth <= depth
+        && token->kind != AZ_JSON_TOKEN_PROPERTY_NAME
+        && token->kind != AZ_JSON_TOKEN_BEGIN_OBJECT && token->kind != AZ_JSON_TOKEN_BEGIN_ARRAY)
+    {
+      return AZ_OK;
+    }
+
+    _az_RETURN_IF_FAILED(az_json_reader_next_token(ref_json_reader));
+  }
+}
+
 static AZ_NODISCARD az_result _az_json_writer_append_literal(
     az_json_writer* ref_json_writer,
     az_span literal,
@@ -816,6 +1380,9 @@ static AZ_NODISCARD az_result _az_json_writer_append_literal(
   _az_PRECONDITION(az_span_size(literal) <= 5); // null, true, or false
   _az_PRECONDITION(_az_is_appending_value_valid(ref_json_writer));
 
+  _az_RETURN_IF_FAILED(
+      _az_json_writer_append_indentation(ref_json_writer, false, az_span_size(literal)));
+
   int32_t required_size = az_span_size(literal);
 
   if (ref_json_writer->_internal.need_comma)
@@ -823,6 +1390,11 @@ static AZ_NODISCARD az_result _az_json_writer_append_literal(
     required_size++; // For the leading comma separator.
   }
 
+  if (ref_json_writer->_internal.is_measuring)
+  {
+    return _az_json_writer_count(ref_json_writer, required_size, true, literal_kind);
+  }
+
   az_span remaining_json = _get_remaining_span(ref_json_writer, required_size);
   _az_RETURN_IF_NOT_ENOUGH_SIZE(remaining_json, required_size);
 
@@ -856,13 +1428,38 @@ AZ_NODISCARD az_result az_json_writer_append_int32(az_json_writer* ref_json_writ
   _az_PRECONDITION_NOT_NULL(ref_json_writer);
   _az_PRECONDITION(_az_is_appending_value_valid(ref_json_writer));
 
-  int32_t required_size = _az_MAX_SIZE_FOR_INT32; // Need enough space to write any 32-bit integer.
+  // The digits are written to a local buffer first, so that only their actual size is needed in the
+  // destination, which is also the size counted when measuring.
+  uint8_t number_buffer[_az_MAX_SIZE_FOR_INT32];
+  az_span const number_text = AZ_SPAN_FROM_BUFFER(number_buffer);
+  az_span remainder = AZ_SPAN_EMPTY;
+  _az_RETURN_IF_FAILED(az_span_i32toa(number_text, value, &remainder));
+  return _az_json_writer_append_number_text(
+      ref_json_writer, az_span_slice(number_text, 0, _az_span_diff(remainder, number_text)));
+}
+
+AZ_NODISCARD az_result
+_az_json_writer_append_number_text(az_json_writer* ref_json_writer, az_span number_text)
+{
+  _az_PRECONDITION_NOT_NULL(ref_json_writer);
+  _az_PRECONDITION_VALID_SPAN(number_text, 1, false);
+  _az_PRECONDITION(_az_is_appending_value_valid(ref_json_writer));
+
+  _az_RETURN_IF_FAILED(
+      _az_json_writer_append_indentation(ref_json_writer, false, az_span_size(number_text)));
+
+  int32_t required_size = az_span_size(number_text);
 
   if (ref_json_writer->_internal.need_comma)
   {
     required_size++; // For the leading comma separator.
   }
 
+  if (ref_json_writer->_internal.is_measuring)
+  {
+    return _az_json_writer_count(ref_json_writer, required_size, true, AZ_JSON_TOKEN_NUMBER);
+  }
+
   az_span remaining_json = _get_remaining_span(ref_json_writer, required_size);
   _az_RETURN_IF_NOT_ENOUGH_SIZE(remaining_json, required_size);
 
@@ -871,17 +1468,10 @@ AZ_NODISCARD az_result az_json_writer_append_int32(az_json_writer* ref_json_writ
     remaining_json = az_span_copy_u8(remaining_json, ',');
   }
 
-  // Since we asked for the maximum needed space above, this is guaranteed not to fail due to
-  // AZ_ERROR_NOT_ENOUGH_SPACE. Still checking the returned az_result, for other potential failure
-  // cases.
-  az_span leftover;
-  _az_RETURN_IF_FAILED(az_span_i32toa(remaining_json, value, &leftover));
+  az_span_copy(remaining_json, number_text);
 
-  // We already accounted for the maximum size needed in required_size, so subtract that to get the
-  // actual bytes written.
-  int32_t written
-      = required_size + _az_span_diff(leftover, remaining_json) - _az_MAX_SIZE_FOR_INT32;
-  _az_update_json_writer_state(ref_json_writer, written, written, true, AZ_JSON_TOKEN_NUMBER);
+  _az_update_json_writer_state(
+      ref_json_writer, required_size, required_size, true, AZ_JSON_TOKEN_NUMBER);
   return AZ_OK;
 }
 
@@ -897,34 +1487,33 @@ AZ_NODISCARD az_result az_json_writer_append_double(
   _az_PRECONDITION(_az_isfinite(value));
   _az_PRECONDITION_RANGE(0, fractional_digits, _az_MAX_SUPPORTED_FRACTIONAL_DIGITS);
 
-  // Need enough space to write any double number.
-  int32_t required_size = _az_MAX_SIZE_FOR_WRITING_DOUBLE;
-
-  if (ref_json_writer->_internal.need_comma)
-  {
-    required_size++; // For the leading comma separator.
-  }
-
-  az_span remaining_json = _get_remaining_span(ref_json_writer, required_size);
-  _az_RETURN_IF_NOT_ENOUGH_SIZE(remaining_json, required_size);
-
-  if (ref_json_writer->_internal.need_comma)
-  {
-    remaining_json = az_span_copy_u8(remaining_json, ',');
-  }
+  // The digits are written to a local buffer first, so that only their actual size is needed in the
+  // destination.
+  uint8_t number_buffer[_az_MAX_SIZE_FOR_WRITING_DOUBLE];
+  az_span const number_text = AZ_SPAN_FROM_BUFFER(number_buffer);
+  az_span remainder = AZ_SPAN_EMPTY;
+  _az_RETURN_IF_FAILED(az_span_dtoa(number_text, value, fractional_digits, &remainder));
+  return _az_json_writer_append_number_text(
+      ref_json_writer, az_span_slice(number_text, 0, _az_span_diff(remainder, number_text)));
+}
 
-  // Since we asked for the maximum needed space above, this is guaranteed not to fail due to
-  // AZ_ERROR_NOT_ENOUGH_SPACE. Still checking the returned az_result, for other potential failure
-  // cases.
-  az_span leftover;
-  _az_RETURN_IF_FAILED(az_span_dtoa(remaining_json, value, fractional_digits, &leftover));
+AZ_NODISCARD az_result
+az_json_writer_append_double_shortest(az_json_writer* ref_json_writer, double value)
+{
+  _az_PRECONDITION_NOT_NULL(ref_json_writer);
+  _az_PRECONDITION(_az_is_appending_value_valid(ref_json_writer));
+  // Non-finite numbers are not supported because they lead to invalid JSON.
+  // Unquoted strings such as nan and -inf are invalid as JSON numbers.
+  _az_PRECONDITION(_az_isfinite(value));
 
-  // We already accounted for the maximum size needed in required_size, so subtract that to get the
-  // actual bytes written.
-  int32_t written
-      = required_size + _az_span_diff(leftover, remaining_json) - _az_MAX_SIZE_FOR_WRITING_DOUBLE;
-  _az_update_json_writer_state(ref_json_writer, written, written, true, AZ_JSON_TOKEN_NUMBER);
-  return AZ_OK;
+  // The digits are written to a local buffer first, so that only their actual size is needed in the
+  // destination.
+  uint8_t number_buffer[_az_MAX_SIZE_FOR_WRITING_SHORTEST_DOUBLE];
+  az_span const number_text = AZ_SPAN_FROM_BUFFER(number_buffer);
+  az_span remainder = AZ_SPAN_EMPTY;
+  _az_RETURN_IF_FAILED(az_span_dtoa_shortest(number_text, value, &remainder));
+  return _az_json_writer_append_number_text(
+      ref_json_writer, az_span_slice(number_text, 0, _az_span_diff(remainder, number_text)));
 }
 
 static AZ_NODISCARD az_result _az_json_writer_append_container_start(
@@ -937,13 +1526,16 @@ static AZ_NODISCARD az_result _az_json_writer_append_container_start(
       container_kind == AZ_JSON_TOKEN_BEGIN_OBJECT || container_kind == AZ_JSON_TOKEN_BEGIN_ARRAY);
   _az_PRECONDITION(_az_is_appending_value_valid(ref_json_writer));
 
-  // The current depth is equal to or larger than the maximum allowed depth of 64. Cannot write the
-  // next JSON object or array.
-  if (ref_json_writer->_internal.bit_stack._internal.current_depth >= _az_MAX_JSON_STACK_SIZE)
+  // The current depth is equal to or larger than the maximum allowed depth of 64, plus the levels
+  // allowed by the nesting buffer. Cannot write the next JSON object or array.
+  if (ref_json_writer->_internal.bit_stack._internal.current_depth
+      >= _az_json_stack_max_depth(&ref_json_writer->_internal.bit_stack))
   {
     return AZ_ERROR_JSON_NESTING_OVERFLOW;
   }
 
+  _az_RETURN_IF_FAILED(_az_json_writer_append_indentation(ref_json_writer, false, 1));
+
   int32_t required_size = 1; // For the start object or array byte.
 
   if (ref_json_writer->_internal.need_comma)
@@ -951,18 +1543,27 @@ static AZ_NODISCARD az_result _az_json_writer_append_container_start(
     required_size++; // For the leading comma separator.
   }
 
-  az_span remaining_json = _get_remaining_span(ref_json_writer, required_size);
-  _az_RETURN_IF_NOT_ENOUGH_SIZE(remaining_json, required_size);
-
-  if (ref_json_writer->_internal.need_comma)
+  if (ref_json_writer->_internal.is_measuring)
   {
-    remaining_json = az_span_copy_u8(remaining_json, ',');
+    _az_RETURN_IF_FAILED(
+        _az_json_writer_count(ref_json_writer, required_size, false, container_kind));
   }
+  else
+  {
+    az_span remaining_json = _get_remaining_span(ref_json_writer, required_size);
+    _az_RETURN_IF_NOT_ENOUGH_SIZE(remaining_json, required_size);
 
-  az_span_copy_u8(remaining_json, byte);
+    if (ref_json_writer->_internal.need_comma)
+    {
+      remaining_json = az_span_copy_u8(remaining_json, ',');
+    }
+
+    az_span_copy_u8(remaining_json, byte);
+
+    _az_update_json_writer_state(
+        ref_json_writer, required_size, required_size, false, container_kind);
+  }
 
-  _az_update_json_writer_state(
-      ref_json_writer, required_size, required_size, false, container_kind);
   if (container_kind == AZ_JSON_TOKEN_BEGIN_OBJECT)
   {
     _az_json_stack_push(&ref_json_writer->_internal.bit_stack, _az_JSON_STACK_OBJECT);
@@ -995,14 +1596,25 @@ static AZ_NODISCARD az_result az_json_writer_append_container_end(
       container_kind == AZ_JSON_TOKEN_END_OBJECT || container_kind == AZ_JSON_TOKEN_END_ARRAY);
   _az_PRECONDITION(_az_is_appending_container_end_valid(ref_json_writer, byte));
 
+  _az_RETURN_IF_FAILED(_az_json_writer_append_indentation(ref_json_writer, true, 1));
+
   int32_t required_size = 1; // For the end object or array byte.
 
-  az_span remaining_json = _get_remaining_span(ref_json_writer, required_size);
-  _az_RETURN_IF_NOT_ENOUGH_SIZE(remaining_json, required_size);
+  if (ref_json_writer->_internal.is_measuring)
+  {
+    _az_RETURN_IF_FAILED(
+        _az_json_writer_count(ref_json_writer, required_size, true, container_kind));
+  }
+  else
+  {
+    az_span remaining_json = _get_remaining_span(ref_json_writer, required_size);
+    _az_RETURN_IF_NOT_ENOUGH_SIZE(remaining_json, required_size);
 
-  az_span_copy_u8(remaining_json, byte);
+    az_span_copy_u8(remaining_json, byte);
 
-  _az_update_json_writer_state(ref_json_writer, required_size, required_size, true, container_kind);
+    _az_update_json_writer_state(
+        ref_json_writer, required_size, required_size, true, container_kind);
+  }
   _az_json_stack_pop(&ref_json_writer->_internal.bit_stack);
 
   return AZ_OK;
@@ -0,0 +1,286 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ *
+ * @brief Block scanning helpers which use the SIMD instruction set of the target (SSE2, AVX2, or
+ * NEON), selected at build time.
+ *
+ * @details Each helper returns the number of leading bytes, examined one block at a time, that
+ * don't match what the caller is looking for. Any trailing bytes that don't fill a whole block are
+ * left for the caller's scalar loop, which remains the reference implementation. When no supported
+ * instruction set is available, or when the SDK is built with `AZ_NO_SIMD`, the helpers return 0
+ * and the scalar loop processes all of the input.
+ */
+
+#ifndef _az_SIMD_PRIVATE_H
+#define _az_SIMD_PRIVATE_H
+
+#include <stdint.h>
+
+#if !defined(AZ_NO_SIMD)
+#if defined(__AVX2__)
+#define _az_SIMD_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define _az_SIMD_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define _az_SIMD_NEON
+#include <arm_neon.h>
+#endif
+#endif // AZ_NO_SIMD
+
+#if defined(_az_SIMD_AVX2)
+#define _az_SIMD_BLOCK_SIZE 32
+#elif defined(_az_SIMD_SSE2) || defined(_az_SIMD_NEON)
+#define _az_SIMD_BLOCK_SIZE 16
+#endif
+
+#if defined(_MSC_VER) && defined(_az_SIMD_BLOCK_SIZE)
+#include <intrin.h>
+#endif
+
+#include <azure/core/_az_cfg_prefix.h>
+
+#if defined(_az_SIMD_AVX2) || defined(_az_SIMD_SSE2)
+
+// Returns the index of the lowest set bit. The mask must not be 0.
+AZ_NODISCARD AZ_INLINE int32_t _az_simd_lowest_set_bit(uint32_t mask)
+{
+#ifdef _MSC_VER
+  unsigned long index = 0;
+  _BitScanForward(&index, mask);
+  return (int32_t)index;
+#else
+  return __builtin_ctz(mask);
+#endif
+}
+
+#if defined(_az_SIMD_AVX2)
+typedef __m256i _az_simd_block;
+typedef uint32_t _az_simd_bitmask;
+#define _az_simd_load(ptr) _mm256_loadu_si256((__m256i const*)(ptr))
+#define _az_simd_splat(byte) _mm256_set1_epi8((char)(byte))
+#define _az_simd_equal(a, b) _mm256_cmpeq_epi8((a), (b))
+#define _az_simd_min(a, b) _mm256_min_epu8((a), (b))
+#define _az_simd_max(a, b) _mm256_max_epu8((a), (b))
+#define _az_simd_sub(a, b) _mm256_sub_epi8((a), (b))
+#define _az_simd_or(a, b) _mm256_or_si256((a), (b))
+#define _az_simd_mask(a) ((uint32_t)_mm256_movemask_epi8(a))
+#define _az_SIMD_ALL_MATCH ((uint32_t)0xFFFFFFFF)
+#else
+typedef __m128i _az_simd_block;
+typedef uint32_t _az_simd_bitmask;
+#define _az_simd_load(ptr) _mm_loadu_si128((__m128i const*)(ptr))
+#define _az_simd_splat(byte) _mm_set1_epi8((char)(byte))
+#define _az_simd_equal(a, b) _mm_cmpeq_epi8((a), (b))
+#define _az_simd_min(a, b) _mm_min_epu8((a), (b))
+#define _az_simd_max(a, b) _mm_max_epu8((a), (b))
+#define _az_simd_sub(a, b) _mm_sub_epi8((a), (b))
+#define _az_simd_or(a, b) _mm_or_si128((a), (b))
+#define _az_simd_mask(a) ((uint32_t)_mm_movemask_epi8(a))
+#define _az_SIMD_ALL_MATCH ((uint32_t)0xFFFF)
+#endif
+
+// Every byte of the block, that matches, sets the corresponding bit of the mask.
+#define _az_simd_find_first(mask) _az_simd_lowest_set_bit(mask)
+
+#elif defined(_az_SIMD_NEON)
+
+typedef uint8x16_t _az_simd_block;
+typedef uint64_t _az_simd_bitmask;
+#define _az_simd_load(ptr) vld1q_u8(ptr)
+#define _az_simd_splat(byte) vdupq_n_u8((uint8_t)(byte))
+#define _az_simd_equal(a, b) vceqq_u8((a), (b))
+#define _az_simd_min(a, b) vminq_u8((a), (b))
+#define _az_simd_max(a, b) vmaxq_u8((a), (b))
+#define _az_simd_sub(a, b) vsubq_u8((a), (b))
+#define _az_simd_or(a, b) vorrq_u8((a), (b))
+#define _az_SIMD_ALL_MATCH UINT64_MAX
+
+// NEON has no byte movemask, so narrow each 0x00/0xFF lane to a nibble instead, which gives a
+// 64-bit mask with 4 bits per byte.
+AZ_NODISCARD AZ_INLINE uint64_t _az_simd_mask(uint8x16_t matches)
+{
+  uint8x8_t const narrowed = vshrn_n_u16(vreinterpretq_u16_u8(matches), 4);
+  return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0);
+}
+
+AZ_NODISCARD AZ_INLINE int32_t _az_simd_find_first(uint64_t mask)
+{
+#ifdef _MSC_VER
+  unsigned long index = 0;
+  _BitScanForward64(&index, mask);
+  return (int32_t)index / 4;
+#else
+  return __builtin_ctzll(mask) / 4;
+#endif
+}
+
+#endif
+
+/**
+ * @brief Finds the first byte which ends a clean run within a JSON string: the closing quote, a
+ * backslash, or a control character (less than 0x20).
+ *
+ * @param[in] ptr The bytes to scan.
+ * @param[in] size The number of bytes available at \p ptr.
+ *
+ * @return The number of leading bytes that don't need special handling. If it is smaller than the
+ * number of bytes scanned in whole blocks, the byte at that index needs special handling.
+ */
+AZ_NODISCARD AZ_INLINE int32_t
+_az_simd_json_string_clean_prefix(uint8_t const* ptr, int32_t size)
+{
+#ifdef _az_SIMD_BLOCK_SIZE
+  _az_simd_block const quote = _az_simd_splat('"');
+  _az_simd_block const backslash = _az_simd_splat('\\');
+  _az_simd_block const last_control_char = _az_simd_splat(0x1F);
+
+  int32_t index = 0;
+  for (; index + _az_SIMD_BLOCK_SIZE <= size; index += _az_SIMD_BLOCK_SIZE)
+  {
+    _az_simd_block const block = _az_simd_load(ptr + index);
+
+    // A byte is a control character if min(byte, 0x1F) == byte.
+    _az_simd_block const matches = _az_simd_or(
+        _az_simd_or(_az_simd_equal(block, quote), _az_simd_equal(block, backslash)),
+        _az_simd_equal(_az_simd_min(block, last_control_char), block));
+
+    _az_simd_bitmask const mask = _az_simd_mask(matches);
+    if (mask != 0)
+    {
+      return index + _az_simd_find_first(mask);
+    }
+  }
+  return index;
+#else
+  (void)ptr;
+  (void)size;
+  return 0;
+#endif // _az_SIMD_BLOCK_SIZE
+}
+
+/**
+ * @brief Like #_az_simd_json_string_clean_prefix(), but also stops at the first byte of a multibyte
+ * UTF-8 sequence (0x80 or more), so that only ASCII bytes are skipped.
+ *
+ * @param[in] ptr The bytes to scan.
+ * @param[in] size The number of bytes available at \p ptr.
+ *
+ * @return The number of leading ASCII bytes that don't need special handling. If it is smaller than
+ * the number of bytes scanned in whole blocks, the byte at that index needs special handling.
+ */
+AZ_NODISCARD AZ_INLINE int32_t
+_az_simd_json_string_ascii_clean_prefix(uint8_t const* ptr, int32_t size)
+{
+#ifdef _az_SIMD_BLOCK_SIZE
+  _az_simd_block const quote = _az_simd_splat('"');
+  _az_simd_block const backslash = _az_simd_splat('\\');
+  _az_simd_block const space = _az_simd_splat(' ');
+  _az_simd_block const first_non_ascii_offset = _az_simd_splat(0x80 - ' ');
+
+  int32_t index = 0;
+  for (; index + _az_SIMD_BLOCK_SIZE <= size; index += _az_SIMD_BLOCK_SIZE)
+  {
+    _az_simd_block const block = _az_simd_load(ptr + index);
+
+    // Shifted down by a space, both the control characters (which wrap around) and the bytes of
+    // multibyte sequences end up at or above 0x80 - 0x20, so a single comparison finds both.
+    _az_simd_block const offset = _az_simd_sub(block, space);
+    _az_simd_block const matches = _az_simd_or(
+        _az_simd_or(_az_simd_equal(block, quote), _az_simd_equal(block, backslash)),
+        _az_simd_equal(_az_simd_max(offset, first_non_ascii_offset), offset));
+
+    _az_simd_bitmask const mask = _az_simd_mask(matches);
+    if (mask != 0)
+    {
+      return index + _az_simd_find_first(mask);
+    }
+  }
+  return index;
+#else
+  (void)ptr;
+  (void)size;
+  return 0;
+#endif // _az_SIMD_BLOCK_SIZE
+}
+
+/**
+ * @brief Finds the first byte which isn't JSON whitespace (` `, \\t, \\n, \\r).
+ *
+ * @param[in] ptr The bytes to scan.
+ * @param[in] size The number of bytes available at \p ptr.
+ *
+ * @return The number of leading whitespace bytes. If it is smaller than the number of bytes scanned
+ * in whole blocks, the byte at that index isn't whitespace.
+ */
+AZ_NODISCARD AZ_INLINE int32_t _az_simd_json_whitespace_prefix(uint8_t const* ptr, int32_t size)
+{
+#ifdef _az_SIMD_BLOCK_SIZE
+  _az_simd_block const space = _az_simd_splat(' ');
+  _az_simd_block const tab = _az_simd_splat('\t');
+  _az_simd_block const line_feed = _az_simd_splat('\n');
+  _az_simd_block const carriage_return = _az_simd_splat('\r');
+
+  int32_t index = 0;
+  for (; index + _az_SIMD_BLOCK_SIZE <= size; index += _az_SIMD_BLOCK_SIZE)
+  {
+    _az_simd_block const block = _az_simd_load(ptr + index);
+
+    _az_simd_block const matches = _az_simd_or(
+        _az_simd_or(_az_simd_equal(block, space), _az_simd_equal(block, tab)),
+        _az_simd_or(_az_simd_equal(block, line_feed), _az_simd_equal(block, carriage_return)));
+
+    _az_simd_bitmask const mask = _az_simd_mask(matches);
+    if (mask != _az_SIMD_ALL_MATCH)
+    {
+      return index + _az_simd_find_first(~mask & _az_SIMD_ALL_MATCH);
+    }
+  }
+  return index;
+#else
+  (void)ptr;
+  (void)size;
+  return 0;
+#endif // _az_SIMD_BLOCK_SIZE
+}
+
+/**
+ * @brief Finds the first occurrence of a byte.
+ *
+ * @param[in] ptr The bytes to scan.
+ * @param[in] size The number of bytes available at \p ptr.
+ * @param[in] byte The byte to find.
+ *
+ * @return The number of leading bytes that aren't \p byte. If it is smaller than the number of
+ * bytes scanned in whole blocks, the byte at that index is \p byte.
+ */
+AZ_NODISCARD AZ_INLINE int32_t _az_simd_find_byte(uint8_t const* ptr, int32_t size, uint8_t byte)
+{
+#ifdef _az_SIMD_BLOCK_SIZE
+  _az_simd_block const needle = _az_simd_splat(byte);
+
+  int32_t index = 0;
+  for (; index + _az_SIMD_BLOCK_SIZE <= size; index += _az_SIMD_BLOCK_SIZE)
+  {
+    _az_simd_bitmask const mask = _az_simd_mask(_az_simd_equal(_az_simd_load(ptr + index), needle));
+    if (mask != 0)
+    {
+      return index + _az_simd_find_first(mask);
+    }
+  }
+  return index;
+#else
+  (void)ptr;
+  (void)size;
+  (void)byte;
+  return 0;
+#endif // _az_SIMD_BLOCK_SIZE
+}
+
+#include <azure/core/_az_cfg_suffix.h>
+
+#endif // _az_SIMD_PRIVATE_H
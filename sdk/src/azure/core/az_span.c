@@ -10,11 +10,16 @@
 #include <azure/core/internal/az_span_internal.h>
 
 #include <ctype.h>
+#include <float.h>
 #include <math.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
 
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
 #include <azure/core/_az_cfg.h>
 
 // The maximum integer value that can be stored in a double without losing precision (2^53 - 1)
@@ -83,6 +88,24 @@ AZ_NODISCARD AZ_INLINE uint8_t _az_tolower(uint8_t value)
   return value;
 }
 
+// Lowercases the ASCII letters of 8 bytes at a time. Adding 0x3F (0x80 - 'A') to the low 7 bits of
+// a byte sets its high bit if it is at least 'A', and adding 0x25 (0x80 - 'Z' - 1), if it is
+// greater than 'Z'. Neither sum carries into the next byte, and bytes of 0x80 or more are left
+// unchanged.
+AZ_NODISCARD AZ_INLINE uint64_t _az_tolower_8_bytes(uint64_t value)
+{
+  uint64_t const ones = 0x0101010101010101ULL;
+  uint64_t const high_bits = ones * 0x80;
+  uint64_t const low_bits = value & ~high_bits;
+
+  uint64_t const at_least_a = low_bits + ones * (0x80 - 'A');
+  uint64_t const greater_than_z = low_bits + ones * (0x80 - 'Z' - 1);
+  uint64_t const is_upper = at_least_a & ~greater_than_z & ~value & high_bits;
+
+  // Shifting the high bit of each uppercase letter down to 0x20 gives the difference to lowercase.
+  return value | (is_upper >> 2);
+}
+
 AZ_NODISCARD bool az_span_is_content_equal_ignoring_case(az_span span1, az_span span2)
 {
   int32_t const size = az_span_size(span1);
@@ -90,9 +113,27 @@ AZ_NODISCARD bool az_span_is_content_equal_ignoring_case(az_span span1, az_span
   {
     return false;
   }
-  for (int32_t i = 0; i < size; ++i)
+
+  uint8_t const* const ptr1 = az_span_ptr(span1);
+  uint8_t const* const ptr2 = az_span_ptr(span2);
+  int32_t i = 0;
+
+  // Compare 8 bytes at a time, and only lowercase them when they aren't already equal.
+  for (; i + (int32_t)sizeof(uint64_t) <= size; i += (int32_t)sizeof(uint64_t))
+  {
+    uint64_t value1 = 0;
+    uint64_t value2 = 0;
+    memcpy(&value1, ptr1 + i, sizeof(value1));
+    memcpy(&value2, ptr2 + i, sizeof(value2));
+    if (value1 != value2 && _az_tolower_8_bytes(value1) != _az_tolower_8_bytes(value2))
+    {
+      return false;
+    }
+  }
+
+  for (; i < size; ++i)
   {
-    if (_az_tolower(az_span_ptr(span1)[i]) != _az_tolower(az_span_ptr(span2)[i]))
+    if (_az_tolower(ptr1[i]) != _az_tolower(ptr2[i]))
     {
       return false;
     }
@@ -354,6 +395,143 @@ static bool _is_valid_start_of_double(uint8_t first_byte)
   return result;
 }
 
+// Powers of ten which are exactly representable as a double.
+static const double _az_exact_powers_of_ten[] = {
+  1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+// The largest power of ten which is exactly representable as a double.
+#define _az_MAX_EXACT_POWER_OF_TEN 22
+
+// Larger exponents can't be made exact by moving zeros into a significand below 2^53, which has at
+// most 16 digits.
+#define _az_MAX_FAST_PATH_EXPONENT (_az_MAX_EXACT_POWER_OF_TEN + 15)
+
+/**
+ * @brief Parses the common forms of a decimal number, "[+|-][digits][.[digits]][e[+|-]digits]",
+ * whose significand fits in the 53 bits of a double, and whose power of ten is small enough to
+ * be exact.
+ *
+ * @details Since both the significand and the power of ten are exact, a single multiplication or
+ * division yields the correctly rounded result (Clinger's fast path). Anything else, including
+ * syntax that sscanf would accept or reject, is left for the caller's slower, general path.
+ *
+ * @return `true` if the entire \p source was parsed, otherwise `false`.
+ */
+AZ_NODISCARD static bool _az_span_try_atod_fast(az_span source, double* out_number)
+{
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD != 0
+  // With excess precision (i.e. the x87 FPU), the fast path would round twice.
+  (void)source;
+  (void)out_number;
+  return false;
+#else
+  uint8_t const* ptr = az_span_ptr(source);
+  int32_t const size = az_span_size(source);
+  int32_t index = 0;
+
+  bool const is_negative = ptr[0] == '-';
+  if (is_negative || ptr[0] == '+')
+  {
+    index++;
+  }
+
+  uint64_t significand = 0;
+  int32_t exponent = 0;
+  int32_t digit_count = 0;
+
+  for (; index < size && isdigit(ptr[index]); index++, digit_count++)
+  {
+    significand = significand * _az_NUMBER_OF_DECIMAL_VALUES + (uint64_t)(ptr[index] - '0');
+    if (significand > _az_MAX_SAFE_INTEGER)
+    {
+      return false;
+    }
+  }
+
+  if (index < size && ptr[index] == '.')
+  {
+    for (index++; index < size && isdigit(ptr[index]); index++, digit_count++)
+    {
+      significand = significand * _az_NUMBER_OF_DECIMAL_VALUES + (uint64_t)(ptr[index] - '0');
+      if (significand > _az_MAX_SAFE_INTEGER)
+      {
+        return false;
+      }
+      exponent--;
+    }
+  }
+
+  if (digit_count == 0)
+  {
+    return false;
+  }
+
+  if (index < size && (ptr[index] == 'e' || ptr[index] == 'E'))
+  {
+    index++;
+    bool const is_exponent_negative = index < size && ptr[index] == '-';
+    if (index < size && (is_exponent_negative || ptr[index] == '+'))
+    {
+      index++;
+    }
+
+    if (index >= size)
+    {
+      return false;
+    }
+
+    int32_t exponent_value = 0;
+    for (; index < size && isdigit(ptr[index]); index++)
+    {
+      if (exponent_value > _az_MAX_FAST_PATH_EXPONENT)
+      {
+        return false;
+      }
+      exponent_value = exponent_value * _az_NUMBER_OF_DECIMAL_VALUES + (ptr[index] - '0');
+    }
+    exponent += is_exponent_negative ? -exponent_value : exponent_value;
+  }
+
+  if (index != size)
+  {
+    return false;
+  }
+
+  double value = 0;
+  if (significand == 0)
+  {
+    value = 0;
+  }
+  else if (exponent < 0)
+  {
+    if (exponent < -_az_MAX_EXACT_POWER_OF_TEN)
+    {
+      return false;
+    }
+    value = (double)significand / _az_exact_powers_of_ten[-exponent];
+  }
+  else
+  {
+    // A larger power of ten can still be exact if the significand has room for the extra zeros,
+    // for example 12e30 is 12000000000e22.
+    for (; exponent > _az_MAX_EXACT_POWER_OF_TEN; exponent--)
+    {
+      significand *= _az_NUMBER_OF_DECIMAL_VALUES;
+      if (significand > _az_MAX_SAFE_INTEGER)
+      {
+        return false;
+      }
+    }
+    value = (double)significand * _az_exact_powers_of_ten[exponent];
+  }
+
+  *out_number = is_negative ? -value : value;
+  return true;
+#endif // FLT_EVAL_METHOD
+}
+
 // Disable the following warning just for this particular use case.
 // C4996: 'sscanf': This function or variable may be unsafe. Consider using sscanf_s instead.
 // C4710: 'sscanf': function not inlined
@@ -380,6 +558,11 @@ AZ_NODISCARD az_result az_span_atod(az_span source, double* out_number)
     return AZ_ERROR_UNEXPECTED_CHAR;
   }
 
+  if (_az_span_try_atod_fast(source, out_number))
+  {
+    return AZ_OK;
+  }
+
   // Stack based string to allow thread-safe mutation.
   // The length is 8 to allow space for the null-terminating character.
   // NOLINTNEXTLINE(readability-magic-numbers,  cppcoreguidelines-avoid-magic-numbers)
@@ -402,30 +585,174 @@ AZ_NODISCARD az_result az_span_atod(az_span source, double* out_number)
 #pragma warning(pop)
 #endif
 
+// Returns the position in `target` of its critical factorization, as defined by the Two-Way
+// algorithm, and sets `out_period` to the period of the suffix starting there.
+// It is the later of the maximal suffixes of `target` for the byte order and for its reverse.
+static int32_t _az_span_find_critical_factorization(
+    uint8_t const* target_ptr,
+    int32_t target_size,
+    int32_t* out_period)
+{
+  int32_t suffix_start[2] = { -1, -1 };
+  int32_t period[2] = { 1, 1 };
+
+  for (int32_t order = 0; order < 2; order++)
+  {
+    // The maximal suffix starts after `start` and `target_ptr[start + 1 ... j + k]` is being
+    // compared with the bytes `period` positions before them.
+    int32_t start = -1;
+    int32_t j = 0;
+    int32_t k = 1;
+    int32_t p = 1;
+
+    while (j + k < target_size)
+    {
+      uint8_t const a = target_ptr[j + k];
+      uint8_t const b = target_ptr[start + k];
+      if (a == b)
+      {
+        if (k == p)
+        {
+          j += p;
+          k = 1;
+        }
+        else
+        {
+          k++;
+        }
+      }
+      else if ((order == 0) == (a < b))
+      {
+        j += k;
+        k = 1;
+        p = j - start;
+      }
+      else
+      {
+        start = j;
+        j++;
+        k = 1;
+        p = 1;
+      }
+    }
+
+    suffix_start[order] = start;
+    period[order] = p;
+  }
+
+  int32_t const later = suffix_start[1] > suffix_start[0] ? 1 : 0;
+  *out_period = period[later];
+  return suffix_start[later] + 1;
+}
+
+// Finds `target` in `source` with the Two-Way algorithm by Crochemore and Perrin, which compares
+// each byte of `source` a bounded number of times and only needs a few integers of state.
+// `target` is split at its critical factorization: the right part is compared forwards, and only
+// when it matches, the left part is compared backwards. On a mismatch, the comparison position
+// tells how far `target` can be shifted without skipping any occurrence.
+static int32_t _az_span_find_two_way(
+    uint8_t const* source_ptr,
+    int32_t source_size,
+    uint8_t const* target_ptr,
+    int32_t target_size)
+{
+  int32_t period = 0;
+  int32_t const split = _az_span_find_critical_factorization(target_ptr, target_size, &period);
+  int32_t const last_position = source_size - target_size;
+
+  if (memcmp(target_ptr, target_ptr + period, (size_t)split) == 0)
+  {
+    // `target` is periodic: after a full match of the right part, the first `memory` bytes of
+    // `target` are known to match the next position as well, and are not compared again.
+    int32_t memory = 0;
+    for (int32_t position = 0; position <= last_position;)
+    {
+      int32_t i = split > memory ? split : memory;
+      while (i < target_size && target_ptr[i] == source_ptr[position + i])
+      {
+        i++;
+      }
+
+      if (i < target_size)
+      {
+        position += i - split + 1;
+        memory = 0;
+        continue;
+      }
+
+      i = split - 1;
+      while (i >= memory && target_ptr[i] == source_ptr[position + i])
+      {
+        i--;
+      }
+
+      if (i < memory)
+      {
+        return position;
+      }
+
+      position += period;
+      memory = target_size - period;
+    }
+  }
+  else
+  {
+    // The left and right parts don't overlap with any shifted copy of `target`, so a full match
+    // of the right part followed by a mismatch allows skipping past the larger part.
+    int32_t const shift = (split > target_size - split ? split : target_size - split) + 1;
+    for (int32_t position = 0; position <= last_position;)
+    {
+      int32_t i = split;
+      while (i < target_size && target_ptr[i] == source_ptr[position + i])
+      {
+        i++;
+      }
+
+      if (i < target_size)
+      {
+        position += i - split + 1;
+        continue;
+      }
+
+      i = split - 1;
+      while (i >= 0 && target_ptr[i] == source_ptr[position + i])
+      {
+        i--;
+      }
+
+      if (i < 0)
+      {
+        return position;
+      }
+
+      position += shift;
+    }
+  }
+
+  return -1;
+}
+
 AZ_NODISCARD int32_t az_span_find(az_span source, az_span target)
 {
-  /* This function implements the Naive string-search algorithm.
-   * The rationale to use this algorithm instead of other potentially more
-   * performing ones (Rabin-Karp, e.g.) is due to no additional space needed.
+  /* For targets shorter than _az_SPAN_FIND_TWO_WAY_MIN_SIZE, this function filters the candidate
+   * positions before comparing the whole `target`, which needs no additional space.
    * The logic:
-   * 1. The function will look into each position of `source` if it contains the same value as the
-   * first position of `target`.
-   * 2. If it does, it could be that the next bytes in `source` are a perfect match of the remaining
-   * bytes of `target`.
-   * 3. Being so, it loops through the remaining bytes of `target` and see if they match exactly the
-   * next bytes of `source`.
-   * 4. If the loop gets to the end (all bytes of `target` are evaluated), it means `target` indeed
-   * occurs in that position of `source`.
-   * 5. If the loop gets interrupted before cruising through the entire `target`, the function must
-   * go back to step 1. from  the next position in `source`.
-   *   The loop in 5. gets interrupted if
-   *     - a byte in `target` is different than `source`, in the expected corresponding position;
-   *     - the loop has reached the end of `source` (and there are still remaining bytes of `target`
-   *         to be checked).
+   * 1. memchr() finds the next position in `source` which contains the first byte of `target`.
+   * Most C libraries scan for it several bytes at a time.
+   * 2. If the byte of `source` where the last byte of `target` would be also matches, the bytes in
+   * between are compared with memcmp(). Checking the last byte first rejects most of the positions
+   * where only a common first byte (such as '$' or '/' in MQTT topics) matches.
+   * 3. If they don't match, the function goes back to step 1. from the next position in `source`.
+   * Only the positions where all of `target` still fits within `source` are searched.
+   *
+   * In the worst case (such as finding "aa...ab" in "aaaa...a"), every position is compared with
+   * all of `target`, which takes O(n*m) time. That's bounded for short targets, but longer ones
+   * are found with the Two-Way algorithm instead, which takes O(n+m) time and, like this loop,
+   * only a constant amount of additional space.
    */
 
-  int32_t source_size = az_span_size(source);
-  int32_t target_size = az_span_size(target);
+  int32_t const source_size = az_span_size(source);
+  int32_t const target_size = az_span_size(target);
   const int32_t target_not_found = -1;
 
   if (target_size == 0)
@@ -438,37 +765,36 @@ AZ_NODISCARD int32_t az_span_find(az_span source, az_span target)
     return target_not_found;
   }
 
-  uint8_t* source_ptr = az_span_ptr(source);
-  uint8_t* target_ptr = az_span_ptr(target);
+  uint8_t const* const source_ptr = az_span_ptr(source);
+  uint8_t const* const target_ptr = az_span_ptr(target);
 
-  // This loop traverses `source` position by position (step 1.)
-  for (int32_t i = 0; i < (source_size - target_size + 1); i++)
+  if (target_size >= _az_SPAN_FIND_TWO_WAY_MIN_SIZE)
   {
-    // This is the check done in step 1. above.
-    if (source_ptr[i] == target_ptr[0])
-    {
-      // The condition in step 2. has been satisfied.
-      int32_t j = 1;
-      // This is the loop defined in step 3.
-      // The loop must be broken if it reaches the ends of `target` (step 3.) OR `source`
-      // (step 5.).
-      for (; j < target_size && (i + j) < source_size; j++)
-      {
-        // Condition defined in step 5.
-        if (source_ptr[i + j] != target_ptr[j])
-        {
-          break;
-        }
-      }
+    return _az_span_find_two_way(source_ptr, source_size, target_ptr, target_size);
+  }
 
-      if (j == target_size)
-      {
-        // All bytes in `target` have been checked and matched the corresponding bytes in `source`
-        // (from the start point `i`), so this is indeed an instance of `target` in that position
-        // of `source` (step 4.).
+  uint8_t const first_byte = target_ptr[0];
+  uint8_t const last_byte = target_ptr[target_size - 1];
 
-        return i;
-      }
+  // The last position of `source` where `target` could start.
+  int32_t const last_position = source_size - target_size;
+
+  for (int32_t i = 0; i <= last_position; i++)
+  {
+    // Step 1.
+    uint8_t const* const candidate
+        = (uint8_t const*)memchr(source_ptr + i, first_byte, (size_t)(last_position - i + 1));
+    if (candidate == NULL)
+    {
+      break;
+    }
+    i = (int32_t)(candidate - source_ptr);
+
+    // Step 2.
+    if (source_ptr[i + target_size - 1] == last_byte
+        && memcmp(source_ptr + i + 1, target_ptr + 1, (size_t)(target_size - 1)) == 0)
+    {
+      return i;
     }
   }
 
@@ -563,36 +889,125 @@ AZ_INLINE uint8_t _az_decimal_to_ascii(uint8_t d)
   return (uint8_t)((uint32_t)('0' + d) & (uint8_t)UINT8_MAX);
 }
 
-static AZ_NODISCARD az_result _az_span_builder_append_uint64(az_span* ref_span, uint64_t n)
+// Every number from 00 to 99, so that two digits are written for each division.
+static const char _az_digit_pairs[] = //
+  "0001020304050607080910111213141516171819"
+  "2021222324252627282930313233343536373839"
+  "4041424344454647484950515253545556575859"
+  "6061626364656667686970717273747576777879"
+  "8081828384858687888990919293949596979899";
+
+static const uint64_t _az_uint64_powers_of_ten[] = {
+  1ULL,
+  10ULL,
+  100ULL,
+  1000ULL,
+  10000ULL,
+  100000ULL,
+  1000000ULL,
+  10000000ULL,
+  100000000ULL,
+  1000000000ULL,
+  10000000000ULL,
+  100000000000ULL,
+  1000000000000ULL,
+  10000000000000ULL,
+  100000000000000ULL,
+  1000000000000000ULL,
+  10000000000000000ULL,
+  100000000000000000ULL,
+  1000000000000000000ULL,
+  _az_SMALLEST_20_DIGIT_NUMBER,
+};
+
+// The largest power of ten that fits in a uint32_t, and splits a uint64_t into 8 digit chunks.
+#define _az_EIGHT_DIGIT_DIVISOR 100000000U
+
+// Returns the number of bits needed to represent the value, which must not be 0.
+AZ_NODISCARD AZ_INLINE int32_t _az_bit_length(uint64_t value)
 {
-  _az_RETURN_IF_NOT_ENOUGH_SIZE(*ref_span, 1);
-
-  if (n == 0)
+#if defined(__GNUC__) || defined(__clang__)
+  return 64 - __builtin_clzll(value);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+  unsigned long index = 0;
+  _BitScanReverse64(&index, value);
+  return (int32_t)index + 1;
+#else
+  int32_t length = 0;
+  while (value != 0)
   {
-    *ref_span = az_span_copy_u8(*ref_span, '0');
-    return AZ_OK;
+    value >>= 1;
+    length++;
   }
+  return length;
+#endif
+}
+
+AZ_NODISCARD int32_t _az_span_u64toa_size(uint64_t value)
+{
+  // Setting the lowest bit doesn't change the number of digits of any value, since 10^n - 1 is
+  // always odd, but it means 0 is counted as 1 digit.
+  value |= 1;
+
+  // Multiplying the bit length by log10(2) ~= 1233 / 4096 gives either the number of digits, or one
+  // less, which a single comparison corrects.
+  int32_t const estimate = (_az_bit_length(value) * 1233) >> 12;
+  return estimate + (value >= _az_uint64_powers_of_ten[estimate] ? 1 : 0);
+}
 
-  uint64_t div = _az_SMALLEST_20_DIGIT_NUMBER;
-  uint64_t nn = n;
-  int32_t digit_count = _az_MAX_SIZE_FOR_UINT64;
-  while (nn / div == 0)
+// Writes the digits of n backwards, two at a time, ending right before the end pointer.
+static void _az_write_uint32_digits(uint8_t* end, uint32_t n)
+{
+  while (n >= 100)
   {
-    div /= _az_NUMBER_OF_DECIMAL_VALUES;
-    digit_count--;
+    uint32_t const pair = (n % 100) * 2;
+    n /= 100;
+    *--end = (uint8_t)_az_digit_pairs[pair + 1];
+    *--end = (uint8_t)_az_digit_pairs[pair];
   }
 
-  _az_RETURN_IF_NOT_ENOUGH_SIZE(*ref_span, digit_count);
+  if (n >= _az_NUMBER_OF_DECIMAL_VALUES)
+  {
+    *--end = (uint8_t)_az_digit_pairs[n * 2 + 1];
+    *--end = (uint8_t)_az_digit_pairs[n * 2];
+  }
+  else
+  {
+    *--end = _az_decimal_to_ascii((uint8_t)n);
+  }
+}
 
-  while (div > 1)
+static void _az_write_uint64_digits(uint8_t* end, uint64_t n)
+{
+  // 64-bit division is expensive on 32-bit targets, so only use it to split off 8 digits at a time
+  // until the rest fits in 32 bits.
+  while (n > UINT32_MAX)
   {
-    uint8_t value_to_append = _az_decimal_to_ascii((uint8_t)(nn / div));
-    *ref_span = az_span_copy_u8(*ref_span, value_to_append);
-    nn %= div;
-    div /= _az_NUMBER_OF_DECIMAL_VALUES;
+    uint32_t chunk = (uint32_t)(n % _az_EIGHT_DIGIT_DIVISOR);
+    n /= _az_EIGHT_DIGIT_DIVISOR;
+
+    // Unlike the leading digits, the chunk includes its leading zeros.
+    for (int32_t i = 0; i < 4; i++)
+    {
+      uint32_t const pair = (chunk % 100) * 2;
+      chunk /= 100;
+      *--end = (uint8_t)_az_digit_pairs[pair + 1];
+      *--end = (uint8_t)_az_digit_pairs[pair];
+    }
   }
-  uint8_t value_to_append = _az_decimal_to_ascii((uint8_t)nn);
-  *ref_span = az_span_copy_u8(*ref_span, value_to_append);
+
+  _az_write_uint32_digits(end, (uint32_t)n);
+}
+
+static AZ_NODISCARD az_result _az_span_builder_append_uint64(az_span* ref_span, uint64_t n)
+{
+  int32_t const digit_count = _az_span_u64toa_size(n);
+  _az_RETURN_IF_NOT_ENOUGH_SIZE(*ref_span, digit_count);
+
+  uint8_t* const ptr = az_span_ptr(*ref_span);
+  _az_write_uint64_digits(ptr + digit_count, n);
+
+  *ref_span = az_span_create(ptr + digit_count, az_span_size(*ref_span) - digit_count);
   return AZ_OK;
 }
 
@@ -626,38 +1041,13 @@ AZ_NODISCARD az_result az_span_i64toa(az_span destination, int64_t source, az_sp
 static AZ_NODISCARD az_result
 _az_span_builder_append_u32toa(az_span destination, uint32_t n, az_span* out_span)
 {
-  _az_RETURN_IF_NOT_ENOUGH_SIZE(destination, 1);
-
-  if (n == 0)
-  {
-    *out_span = az_span_copy_u8(destination, '0');
-    return AZ_OK;
-  }
-
-  uint32_t div = _az_SMALLEST_10_DIGIT_NUMBER;
-  uint32_t nn = n;
-  int32_t digit_count = _az_MAX_SIZE_FOR_UINT32;
-  while (nn / div == 0)
-  {
-    div /= _az_NUMBER_OF_DECIMAL_VALUES;
-    digit_count--;
-  }
-
+  int32_t const digit_count = _az_span_u64toa_size(n);
   _az_RETURN_IF_NOT_ENOUGH_SIZE(destination, digit_count);
 
-  *out_span = destination;
-
-  while (div > 1)
-  {
-    uint8_t value_to_append = _az_decimal_to_ascii((uint8_t)(nn / div));
-    *out_span = az_span_copy_u8(*out_span, value_to_append);
-
-    nn %= div;
-    div /= _az_NUMBER_OF_DECIMAL_VALUES;
-  }
+  uint8_t* const ptr = az_span_ptr(destination);
+  _az_write_uint32_digits(ptr + digit_count, n);
 
-  uint8_t value_to_append = _az_decimal_to_ascii((uint8_t)nn);
-  *out_span = az_span_copy_u8(*out_span, value_to_append);
+  *out_span = az_span_create(ptr + digit_count, az_span_size(destination) - digit_count);
   return AZ_OK;
 }
 
@@ -787,6 +1177,423 @@ az_span_dtoa(az_span destination, double source, int32_t fractional_digits, az_s
   return _az_span_builder_append_uint64(out_span, fractional_part);
 }
 
+// The shortest representation of a double is found with the Grisu2 algorithm, by Florian Loitsch,
+// "Printing Floating-Point Numbers Quickly and Accurately with Integers", PLDI 2010. It only needs
+// 64-bit integer arithmetic and a small table of cached powers of ten. The digits it generates
+// always round-trip, and are the shortest possible for almost all values.
+
+// A floating-point number f * 2^e, with a 64-bit significand.
+typedef struct
+{
+  uint64_t f;
+  int32_t e;
+} _az_diy_fp;
+
+// A cached power of ten, 10^k ~= f * 2^e, with a normalized significand, rounded to nearest.
+typedef struct
+{
+  uint64_t f;
+  int16_t e;
+  int16_t k;
+} _az_cached_power;
+
+// Powers of ten from 10^-300 to 10^324, in steps of 8, which is enough to bring any double into the
+// [_az_GRISU_ALPHA, _az_GRISU_GAMMA] binary exponent range.
+static const _az_cached_power _az_cached_powers_of_ten[] = {
+  { 0xAB70FE17C79AC6CA, -1060, -300 },
+  { 0xFF77B1FCBEBCDC4F, -1034, -292 },
+  { 0xBE5691EF416BD60C, -1007, -284 },
+  { 0x8DD01FAD907FFC3C, -980, -276 },
+  { 0xD3515C2831559A83, -954, -268 },
+  { 0x9D71AC8FADA6C9B5, -927, -260 },
+  { 0xEA9C227723EE8BCB, -901, -252 },
+  { 0xAECC49914078536D, -874, -244 },
+  { 0x823C12795DB6CE57, -847, -236 },
+  { 0xC21094364DFB5637, -821, -228 },
+  { 0x9096EA6F3848984F, -794, -220 },
+  { 0xD77485CB25823AC7, -768, -212 },
+  { 0xA086CFCD97BF97F4, -741, -204 },
+  { 0xEF340A98172AACE5, -715, -196 },
+  { 0xB23867FB2A35B28E, -688, -188 },
+  { 0x84C8D4DFD2C63F3B, -661, -180 },
+  { 0xC5DD44271AD3CDBA, -635, -172 },
+  { 0x936B9FCEBB25C996, -608, -164 },
+  { 0xDBAC6C247D62A584, -582, -156 },
+  { 0xA3AB66580D5FDAF6, -555, -148 },
+  { 0xF3E2F893DEC3F126, -529, -140 },
+  { 0xB5B5ADA8AAFF80B8, -502, -132 },
+  { 0x87625F056C7C4A8B, -475, -124 },
+  { 0xC9BCFF6034C13053, -449, -116 },
+  { 0x964E858C91BA2655, -422, -108 },
+  { 0xDFF9772470297EBD, -396, -100 },
+  { 0xA6DFBD9FB8E5B88F, -369, -92 },
+  { 0xF8A95FCF88747D94, -343, -84 },
+  { 0xB94470938FA89BCF, -316, -76 },
+  { 0x8A08F0F8BF0F156B, -289, -68 },
+  { 0xCDB02555653131B6, -263, -60 },
+  { 0x993FE2C6D07B7FAC, -236, -52 },
+  { 0xE45C10C42A2B3B06, -210, -44 },
+  { 0xAA242499697392D3, -183, -36 },
+  { 0xFD87B5F28300CA0E, -157, -28 },
+  { 0xBCE5086492111AEB, -130, -20 },
+  { 0x8CBCCC096F5088CC, -103, -12 },
+  { 0xD1B71758E219652C, -77, -4 },
+  { 0x9C40000000000000, -50, 4 },
+  { 0xE8D4A51000000000, -24, 12 },
+  { 0xAD78EBC5AC620000, 3, 20 },
+  { 0x813F3978F8940984, 30, 28 },
+  { 0xC097CE7BC90715B3, 56, 36 },
+  { 0x8F7E32CE7BEA5C70, 83, 44 },
+  { 0xD5D238A4ABE98068, 109, 52 },
+  { 0x9F4F2726179A2245, 136, 60 },
+  { 0xED63A231D4C4FB27, 162, 68 },
+  { 0xB0DE65388CC8ADA8, 189, 76 },
+  { 0x83C7088E1AAB65DB, 216, 84 },
+  { 0xC45D1DF942711D9A, 242, 92 },
+  { 0x924D692CA61BE758, 269, 100 },
+  { 0xDA01EE641A708DEA, 295, 108 },
+  { 0xA26DA3999AEF774A, 322, 116 },
+  { 0xF209787BB47D6B85, 348, 124 },
+  { 0xB454E4A179DD1877, 375, 132 },
+  { 0x865B86925B9BC5C2, 402, 140 },
+  { 0xC83553C5C8965D3D, 428, 148 },
+  { 0x952AB45CFA97A0B3, 455, 156 },
+  { 0xDE469FBD99A05FE3, 481, 164 },
+  { 0xA59BC234DB398C25, 508, 172 },
+  { 0xF6C69A72A3989F5C, 534, 180 },
+  { 0xB7DCBF5354E9BECE, 561, 188 },
+  { 0x88FCF317F22241E2, 588, 196 },
+  { 0xCC20CE9BD35C78A5, 614, 204 },
+  { 0x98165AF37B2153DF, 641, 212 },
+  { 0xE2A0B5DC971F303A, 667, 220 },
+  { 0xA8D9D1535CE3B396, 694, 228 },
+  { 0xFB9B7CD9A4A7443C, 720, 236 },
+  { 0xBB764C4CA7A44410, 747, 244 },
+  { 0x8BAB8EEFB6409C1A, 774, 252 },
+  { 0xD01FEF10A657842C, 800, 260 },
+  { 0x9B10A4E5E9913129, 827, 268 },
+  { 0xE7109BFBA19C0C9D, 853, 276 },
+  { 0xAC2820D9623BF429, 880, 284 },
+  { 0x80444B5E7AA7CF85, 907, 292 },
+  { 0xBF21E44003ACDD2D, 933, 300 },
+  { 0x8E679C2F5E44FF8F, 960, 308 },
+  { 0xD433179D9C8CB841, 986, 316 },
+  { 0x9E19DB92B4E31BA9, 1013, 324 },
+};
+
+#define _az_CACHED_POWERS_MIN_DECIMAL_EXPONENT (-300)
+#define _az_CACHED_POWERS_DECIMAL_EXPONENT_STEP 8
+
+// The target range of binary exponents for the scaled value, so that its integer part fits in 32
+// bits and its fractional part fits in 60 bits.
+#define _az_GRISU_ALPHA (-60)
+#define _az_GRISU_GAMMA (-32)
+
+// The IEEE 754 double layout: 52 bits of stored significand, with an exponent bias of 1023.
+#define _az_DOUBLE_SIGNIFICAND_BITS 52
+#define _az_DOUBLE_EXPONENT_BIAS (1023 + _az_DOUBLE_SIGNIFICAND_BITS)
+#define _az_DOUBLE_HIDDEN_BIT ((uint64_t)1 << _az_DOUBLE_SIGNIFICAND_BITS)
+
+// 17 significant digits are always enough to round-trip a double.
+#define _az_MAX_SHORTEST_DOUBLE_DIGITS 17
+
+AZ_NODISCARD AZ_INLINE _az_diy_fp _az_diy_fp_normalize(_az_diy_fp x)
+{
+  while ((x.f >> 63) == 0)
+  {
+    x.f <<= 1;
+    x.e--;
+  }
+  return x;
+}
+
+// Returns the upper 64 bits of the product of the two significands, rounded.
+AZ_NODISCARD static _az_diy_fp _az_diy_fp_multiply(_az_diy_fp x, _az_diy_fp y)
+{
+  uint64_t const x_lo = x.f & 0xFFFFFFFF;
+  uint64_t const x_hi = x.f >> 32;
+  uint64_t const y_lo = y.f & 0xFFFFFFFF;
+  uint64_t const y_hi = y.f >> 32;
+
+  uint64_t const lo_lo = x_lo * y_lo;
+  uint64_t const lo_hi = x_lo * y_hi;
+  uint64_t const hi_lo = x_hi * y_lo;
+  uint64_t const hi_hi = x_hi * y_hi;
+
+  uint64_t middle = (lo_lo >> 32) + (lo_hi & 0xFFFFFFFF) + (hi_lo & 0xFFFFFFFF);
+  middle += (uint64_t)1 << 31; // Round the lower half.
+
+  return (_az_diy_fp){
+    .f = hi_hi + (lo_hi >> 32) + (hi_lo >> 32) + (middle >> 32),
+    .e = x.e + y.e + 64,
+  };
+}
+
+AZ_NODISCARD static _az_cached_power _az_get_cached_power_for_binary_exponent(int32_t e)
+{
+  // k = ceil((alpha - e - 1) * log10(2)), where 78913 / 2^18 ~= log10(2).
+  int32_t const f = _az_GRISU_ALPHA - e - 1;
+  int32_t const k = (f * 78913) / (1 << 18) + (f > 0 ? 1 : 0);
+
+  int32_t const index = (-_az_CACHED_POWERS_MIN_DECIMAL_EXPONENT + k
+                         + (_az_CACHED_POWERS_DECIMAL_EXPONENT_STEP - 1))
+      / _az_CACHED_POWERS_DECIMAL_EXPONENT_STEP;
+
+  return _az_cached_powers_of_ten[index];
+}
+
+// Moves the last digit closer to the exact value w, as long as it stays within the rounding
+// interval.
+static void _az_grisu2_round(
+    uint8_t* last_digit,
+    uint64_t distance,
+    uint64_t delta,
+    uint64_t rest,
+    uint64_t ten_k)
+{
+  while (rest < distance && delta - rest >= ten_k
+         && (rest + ten_k < distance || distance - rest > rest + ten_k - distance))
+  {
+    (*last_digit)--;
+    rest += ten_k;
+  }
+}
+
+static void _az_grisu2_generate_digits(
+    uint8_t* digits,
+    int32_t* out_length,
+    int32_t* ref_decimal_exponent,
+    _az_diy_fp m_minus,
+    _az_diy_fp w,
+    _az_diy_fp m_plus)
+{
+  uint64_t delta = m_plus.f - m_minus.f;
+  uint64_t distance = m_plus.f - w.f;
+
+  // Split m_plus into its integer part p1, and its fractional part p2.
+  int32_t const shift = -m_plus.e;
+  uint64_t const one = (uint64_t)1 << shift;
+  uint32_t p1 = (uint32_t)(m_plus.f >> shift);
+  uint64_t p2 = m_plus.f & (one - 1);
+
+  int32_t length = 0;
+
+  uint32_t power_of_ten = _az_SMALLEST_10_DIGIT_NUMBER;
+  int32_t remaining_digits = _az_MAX_SIZE_FOR_UINT32;
+  while (remaining_digits > 1 && p1 < power_of_ten)
+  {
+    power_of_ten /= _az_NUMBER_OF_DECIMAL_VALUES;
+    remaining_digits--;
+  }
+
+  while (remaining_digits > 0)
+  {
+    digits[length++] = _az_decimal_to_ascii((uint8_t)(p1 / power_of_ten));
+    p1 %= power_of_ten;
+    remaining_digits--;
+
+    uint64_t const rest = ((uint64_t)p1 << shift) + p2;
+    if (rest <= delta)
+    {
+      *ref_decimal_exponent += remaining_digits;
+      _az_grisu2_round(
+          &digits[length - 1], distance, delta, rest, (uint64_t)power_of_ten << shift);
+      *out_length = length;
+      return;
+    }
+
+    power_of_ten /= _az_NUMBER_OF_DECIMAL_VALUES;
+  }
+
+  // The integer part wasn't enough, so continue with the digits of the fractional part.
+  while (true)
+  {
+    p2 *= _az_NUMBER_OF_DECIMAL_VALUES;
+    digits[length++] = _az_decimal_to_ascii((uint8_t)(p2 >> shift));
+    p2 &= one - 1;
+    (*ref_decimal_exponent)--;
+
+    delta *= _az_NUMBER_OF_DECIMAL_VALUES;
+    distance *= _az_NUMBER_OF_DECIMAL_VALUES;
+
+    if (p2 <= delta)
+    {
+      break;
+    }
+  }
+
+  _az_grisu2_round(&digits[length - 1], distance, delta, p2, one);
+  *out_length = length;
+}
+
+// Generates the shortest digits, such that digits * 10^decimal_exponent round-trips to the positive
+// and finite value.
+static void _az_grisu2(
+    double value,
+    uint8_t digits[_az_MAX_SHORTEST_DOUBLE_DIGITS],
+    int32_t* out_length,
+    int32_t* out_decimal_exponent)
+{
+  uint64_t bits = 0;
+  memcpy(&bits, &value, sizeof(bits));
+
+  uint64_t const biased_exponent = bits >> _az_DOUBLE_SIGNIFICAND_BITS;
+  uint64_t const significand = bits & (_az_DOUBLE_HIDDEN_BIT - 1);
+
+  // Subnormal numbers have no hidden bit and the same exponent as the smallest normal numbers.
+  _az_diy_fp const v = biased_exponent == 0
+      ? (_az_diy_fp){ .f = significand, .e = 1 - _az_DOUBLE_EXPONENT_BIAS }
+      : (_az_diy_fp){ .f = significand + _az_DOUBLE_HIDDEN_BIT,
+                      .e = (int32_t)biased_exponent - _az_DOUBLE_EXPONENT_BIAS };
+
+  // The boundaries are halfway to the neighboring doubles. The lower neighbor is closer when v is a
+  // power of two, since it then has a smaller exponent.
+  bool const is_lower_boundary_closer = significand == 0 && biased_exponent > 1;
+
+  _az_diy_fp const m_plus = _az_diy_fp_normalize((_az_diy_fp){ .f = 2 * v.f + 1, .e = v.e - 1 });
+  _az_diy_fp m_minus = is_lower_boundary_closer
+      ? (_az_diy_fp){ .f = 4 * v.f - 1, .e = v.e - 2 }
+      : (_az_diy_fp){ .f = 2 * v.f - 1, .e = v.e - 1 };
+  m_minus.f <<= m_minus.e - m_plus.e;
+  m_minus.e = m_plus.e;
+
+  _az_cached_power const cached = _az_get_cached_power_for_binary_exponent(m_plus.e);
+  _az_diy_fp const c_minus_k = { .f = cached.f, .e = cached.e };
+
+  _az_diy_fp const w = _az_diy_fp_multiply(_az_diy_fp_normalize(v), c_minus_k);
+  _az_diy_fp w_minus = _az_diy_fp_multiply(m_minus, c_minus_k);
+  _az_diy_fp w_plus = _az_diy_fp_multiply(m_plus, c_minus_k);
+
+  // Shrink the interval by one unit on each side, to account for the imprecision of the cached
+  // power and the multiplication, so that every digit within the interval round-trips.
+  w_minus.f++;
+  w_plus.f--;
+
+  *out_decimal_exponent = -cached.k;
+  _az_grisu2_generate_digits(digits, out_length, out_decimal_exponent, w_minus, w, w_plus);
+}
+
+// Beyond these exponents, the shortest digits are written in scientific notation (i.e. 1e+21 and
+// 1e-7), the same way JavaScript formats numbers.
+#define _az_MAX_PLAIN_DECIMAL_POINT 21
+#define _az_MIN_PLAIN_DECIMAL_POINT (-5)
+
+AZ_NODISCARD az_result az_span_dtoa_shortest(az_span destination, double source, az_span* out_span)
+{
+  _az_PRECONDITION_VALID_SPAN(destination, 0, false);
+  // Inputs that are either positive or negative infinity, or not a number, are not supported.
+  _az_PRECONDITION(_az_isfinite(source));
+  _az_PRECONDITION_NOT_NULL(out_span);
+
+  *out_span = destination;
+
+  // The input is either positive or negative infinity, or not a number.
+  if (!_az_isfinite(source))
+  {
+    return AZ_ERROR_NOT_SUPPORTED;
+  }
+
+  bool const is_negative = signbit(source);
+  if (is_negative)
+  {
+    source = -source;
+  }
+
+  uint8_t digits[_az_MAX_SHORTEST_DOUBLE_DIGITS] = { 0 };
+  int32_t length = 1;
+  int32_t decimal_exponent = 0;
+
+  // The sign was already removed, so this only matches zero.
+  if (source <= 0)
+  {
+    digits[0] = '0';
+  }
+  else
+  {
+    _az_grisu2(source, digits, &length, &decimal_exponent);
+  }
+
+  // The value is 0.digits * 10^decimal_point.
+  int32_t const decimal_point = length + decimal_exponent;
+
+  // Compute the exact size first, so nothing is written if the destination is too small.
+  int32_t required_size = length + (is_negative ? 1 : 0);
+  int32_t exponent = 0;
+  if (length <= decimal_point && decimal_point <= _az_MAX_PLAIN_DECIMAL_POINT)
+  {
+    // Trailing zeros: 1e20 becomes 100000000000000000000
+    required_size += decimal_point - length;
+  }
+  else if (0 < decimal_point && decimal_point <= _az_MAX_PLAIN_DECIMAL_POINT)
+  {
+    // Decimal point within the digits: 123.45
+    required_size += 1;
+  }
+  else if (_az_MIN_PLAIN_DECIMAL_POINT <= decimal_point && decimal_point <= 0)
+  {
+    // Leading zeros: 0.00012345
+    required_size += 2 - decimal_point;
+  }
+  else
+  {
+    // Scientific notation: 1.2345e-7
+    exponent = decimal_point - 1;
+    int32_t const exponent_magnitude = exponent < 0 ? -exponent : exponent;
+    int32_t const exponent_digits
+        = exponent_magnitude >= 100 ? 3 : (exponent_magnitude >= 10 ? 2 : 1);
+    required_size += (length > 1 ? 1 : 0) + 2 + exponent_digits;
+  }
+
+  _az_RETURN_IF_NOT_ENOUGH_SIZE(destination, required_size);
+
+  if (is_negative)
+  {
+    *out_span = az_span_copy_u8(*out_span, '-');
+  }
+
+  az_span const digits_span = az_span_create(digits, length);
+
+  if (length <= decimal_point && decimal_point <= _az_MAX_PLAIN_DECIMAL_POINT)
+  {
+    *out_span = az_span_copy(*out_span, digits_span);
+    for (int32_t z = length; z < decimal_point; z++)
+    {
+      *out_span = az_span_copy_u8(*out_span, '0');
+    }
+  }
+  else if (0 < decimal_point && decimal_point <= _az_MAX_PLAIN_DECIMAL_POINT)
+  {
+    *out_span = az_span_copy(*out_span, az_span_slice(digits_span, 0, decimal_point));
+    *out_span = az_span_copy_u8(*out_span, '.');
+    *out_span = az_span_copy(*out_span, az_span_slice_to_end(digits_span, decimal_point));
+  }
+  else if (_az_MIN_PLAIN_DECIMAL_POINT <= decimal_point && decimal_point <= 0)
+  {
+    *out_span = az_span_copy_u8(*out_span, '0');
+    *out_span = az_span_copy_u8(*out_span, '.');
+    for (int32_t z = decimal_point; z < 0; z++)
+    {
+      *out_span = az_span_copy_u8(*out_span, '0');
+    }
+    *out_span = az_span_copy(*out_span, digits_span);
+  }
+  else
+  {
+    *out_span = az_span_copy_u8(*out_span, digits[0]);
+    if (length > 1)
+    {
+      *out_span = az_span_copy_u8(*out_span, '.');
+      *out_span = az_span_copy(*out_span, az_span_slice_to_end(digits_span, 1));
+    }
+    *out_span = az_span_copy_u8(*out_span, 'e');
+    *out_span = az_span_copy_u8(*out_span, exponent < 0 ? '-' : '+');
+    return _az_span_builder_append_u32toa(
+        *out_span, (uint32_t)(exponent < 0 ? -exponent : exponent), out_span);
+  }
+
+  return AZ_OK;
+}
+
 // TODO: pass az_span by value
 AZ_NODISCARD az_result _az_is_expected_span(az_span* ref_span, az_span expected)
 {
@@ -816,20 +1623,6 @@ AZ_NODISCARD az_span _az_span_trim_whitespace(az_span source)
   return _az_span_trim_whitespace_from_end(_az_span_trim_whitespace_from_start(source));
 }
 
-AZ_NODISCARD AZ_INLINE bool _az_is_whitespace(uint8_t c)
-{
-  switch (c)
-  {
-    case ' ':
-    case '\t':
-    case '\n':
-    case '\r':
-      return true;
-    default:
-      return false;
-  }
-}
-
 typedef enum
 {
   LEFT = 0,
@@ -885,26 +1678,22 @@ AZ_NODISCARD az_span _az_span_trim_whitespace_from_end(az_span source)
 // [0-9]
 AZ_NODISCARD AZ_INLINE bool _az_span_is_byte_digit(uint8_t c) { return '0' <= c && c <= '9'; }
 
-// [A-Za-z]
-AZ_NODISCARD AZ_INLINE bool _az_span_is_byte_letter(uint8_t c)
-{
-  // This is equivalent to ('A' <= c && c <= 'Z') || ('a' <= c && c <= 'z')
-  // This works because upper case and lower case letters are 0x20 away from each other.
-  return ((uint32_t)(c - 'A') & ~(uint32_t)_az_ASCII_SPACE_CHARACTER) <= 'Z' - 'A';
-}
+// One bit per byte value, set for the unreserved characters which don't need to be URL-encoded:
+// [A-Za-z0-9], '-', '.', '_', and '~' (RFC 3986).
+static uint32_t const _az_span_url_unreserved_bits[8] = {
+  0x00000000, // 0x00 - 0x1F
+  0x03FF6000, // 0x20 - 0x3F: '-', '.', [0-9]
+  0x87FFFFFE, // 0x40 - 0x5F: [A-Z], '_'
+  0x47FFFFFE, // 0x60 - 0x7F: [a-z], '~'
+  0x00000000, // 0x80 - 0xFF
+  0x00000000,
+  0x00000000,
+  0x00000000,
+};
 
 AZ_NODISCARD AZ_INLINE bool _az_span_url_should_encode(uint8_t c)
 {
-  switch (c)
-  {
-    case '-':
-    case '_':
-    case '.':
-    case '~':
-      return false;
-    default:
-      return !(_az_span_is_byte_digit(c) || _az_span_is_byte_letter(c));
-  }
+  return ((_az_span_url_unreserved_bits[c >> 5U] >> (c & 31U)) & 1U) == 0;
 }
 
 AZ_NODISCARD int32_t _az_span_url_encode_calc_length(az_span source)
@@ -947,40 +1736,149 @@ AZ_NODISCARD az_result _az_span_url_encode(az_span destination, az_span source,
 
   uint8_t* const src_ptr = az_span_ptr(source);
   uint8_t* dest_ptr = dest_begin;
+  bool const is_overlapping = dest_begin < src_ptr + source_size && src_ptr < dest_end;
 
-  for (int32_t i = 0; i < source_size; i++)
+  int32_t i = 0;
+  while (i < source_size)
   {
-    uint8_t c = src_ptr[i];
-    if (!_az_span_url_should_encode(c))
+    // Copy the run of unreserved bytes up to the next one to encode all at once, or as much of it
+    // as fits. The spans mustn't overlap, but when precondition checks are off and they do, each
+    // byte is read only after the previous one is written, one at a time.
+    int32_t run_end = i;
+    while (run_end < source_size && !_az_span_url_should_encode(src_ptr[run_end]))
     {
-      if (dest_ptr >= dest_end)
+      run_end++;
+      if (is_overlapping)
       {
-        *out_length = 0;
-        return AZ_ERROR_NOT_ENOUGH_SPACE;
+        break;
       }
-
-      *dest_ptr = c;
-      ++dest_ptr;
     }
-    else
+
+    int32_t const run_size = run_end - i;
+    if (run_size > 0)
     {
-      if (dest_ptr >= dest_end - 2)
+      int32_t const dest_remaining = (int32_t)(dest_end - dest_ptr);
+      if (run_size > dest_remaining)
       {
+        memmove(dest_ptr, src_ptr + i, (size_t)dest_remaining);
         *out_length = 0;
         return AZ_ERROR_NOT_ENOUGH_SPACE;
       }
 
-      dest_ptr[0] = '%';
-      dest_ptr[1] = _az_number_to_upper_hex(c >> 4U);
-      dest_ptr[2] = _az_number_to_upper_hex(c & (uint32_t)_az_LARGEST_HEX_VALUE);
-      dest_ptr += 3;
+      memmove(dest_ptr, src_ptr + i, (size_t)run_size);
+      dest_ptr += run_size;
+      i = run_end;
+      continue;
+    }
+
+    if (dest_ptr >= dest_end - 2)
+    {
+      *out_length = 0;
+      return AZ_ERROR_NOT_ENOUGH_SPACE;
     }
+
+    uint8_t const c = src_ptr[i];
+    dest_ptr[0] = '%';
+    dest_ptr[1] = _az_number_to_upper_hex(c >> 4U);
+    dest_ptr[2] = _az_number_to_upper_hex(c & (uint32_t)_az_LARGEST_HEX_VALUE);
+    dest_ptr += 3;
+    i++;
   }
 
   *out_length = (int32_t)(dest_ptr - dest_begin);
   return AZ_OK;
 }
 
+// Returns the value of a hexadecimal digit, in either case, or -1 if the byte isn't one.
+AZ_NODISCARD AZ_INLINE int32_t _az_span_hex_digit_value(uint8_t c)
+{
+  if (_az_span_is_byte_digit(c))
+  {
+    return c - '0';
+  }
+
+  // Upper case and lower case letters are 0x20 away from each other.
+  uint8_t const upper = (uint8_t)(c & ~(uint32_t)_az_ASCII_SPACE_CHARACTER);
+  if (upper >= 'A' && upper <= 'F')
+  {
+    return upper - 'A' + 10;
+  }
+  return -1;
+}
+
+AZ_NODISCARD az_result _az_span_url_decode(az_span destination, az_span source, int32_t* out_length)
+{
+  _az_PRECONDITION_NOT_NULL(out_length);
+  _az_PRECONDITION_VALID_SPAN(source, 0, true);
+  _az_PRECONDITION_VALID_SPAN(destination, 0, true);
+
+  int32_t const source_size = az_span_size(source);
+  int32_t const destination_size = az_span_size(destination);
+  uint8_t const* const src_ptr = az_span_ptr(source);
+  uint8_t* const dest_ptr = az_span_ptr(destination);
+
+  int32_t src_index = 0;
+  int32_t dest_index = 0;
+  while (src_index < source_size)
+  {
+    // Copy the run of bytes up to the next percent-encoded one all at once. The destination may be
+    // the source itself, so the copy must allow overlap.
+    int32_t run_size = source_size - src_index;
+    uint8_t const* const percent
+        = (uint8_t const*)memchr(src_ptr + src_index, '%', (size_t)run_size);
+    if (percent != NULL)
+    {
+      run_size = (int32_t)(percent - (src_ptr + src_index));
+    }
+
+    if (run_size > destination_size - dest_index)
+    {
+      *out_length = 0;
+      return AZ_ERROR_NOT_ENOUGH_SPACE;
+    }
+
+    if (run_size > 0)
+    {
+      memmove(dest_ptr + dest_index, src_ptr + src_index, (size_t)run_size);
+      dest_index += run_size;
+      src_index += run_size;
+    }
+
+    if (src_index >= source_size)
+    {
+      break;
+    }
+
+    // A '%' must be followed by two hexadecimal digits.
+    if (source_size - src_index < 3)
+    {
+      *out_length = 0;
+      return AZ_ERROR_UNEXPECTED_END;
+    }
+
+    int32_t const high = _az_span_hex_digit_value(src_ptr[src_index + 1]);
+    int32_t const low = _az_span_hex_digit_value(src_ptr[src_index + 2]);
+    if (high < 0 || low < 0)
+    {
+      *out_length = 0;
+      return AZ_ERROR_UNEXPECTED_CHAR;
+    }
+
+    if (dest_index >= destination_size)
+    {
+      *out_length = 0;
+      return AZ_ERROR_NOT_ENOUGH_SPACE;
+    }
+
+    dest_ptr[dest_index] = (uint8_t)((high << 4) | low);
+    dest_index++;
+    src_index += 3;
+  }
+
+  *out_length = dest_index;
+  return AZ_OK;
+}
+
 az_span _az_span_token(
     az_span source,
     az_span delimiter,
@@ -41,6 +41,10 @@ enum
 
   // The largest digit in base 16 (hexadecimal).
   _az_LARGEST_HEX_VALUE = 0xF,
+
+  // The size from which az_span_find() uses the Two-Way algorithm, whose time is linear in the
+  // size of the source, instead of filtering the positions by their first byte.
+  _az_SPAN_FIND_TWO_WAY_MIN_SIZE = 32,
 };
 
 /**
@@ -73,6 +77,24 @@ AZ_NODISCARD AZ_INLINE bool _az_isfinite(double value)
       != _az_BINARY_VALUE_OF_POSITIVE_INFINITY;
 }
 
+/**
+ * @brief Determines whether the \p byte is one of the whitespace characters (` `, \\t, \\n, \\r)
+ * that are trimmed from spans and allowed between JSON tokens.
+ */
+AZ_NODISCARD AZ_INLINE bool _az_is_whitespace(uint8_t byte)
+{
+  switch (byte)
+  {
+    case ' ':
+    case '\t':
+    case '\n':
+    case '\r':
+      return true;
+    default:
+      return false;
+  }
+}
+
 AZ_NODISCARD az_result _az_is_expected_span(az_span* ref_span, az_span expected);
 
 /**
@@ -138,6 +138,19 @@ AZ_NODISCARD az_result az_iot_message_properties_next(
   return AZ_OK;
 }
 
+AZ_NODISCARD az_result
+az_iot_message_properties_decode(az_span source, az_span destination, az_span* out_decoded)
+{
+  _az_PRECONDITION_VALID_SPAN(source, 0, true);
+  _az_PRECONDITION_VALID_SPAN(destination, 0, true);
+  _az_PRECONDITION_NOT_NULL(out_decoded);
+
+  int32_t length = 0;
+  _az_RETURN_IF_FAILED(_az_span_url_decode(destination, source, &length));
+  *out_decoded = az_span_slice(destination, 0, length);
+  return AZ_OK;
+}
+
 AZ_NODISCARD int32_t az_iot_calculate_retry_delay(
     int32_t operation_msec,
     int16_t attempt,
@@ -175,38 +188,12 @@ AZ_NODISCARD int32_t az_iot_calculate_retry_delay(
 
 AZ_NODISCARD int32_t _az_iot_u32toa_size(uint32_t number)
 {
-  if (number == 0)
-  {
-    return 1;
-  }
-
-  uint32_t div = _az_SMALLEST_10_DIGIT_NUMBER;
-  int32_t digit_count = _az_MAX_SIZE_FOR_UINT32;
-  while (number / div == 0)
-  {
-    div /= _az_NUMBER_OF_DECIMAL_VALUES;
-    digit_count--;
-  }
-
-  return digit_count;
+  return _az_span_u64toa_size(number);
 }
 
 AZ_NODISCARD int32_t _az_iot_u64toa_size(uint64_t number)
 {
-  if (number == 0)
-  {
-    return 1;
-  }
-
-  uint64_t div = _az_SMALLEST_20_DIGIT_NUMBER;
-  int32_t digit_count = _az_MAX_SIZE_FOR_UINT64;
-  while (number / div == 0)
-  {
-    div /= _az_NUMBER_OF_DECIMAL_VALUES;
-    digit_count--;
-  }
-
-  return digit_count;
+  return _az_span_u64toa_size(number);
 }
 
 AZ_NODISCARD az_result
@@ -3,10 +3,14 @@
 
 #include <azure/core/az_http.h>
 #include <azure/core/az_http_transport.h>
+#include <azure/core/az_platform.h>
 #include <azure/core/az_span.h>
+#include <azure/core/internal/az_http_internal.h>
 #include <azure/core/internal/az_result_internal.h>
 #include <azure/core/internal/az_span_internal.h>
+#include <azure/platform/az_curl.h>
 
+#include <stdio.h>
 #include <stdlib.h>
 
 #include <curl/curl.h>
@@ -118,6 +122,7 @@ _az_http_client_curl_slist_append(struct curl_slist** ref_list, char const* str)
   {
     // free any previous allocates custom headers
     curl_slist_free_all(*ref_list);
+    *ref_list = NULL;
     return AZ_ERROR_HTTP_ADAPTER;
   }
 
@@ -285,77 +290,59 @@ static size_t _az_http_client_curl_write_to_span(
 }
 
 /**
- * handles GET request
- */
-static AZ_NODISCARD az_result _az_http_client_curl_send_get_request(CURL* ref_curl)
-{
-  _az_PRECONDITION_NOT_NULL(ref_curl);
-
-  // send
-  _az_RETURN_IF_CURL_FAILED(curl_easy_perform(ref_curl));
-
-  return AZ_OK;
-}
-
-/**
- * handles DELETE request
+ * @brief This is the function that curl will use to write the response body, which it receives
+ * after the status line and headers. The body is written into the user provided span, or passed to
+ * the body callback of the response, without being copied, when there is one.
+ *
+ * @param contents response body data from Curl response
+ * @param size size of the curl response data
+ * @param nmemb number of blocks in response
+ * @param userp this represent a structure linked to response by us before
+ * @return int
  */
-static AZ_NODISCARD az_result _az_http_client_curl_send_delete_request(CURL* ref_curl)
+static size_t _az_http_client_curl_write_body_to_span(
+    void* contents,
+    size_t size,
+    size_t nmemb,
+    void* userp)
 {
-  _az_PRECONDITION_NOT_NULL(ref_curl);
+  size_t const expected_size = size * nmemb;
+  az_http_response* response = (az_http_response*)userp;
 
-  _az_RETURN_IF_FAILED(_az_http_client_curl_code_to_result(
-      curl_easy_setopt(ref_curl, CURLOPT_CUSTOMREQUEST, "DELETE")));
+  az_span const span_for_content = az_span_create((uint8_t*)contents, (int32_t)expected_size);
 
-  _az_RETURN_IF_FAILED(_az_http_client_curl_code_to_result(curl_easy_perform(ref_curl)));
+  if (az_result_failed(az_http_response_append_body(response, span_for_content)))
+  {
+    return expected_size
+        + 1; // Adding any constant to return value will tell curl that this function failed
+  }
 
-  return AZ_OK;
+  return expected_size;
 }
 
 /**
- * handles POST request. It handles seting up a body for request
+ * sets up a DELETE request
  */
-static AZ_NODISCARD az_result
-_az_http_client_curl_send_post_request(CURL* ref_curl, az_http_request const* request)
+static AZ_NODISCARD az_result _az_http_client_curl_setup_delete_request(CURL* ref_curl)
 {
   _az_PRECONDITION_NOT_NULL(ref_curl);
-  _az_PRECONDITION_NOT_NULL(request);
-
-  // Method
-  az_span request_body = { 0 };
-  _az_RETURN_IF_FAILED(az_http_request_get_body(request, &request_body));
-  az_span body = { 0 };
-  int32_t const required_length = az_span_size(request_body) + az_span_size(AZ_SPAN_FROM_STR("\0"));
 
-  _az_RETURN_IF_FAILED(_az_span_malloc(required_length, &body));
-
-  char* b = (char*)az_span_ptr(body);
-  az_span_to_str(b, required_length, request_body);
-
-  az_result res_code
-      = _az_http_client_curl_code_to_result(curl_easy_setopt(ref_curl, CURLOPT_POSTFIELDS, b));
-  if (az_result_succeeded(res_code))
-  {
-    res_code = _az_http_client_curl_code_to_result(curl_easy_perform(ref_curl));
-  }
-
-  _az_span_free(&body);
-  _az_RETURN_IF_FAILED(res_code);
+  _az_RETURN_IF_CURL_FAILED(curl_easy_setopt(ref_curl, CURLOPT_CUSTOMREQUEST, "DELETE"));
 
   return AZ_OK;
 }
 
 /**
  * @brief UPLOAD requests are done via callbacks.  The callback is passed in a buffer address which
- * is filled with the userdata content. The callback will occur until the callback returns 0 (no
- * more data). The callback will return CURL_READFUNC_ABORT should an error occur.  This in turn
- * terminates the POST request.
+ * is filled with the next segment of the request body. The callback will occur until the callback
+ * returns 0 (no more data). The callback will return CURL_READFUNC_ABORT should an error occur.
+ * This in turn terminates the request.
  *
  * @param dst Destination address buffer
  * @param size Size of an item
  * @param nmemb Number of items to copy
  * @param userdata Source data to upload
- *                 Passed as the pointer to an az_span
+ *                 Passed as the pointer to an _az_curl_upload
  * @return int
  */
 static int32_t _az_http_client_curl_upload_read_callback(
@@ -364,8 +351,7 @@ static int32_t _az_http_client_curl_upload_read_callback(
     size_t nmemb,
     void* userdata)
 {
-
-  az_span* upload_content = (az_span*)userdata;
+  _az_curl_upload* const upload = (_az_curl_upload*)userdata;
 
   // Calculate the size of the *dst buffer
   int32_t dst_buffer_size = (int32_t)(nmemb * size);
@@ -376,63 +362,167 @@ static int32_t _az_http_client_curl_upload_read_callback(
     return CURL_READFUNC_ABORT;
   }
 
-  int32_t userdata_length = az_span_size(*upload_content);
+  // Get the next segment of the body once curl has read all of the current one
+  if (az_span_size(upload->_internal.segment) < 1)
+  {
+    if (az_result_failed(az_http_request_get_body_segment(
+            upload->_internal.request, upload->_internal.offset, &upload->_internal.segment)))
+    {
+      return CURL_READFUNC_ABORT;
+    }
+
+    upload->_internal.offset += az_span_size(upload->_internal.segment);
+  }
+
+  int32_t segment_length = az_span_size(upload->_internal.segment);
 
   // Return if nothing to copy
-  if (userdata_length < 1)
+  if (segment_length < 1)
   {
     return CURLE_OK; // Success, all bytes copied
   }
 
-  // Calculate how many bytes can we copy from customer data (upload_content)
-  // Curl provides dst buffer with a max size of dest_buffer_size, if customer data size is less
-  // than the max, we can copy all customer data directly and have it uploaded at once.
-  // If not, we can only copy the max dst size from customer data and wait for another upload to
+  // Calculate how many bytes can we copy from the segment.
+  // Curl provides dst buffer with a max size of dest_buffer_size, if the segment size is less
+  // than the max, we can copy all of the segment directly and have it uploaded at once.
+  // If not, we can only copy the max dst size from the segment and wait for another upload to
   // copy a next chunk of data
-  int32_t size_of_copy = (userdata_length < dst_buffer_size) ? userdata_length : dst_buffer_size;
+  int32_t size_of_copy = (segment_length < dst_buffer_size) ? segment_length : dst_buffer_size;
 
   // NOLINTNEXTLINE(clang-analyzer-security.insecureAPI.DeprecatedOrUnsafeBufferHandling)
-  memcpy(dst, az_span_ptr(*upload_content), (size_t)size_of_copy);
+  memcpy(dst, az_span_ptr(upload->_internal.segment), (size_t)size_of_copy);
 
-  // Update the userdata span. If we already copied all content, slice will set upload_content with
-  // 0 length
-  *upload_content = az_span_slice_to_end(*upload_content, size_of_copy);
+  // Update the segment. If we already copied all of it, slice will set it with 0 length, and the
+  // next segment is fetched by the next callback
+  upload->_internal.segment = az_span_slice_to_end(upload->_internal.segment, size_of_copy);
 
   return size_of_copy;
 }
 
 /**
- * Perform an UPLOAD or PUT request.
- * As of CURL 7.12.1 CURLOPT_PUT is deprecated.  PUT requests should be made using CURLOPT_UPLOAD
+ * @brief curl calls this to rewind the body, when it has to send the request again (e.g. because
+ * a reused connection was closed by the server, or to follow a redirect).
+ *
+ * @param userdata the _az_curl_upload of the request
+ * @param offset the offset in the body where to restart the upload from
+ * @param origin where \p offset is relative to. Only SEEK_SET is supported.
+ * @return int
  */
-static AZ_NODISCARD az_result
-_az_http_client_curl_send_upload_request(CURL* ref_curl, az_http_request const* request)
+static int _az_http_client_curl_upload_seek_callback(void* userdata, curl_off_t offset, int origin)
+{
+  _az_curl_upload* const upload = (_az_curl_upload*)userdata;
+
+  if (origin != SEEK_SET || offset < 0)
+  {
+    return CURL_SEEKFUNC_CANTSEEK;
+  }
+
+  upload->_internal.segment = AZ_SPAN_EMPTY;
+  upload->_internal.offset = (int64_t)offset;
+
+  return CURL_SEEKFUNC_OK;
+}
+
+/**
+ * @brief sets up curl to read the body of a request from the read callback, one segment at a time
+ *
+ * @param ref_upload the progress of the upload, which must outlive the transfer
+ */
+static AZ_NODISCARD az_result _az_http_client_curl_setup_upload_callbacks(
+    CURL* ref_curl,
+    az_http_request const* request,
+    _az_curl_upload* ref_upload)
+{
+  *ref_upload = (_az_curl_upload){ ._internal = {
+                                       .request = request,
+                                       .segment = AZ_SPAN_EMPTY,
+                                       .offset = 0,
+                                   } };
+
+  _az_RETURN_IF_CURL_FAILED(
+      curl_easy_setopt(ref_curl, CURLOPT_READFUNCTION, _az_http_client_curl_upload_read_callback));
+
+  // Setup the request to pass the upload progress into the read and seek callbacks
+  _az_RETURN_IF_CURL_FAILED(curl_easy_setopt(ref_curl, CURLOPT_READDATA, ref_upload));
+
+  _az_RETURN_IF_CURL_FAILED(
+      curl_easy_setopt(ref_curl, CURLOPT_SEEKFUNCTION, _az_http_client_curl_upload_seek_callback));
+  _az_RETURN_IF_CURL_FAILED(curl_easy_setopt(ref_curl, CURLOPT_SEEKDATA, ref_upload));
+
+  return AZ_OK;
+}
+
+/**
+ * sets up a POST request. curl sends a body span straight from the request, which must outlive the
+ * transfer. A body provided by a callback is read with the read callback instead.
+ *
+ * @param ref_upload the progress of the upload, which must outlive the transfer
+ */
+static AZ_NODISCARD az_result _az_http_client_curl_setup_post_request(
+    CURL* ref_curl,
+    az_http_request const* request,
+    _az_curl_upload* ref_upload)
 {
   _az_PRECONDITION_NOT_NULL(ref_curl);
   _az_PRECONDITION_NOT_NULL(request);
+  _az_PRECONDITION_NOT_NULL(ref_upload);
+
+  int64_t body_size = 0;
+  _az_RETURN_IF_FAILED(az_http_request_get_body_size(request, &body_size));
 
   az_span body = { 0 };
   _az_RETURN_IF_FAILED(az_http_request_get_body(request, &body));
 
-  _az_RETURN_IF_CURL_FAILED(curl_easy_setopt(ref_curl, CURLOPT_UPLOAD, 1L));
-  _az_RETURN_IF_CURL_FAILED(
-      curl_easy_setopt(ref_curl, CURLOPT_READFUNCTION, _az_http_client_curl_upload_read_callback));
+  // The body isn't in the request span when it is provided by a callback.
+  if (body_size != (int64_t)az_span_size(body))
+  {
+    _az_RETURN_IF_CURL_FAILED(curl_easy_setopt(ref_curl, CURLOPT_POST, 1L));
+
+    // A size of -1 makes curl send the body with the chunked transfer encoding.
+    _az_RETURN_IF_CURL_FAILED(
+        curl_easy_setopt(ref_curl, CURLOPT_POSTFIELDSIZE_LARGE, (curl_off_t)body_size));
 
-  // Setup the request to pass body into the read callback
-  // The read callback receives the address of body
-  _az_RETURN_IF_CURL_FAILED(curl_easy_setopt(ref_curl, CURLOPT_READDATA, &body));
+    return _az_http_client_curl_setup_upload_callbacks(ref_curl, request, ref_upload);
+  }
 
-  // Set the size of the upload
+  // The size is set first, so that curl doesn't look for a 0-terminator in the body.
   _az_RETURN_IF_CURL_FAILED(
-      curl_easy_setopt(ref_curl, CURLOPT_INFILESIZE, (curl_off_t)az_span_size(body)));
+      curl_easy_setopt(ref_curl, CURLOPT_POSTFIELDSIZE_LARGE, (curl_off_t)az_span_size(body)));
 
-  // Do the curl work
-  // curl_easy_perform does not return until the CURLOPT_READFUNCTION callbacks complete.
-  _az_RETURN_IF_CURL_FAILED(curl_easy_perform(ref_curl));
+  char const* const fields = az_span_size(body) > 0 ? (char const*)az_span_ptr(body) : "";
+  _az_RETURN_IF_CURL_FAILED(curl_easy_setopt(ref_curl, CURLOPT_POSTFIELDS, fields));
 
   return AZ_OK;
 }
 
+/**
+ * Set up an UPLOAD or PUT request.
+ * As of CURL 7.12.1 CURLOPT_PUT is deprecated.  PUT requests should be made using CURLOPT_UPLOAD
+ *
+ * @param ref_upload the progress of the upload, which must outlive the transfer
+ */
+static AZ_NODISCARD az_result _az_http_client_curl_setup_upload_request(
+    CURL* ref_curl,
+    az_http_request const* request,
+    _az_curl_upload* ref_upload)
+{
+  _az_PRECONDITION_NOT_NULL(ref_curl);
+  _az_PRECONDITION_NOT_NULL(request);
+  _az_PRECONDITION_NOT_NULL(ref_upload);
+
+  int64_t body_size = 0;
+  _az_RETURN_IF_FAILED(az_http_request_get_body_size(request, &body_size));
+
+  _az_RETURN_IF_CURL_FAILED(curl_easy_setopt(ref_curl, CURLOPT_UPLOAD, 1L));
+
+  // Set the size of the upload. A size of -1 makes curl send the body with the chunked transfer
+  // encoding.
+  _az_RETURN_IF_CURL_FAILED(
+      curl_easy_setopt(ref_curl, CURLOPT_INFILESIZE_LARGE, (curl_off_t)body_size));
+
+  return _az_http_client_curl_setup_upload_callbacks(ref_curl, request, ref_upload);
+}
+
 /**
  * @brief finds out if there are headers in the request and add them to curl header list
  *
@@ -528,7 +618,7 @@ _az_http_client_curl_setup_response_redirect(CURL* ref_curl, az_http_response* r
   _az_RETURN_IF_CURL_FAILED(curl_easy_setopt(ref_curl, CURLOPT_HEADERDATA, (void*)response));
 
   _az_RETURN_IF_CURL_FAILED(
-      curl_easy_setopt(ref_curl, CURLOPT_WRITEFUNCTION, _az_http_client_curl_write_to_span));
+      curl_easy_setopt(ref_curl, CURLOPT_WRITEFUNCTION, _az_http_client_curl_write_body_to_span));
 
   _az_RETURN_IF_CURL_FAILED(curl_easy_setopt(ref_curl, CURLOPT_WRITEDATA, (void*)response));
 
@@ -536,27 +626,27 @@ _az_http_client_curl_setup_response_redirect(CURL* ref_curl, az_http_response* r
 }
 
 /**
- * @brief use this function to group all the actions that we do with CURL so we can clean it after
- * it no matter is there is an error at any step.
+ * @brief sets up everything curl needs to send a request, without sending it
  *
  * @param ref_curl curl specific structure used to send an http request
+ * @param ref_list curl headers list, which must be freed once the transfer is done
+ * @param ref_upload storage for the progress of the upload, which must outlive the transfer
  * @param request http builder with specific data to build an http request
  * @param ref_response pre-allocated buffer where to write http response
-
- * @return AZ_OK if request was sent and a response was received
+ * @return az_result
  */
-static AZ_NODISCARD az_result _az_http_client_curl_send_request_impl_process(
+static AZ_NODISCARD az_result _az_http_client_curl_setup_request(
     CURL* ref_curl,
+    struct curl_slist** ref_list,
+    _az_curl_upload* ref_upload,
     az_http_request const* request,
     az_http_response* ref_response)
 {
   _az_PRECONDITION_NOT_NULL(ref_curl);
+  _az_PRECONDITION_NOT_NULL(ref_list);
   _az_PRECONDITION_NOT_NULL(request);
 
-  az_result result = AZ_ERROR_ARG;
-
-  struct curl_slist* list = NULL;
-  _az_RETURN_IF_FAILED(_az_http_client_curl_setup_headers(ref_curl, &list, request));
+  _az_RETURN_IF_FAILED(_az_http_client_curl_setup_headers(ref_curl, ref_list, request));
 
   _az_RETURN_IF_FAILED(_az_http_client_curl_setup_url(ref_curl, request));
 
@@ -567,27 +657,55 @@ static AZ_NODISCARD az_result _az_http_client_curl_send_request_impl_process(
 
   if (az_span_is_content_equal(method, az_http_method_get()))
   {
-    result = _az_http_client_curl_send_get_request(ref_curl);
+    return AZ_OK;
   }
   else if (az_span_is_content_equal(method, az_http_method_delete()))
   {
-    result = _az_http_client_curl_send_delete_request(ref_curl);
+    return _az_http_client_curl_setup_delete_request(ref_curl);
   }
   else if (az_span_is_content_equal(method, az_http_method_post()))
   {
-    _az_RETURN_IF_FAILED(_az_http_client_curl_add_expect_header(ref_curl, &list));
-    result = _az_http_client_curl_send_post_request(ref_curl, request);
+    _az_RETURN_IF_FAILED(_az_http_client_curl_add_expect_header(ref_curl, ref_list));
+    return _az_http_client_curl_setup_post_request(ref_curl, request, ref_upload);
   }
   else if (az_span_is_content_equal(method, az_http_method_put()))
   {
     // As of CURL 7.12.1 CURLOPT_PUT is deprecated.  PUT requests should be made using
     // CURLOPT_UPLOAD
-    _az_RETURN_IF_FAILED(_az_http_client_curl_add_expect_header(ref_curl, &list));
-    result = _az_http_client_curl_send_upload_request(ref_curl, request);
+    _az_RETURN_IF_FAILED(_az_http_client_curl_add_expect_header(ref_curl, ref_list));
+    return _az_http_client_curl_setup_upload_request(ref_curl, request, ref_upload);
   }
-  else
+
+  return AZ_ERROR_HTTP_INVALID_METHOD_VERB;
+}
+
+/**
+ * @brief use this function to group all the actions that we do with CURL so we can clean it after
+ * it no matter is there is an error at any step.
+ *
+ * @param ref_curl curl specific structure used to send an http request
+ * @param request http builder with specific data to build an http request
+ * @param ref_response pre-allocated buffer where to write http response
+
+ * @return AZ_OK if request was sent and a response was received
+ */
+static AZ_NODISCARD az_result _az_http_client_curl_send_request_impl_process(
+    CURL* ref_curl,
+    az_http_request const* request,
+    az_http_response* ref_response)
+{
+  _az_PRECONDITION_NOT_NULL(ref_curl);
+  _az_PRECONDITION_NOT_NULL(request);
+
+  struct curl_slist* list = NULL;
+  _az_curl_upload upload = { 0 };
+
+  az_result result
+      = _az_http_client_curl_setup_request(ref_curl, &list, &upload, request, ref_response);
+
+  if (az_result_succeeded(result))
   {
-    return AZ_ERROR_HTTP_INVALID_METHOD_VERB;
+    result = _az_http_client_curl_code_to_result(curl_easy_perform(ref_curl));
   }
 
   // Clean custom headers previously appended
@@ -596,12 +714,117 @@ static AZ_NODISCARD az_result _az_http_client_curl_send_request_impl_process(
   return result;
 }
 
+// Only using volatile here, not for thread safety, but so that the compiler does not optimize what
+// it falsely thinks are stale reads.
+static az_curl_connection* volatile _az_curl_default_connection = NULL;
+
+/**
+ * @brief Clears the options left on a reused curl handle by the previous request and applies the
+ * connection options. Open connections and the DNS cache are kept by curl_easy_reset().
+ *
+ * @param ref_curl curl handle owned by an az_curl_connection
+ * @param options connection options to apply
+ * @return az_result
+ */
+static AZ_NODISCARD az_result
+_az_curl_connection_setup(CURL* ref_curl, az_curl_connection_options const* options)
+{
+  _az_PRECONDITION_NOT_NULL(ref_curl);
+  _az_PRECONDITION_NOT_NULL(options);
+
+  curl_easy_reset(ref_curl);
+
+#if LIBCURL_VERSION_NUM >= 0x071900 // CURLOPT_TCP_KEEPALIVE was added in 7.25.0
+  if (options->keep_alive_interval_sec > 0)
+  {
+    long const interval = (long)options->keep_alive_interval_sec;
+    _az_RETURN_IF_CURL_FAILED(curl_easy_setopt(ref_curl, CURLOPT_TCP_KEEPALIVE, 1L));
+    _az_RETURN_IF_CURL_FAILED(curl_easy_setopt(ref_curl, CURLOPT_TCP_KEEPIDLE, interval));
+    _az_RETURN_IF_CURL_FAILED(curl_easy_setopt(ref_curl, CURLOPT_TCP_KEEPINTVL, interval));
+  }
+#endif
+
+#if LIBCURL_VERSION_NUM >= 0x074100 // CURLOPT_MAXAGE_CONN was added in 7.65.0
+  if (options->idle_timeout_sec > 0)
+  {
+    _az_RETURN_IF_CURL_FAILED(
+        curl_easy_setopt(ref_curl, CURLOPT_MAXAGE_CONN, (long)options->idle_timeout_sec));
+  }
+#endif
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_curl_connection_init(
+    az_curl_connection* out_connection,
+    az_curl_connection_options const* options)
+{
+  _az_PRECONDITION_NOT_NULL(out_connection);
+  _az_PRECONDITION(options == NULL || options->idle_timeout_sec >= 0);
+  _az_PRECONDITION(options == NULL || options->keep_alive_interval_sec >= 0);
+
+  *out_connection = (az_curl_connection){
+    ._internal = {
+      .curl = curl_easy_init(),
+      .options = options == NULL ? az_curl_connection_options_default() : *options,
+    },
+  };
+
+  return out_connection->_internal.curl == NULL ? AZ_ERROR_HTTP_ADAPTER : AZ_OK;
+}
+
+void az_curl_connection_deinit(az_curl_connection* ref_connection)
+{
+  _az_PRECONDITION_NOT_NULL(ref_connection);
+
+  if (_az_curl_default_connection == ref_connection)
+  {
+    _az_curl_default_connection = NULL;
+  }
+
+  if (ref_connection->_internal.curl != NULL)
+  {
+    curl_easy_cleanup((CURL*)ref_connection->_internal.curl);
+    ref_connection->_internal.curl = NULL;
+  }
+}
+
+AZ_NODISCARD az_result az_curl_connection_send_request(
+    az_curl_connection* ref_connection,
+    az_http_request const* request,
+    az_http_response* ref_response)
+{
+  _az_PRECONDITION_NOT_NULL(ref_connection);
+  _az_PRECONDITION_NOT_NULL(ref_connection->_internal.curl);
+  _az_PRECONDITION_NOT_NULL(request);
+  _az_PRECONDITION_NOT_NULL(ref_response);
+
+  CURL* const curl = (CURL*)ref_connection->_internal.curl;
+
+  _az_RETURN_IF_FAILED(_az_curl_connection_setup(curl, &ref_connection->_internal.options));
+
+  return _az_http_client_curl_send_request_impl_process(curl, request, ref_response);
+}
+
+void az_curl_set_default_connection(az_curl_connection* connection)
+{
+  // We assume assignments are atomic for the supported platforms and compilers.
+  _az_curl_default_connection = connection;
+}
+
 AZ_NODISCARD az_result
 az_http_client_send_request(az_http_request const* request, az_http_response* ref_response)
 {
   _az_PRECONDITION_NOT_NULL(request);
   _az_PRECONDITION_NOT_NULL(ref_response);
 
+  // Copy the volatile field to a local variable so that it doesn't change within this function.
+  az_curl_connection* const default_connection = _az_curl_default_connection;
+  if (default_connection != NULL)
+  {
+    return az_curl_connection_send_request(default_connection, request, ref_response);
+  }
+
   CURL* curl = NULL;
 
   // init curl
@@ -616,3 +839,448 @@ az_http_client_send_request(az_http_request const* request, az_http_response* re
 
   return process_result;
 }
+
+static void _az_curl_multi_link(az_curl_multi* ref_multi, az_curl_multi_request* ref_request)
+{
+  ref_request->_internal.previous = NULL;
+  ref_request->_internal.next = ref_multi->_internal.requests;
+  if (ref_multi->_internal.requests != NULL)
+  {
+    ref_multi->_internal.requests->_internal.previous = ref_request;
+  }
+
+  ref_multi->_internal.requests = ref_request;
+  ++ref_multi->_internal.pending_count;
+}
+
+static void _az_curl_multi_unlink(az_curl_multi* ref_multi, az_curl_multi_request* ref_request)
+{
+  if (ref_request->_internal.previous != NULL)
+  {
+    ref_request->_internal.previous->_internal.next = ref_request->_internal.next;
+  }
+  else
+  {
+    ref_multi->_internal.requests = ref_request->_internal.next;
+  }
+
+  if (ref_request->_internal.next != NULL)
+  {
+    ref_request->_internal.next->_internal.previous = ref_request->_internal.previous;
+  }
+
+  ref_request->_internal.previous = NULL;
+  ref_request->_internal.next = NULL;
+  --ref_multi->_internal.pending_count;
+}
+
+/**
+ * @brief gets the pipeline a request is sent through: the pipeline of a service client, a pipeline
+ * with only the retry policy, or NULL if the request is sent once, as it is
+ *
+ * @param ref_options the options the request was submitted with
+ * @param out_retry_pipeline where the pipeline with only the retry policy is built
+ * @return _az_http_pipeline*
+ */
+static _az_http_pipeline* _az_curl_multi_get_pipeline(
+    az_curl_multi_submit_options* ref_options,
+    _az_http_pipeline* out_retry_pipeline)
+{
+  if (ref_options->_internal.pipeline != NULL || ref_options->retry_options.max_retries <= 0)
+  {
+    return (_az_http_pipeline*)ref_options->_internal.pipeline;
+  }
+
+  *out_retry_pipeline = (_az_http_pipeline){
+    ._internal = {
+      .policies = {
+        {
+          ._internal = {
+            .process = az_http_pipeline_policy_retry,
+            .options = &ref_options->retry_options,
+          },
+        },
+        {
+          ._internal = {
+            .process = az_http_pipeline_policy_transport,
+            .options = NULL,
+          },
+        },
+      },
+    },
+  };
+
+  return out_retry_pipeline;
+}
+
+/**
+ * @brief sets up the easy handle of a request for its next attempt and adds it to the multi handle
+ *
+ * @param ref_multi the multi handle that sends the request
+ * @param ref_request the request to send, whose pipeline policies already ran for this attempt
+ * @return az_result
+ */
+static AZ_NODISCARD az_result
+_az_curl_multi_start_transfer(az_curl_multi* ref_multi, az_curl_multi_request* ref_request)
+{
+  CURL* const curl = (CURL*)ref_request->_internal.curl;
+  struct curl_slist* list = NULL;
+
+  _az_RETURN_IF_FAILED(_az_curl_connection_setup(curl, &ref_multi->_internal.options));
+
+  az_result result = _az_http_client_curl_setup_request(
+      curl,
+      &list,
+      &ref_request->_internal.upload,
+      ref_request->_internal.request,
+      ref_request->_internal.response);
+
+  if (az_result_succeeded(result))
+  {
+    result = _az_http_client_curl_code_to_result(
+        curl_easy_setopt(curl, CURLOPT_PRIVATE, (void*)ref_request));
+  }
+
+  // The start of the attempt is only needed to log the response, once the pipeline checks it.
+  _az_http_pipeline retry_pipeline = { 0 };
+  if (az_result_succeeded(result)
+      && _az_curl_multi_get_pipeline(&ref_request->_internal.options, &retry_pipeline) != NULL)
+  {
+    result = az_platform_clock_msec(&ref_request->_internal.start_msec);
+  }
+
+  if (az_result_succeeded(result)
+      && curl_multi_add_handle((CURLM*)ref_multi->_internal.multi, curl) != CURLM_OK)
+  {
+    result = AZ_ERROR_HTTP_ADAPTER;
+  }
+
+  if (az_result_failed(result))
+  {
+    curl_slist_free_all(list);
+    return result;
+  }
+
+  // The headers are kept until the transfer is done.
+  ref_request->_internal.headers = list;
+  ref_request->_internal.retry_at_msec = -1;
+  ++ref_request->_internal.attempt;
+
+  return AZ_OK;
+}
+
+/**
+ * @brief removes a request from the multi handle, releases its easy handle and invokes its
+ * completion callback
+ */
+static void _az_curl_multi_complete(
+    az_curl_multi* ref_multi,
+    az_curl_multi_request* ref_request,
+    az_result result)
+{
+  _az_curl_multi_unlink(ref_multi, ref_request);
+
+  curl_easy_cleanup((CURL*)ref_request->_internal.curl);
+  ref_request->_internal.curl = NULL;
+
+  ref_request->_internal.completion_callback(
+      ref_request, result, ref_request->_internal.user_context);
+}
+
+/**
+ * @brief handles a transfer that is done: lets the pipeline check the response, and either
+ * schedules a retry or completes the request
+ */
+static void _az_curl_multi_transfer_done(
+    az_curl_multi* ref_multi,
+    az_curl_multi_request* ref_request,
+    CURLcode code)
+{
+  CURL* const curl = (CURL*)ref_request->_internal.curl;
+  (void)curl_multi_remove_handle((CURLM*)ref_multi->_internal.multi, curl);
+
+  curl_slist_free_all((struct curl_slist*)ref_request->_internal.headers);
+  ref_request->_internal.headers = NULL;
+
+  az_result result = _az_http_client_curl_code_to_result(code);
+
+  _az_http_pipeline retry_pipeline = { 0 };
+  _az_http_pipeline const* const pipeline
+      = _az_curl_multi_get_pipeline(&ref_request->_internal.options, &retry_pipeline);
+  if (pipeline == NULL)
+  {
+    _az_curl_multi_complete(ref_multi, ref_request, result);
+    return;
+  }
+
+  int64_t now = 0;
+  int32_t retry_after_msec = -1;
+  if (az_result_succeeded(result))
+  {
+    result = az_platform_clock_msec(&now);
+  }
+
+  if (az_result_succeeded(result))
+  {
+    result = _az_http_pipeline_complete_request(
+        pipeline,
+        ref_request->_internal.request,
+        ref_request->_internal.response,
+        result,
+        now - ref_request->_internal.start_msec,
+        ref_request->_internal.attempt,
+        &retry_after_msec);
+  }
+
+  if (az_result_failed(result) || retry_after_msec < 0)
+  {
+    _az_curl_multi_complete(ref_multi, ref_request, result);
+    return;
+  }
+
+  // Keep the request pending, without parking this thread, until the retry is due.
+  ref_request->_internal.retry_at_msec = now + retry_after_msec;
+}
+
+AZ_NODISCARD az_result
+az_curl_multi_init(az_curl_multi* out_multi, az_curl_connection_options const* options)
+{
+  _az_PRECONDITION_NOT_NULL(out_multi);
+  _az_PRECONDITION(options == NULL || options->idle_timeout_sec >= 0);
+  _az_PRECONDITION(options == NULL || options->keep_alive_interval_sec >= 0);
+
+  *out_multi = (az_curl_multi){
+    ._internal = {
+      .multi = curl_multi_init(),
+      .requests = NULL,
+      .options = options == NULL ? az_curl_connection_options_default() : *options,
+      .pending_count = 0,
+    },
+  };
+
+  return out_multi->_internal.multi == NULL ? AZ_ERROR_HTTP_ADAPTER : AZ_OK;
+}
+
+void az_curl_multi_deinit(az_curl_multi* ref_multi)
+{
+  _az_PRECONDITION_NOT_NULL(ref_multi);
+
+  while (ref_multi->_internal.requests != NULL)
+  {
+    az_curl_multi_request* const request = ref_multi->_internal.requests;
+    if (request->_internal.retry_at_msec < 0)
+    {
+      (void)curl_multi_remove_handle(
+          (CURLM*)ref_multi->_internal.multi, (CURL*)request->_internal.curl);
+      curl_slist_free_all((struct curl_slist*)request->_internal.headers);
+      request->_internal.headers = NULL;
+    }
+
+    _az_curl_multi_complete(ref_multi, request, AZ_ERROR_CANCELED);
+  }
+
+  if (ref_multi->_internal.multi != NULL)
+  {
+    (void)curl_multi_cleanup((CURLM*)ref_multi->_internal.multi);
+    ref_multi->_internal.multi = NULL;
+  }
+}
+
+AZ_NODISCARD az_curl_multi_submit_options az_curl_multi_submit_options_default()
+{
+  az_curl_multi_submit_options options = {
+    .retry_options = _az_http_policy_retry_options_default(),
+    ._internal = {
+      .pipeline = NULL,
+    },
+  };
+
+  // Requests aren't retried unless the caller asks for it.
+  options.retry_options.max_retries = 0;
+  return options;
+}
+
+AZ_NODISCARD az_result az_curl_multi_submit(
+    az_curl_multi* ref_multi,
+    az_curl_multi_request* out_request,
+    az_curl_multi_submit_options const* options,
+    az_http_request* ref_request,
+    az_http_response* ref_response,
+    az_curl_multi_completion_fn completion_callback,
+    void* user_context)
+{
+  _az_PRECONDITION_NOT_NULL(ref_multi);
+  _az_PRECONDITION_NOT_NULL(ref_multi->_internal.multi);
+  _az_PRECONDITION_NOT_NULL(out_request);
+  _az_PRECONDITION_NOT_NULL(ref_request);
+  _az_PRECONDITION_NOT_NULL(ref_response);
+  _az_PRECONDITION_NOT_NULL(completion_callback);
+
+  az_curl_multi_submit_options submit_options
+      = options == NULL ? az_curl_multi_submit_options_default() : *options;
+
+  _az_http_pipeline retry_pipeline = { 0 };
+  _az_http_pipeline* const pipeline = _az_curl_multi_get_pipeline(&submit_options, &retry_pipeline);
+  if (pipeline != NULL)
+  {
+    _az_RETURN_IF_FAILED(
+        _az_http_pipeline_prepare_request(pipeline, ref_request, ref_response, 1));
+  }
+
+  *out_request = (az_curl_multi_request){
+    ._internal = {
+      .curl = curl_easy_init(),
+      .headers = NULL,
+      .upload = { 0 },
+      .options = submit_options,
+      .request = ref_request,
+      .response = ref_response,
+      .completion_callback = completion_callback,
+      .user_context = user_context,
+      .previous = NULL,
+      .next = NULL,
+      .start_msec = 0,
+      .retry_at_msec = -1,
+      .attempt = 0,
+    },
+  };
+
+  if (out_request->_internal.curl == NULL)
+  {
+    return AZ_ERROR_HTTP_ADAPTER;
+  }
+
+  az_result const result = _az_curl_multi_start_transfer(ref_multi, out_request);
+  if (az_result_failed(result))
+  {
+    curl_easy_cleanup((CURL*)out_request->_internal.curl);
+    out_request->_internal.curl = NULL;
+    return result;
+  }
+
+  _az_curl_multi_link(ref_multi, out_request);
+  return AZ_OK;
+}
+
+/**
+ * @brief whether any request of a multi handle waits for its retry to be due
+ */
+static bool _az_curl_multi_has_scheduled_retries(az_curl_multi const* multi)
+{
+  for (az_curl_multi_request const* request = multi->_internal.requests; request != NULL;
+       request = request->_internal.next)
+  {
+    if (request->_internal.retry_at_msec >= 0)
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+AZ_NODISCARD az_result
+az_curl_multi_poll(az_curl_multi* ref_multi, int32_t timeout_msec, int32_t* out_pending_count)
+{
+  _az_PRECONDITION_NOT_NULL(ref_multi);
+  _az_PRECONDITION_NOT_NULL(ref_multi->_internal.multi);
+  _az_PRECONDITION(timeout_msec >= 0);
+
+  CURLM* const multi = (CURLM*)ref_multi->_internal.multi;
+  int running = 0;
+
+  if (ref_multi->_internal.pending_count > 0)
+  {
+    if (curl_multi_perform(multi, &running) != CURLM_OK)
+    {
+      return AZ_ERROR_HTTP_ADAPTER;
+    }
+
+    // Don't wait past the time the next retry is due.
+    int64_t wait_msec = timeout_msec;
+    if (_az_curl_multi_has_scheduled_retries(ref_multi))
+    {
+      int64_t now = 0;
+      _az_RETURN_IF_FAILED(az_platform_clock_msec(&now));
+
+      for (az_curl_multi_request const* request = ref_multi->_internal.requests; request != NULL;
+           request = request->_internal.next)
+      {
+        int64_t const retry_at_msec = request->_internal.retry_at_msec;
+        if (retry_at_msec >= 0 && retry_at_msec - now < wait_msec)
+        {
+          wait_msec = retry_at_msec > now ? retry_at_msec - now : 0;
+        }
+      }
+    }
+
+    if (wait_msec > 0)
+    {
+#if LIBCURL_VERSION_NUM >= 0x074200 // curl_multi_poll() was added in 7.66.0
+      // Unlike curl_multi_wait(), curl_multi_poll() also waits when no transfer is running.
+      CURLMcode const code = curl_multi_poll(multi, NULL, 0, (int)wait_msec, NULL);
+#else
+      CURLMcode const code = curl_multi_wait(multi, NULL, 0, (int)wait_msec, NULL);
+#endif
+      if (code != CURLM_OK || curl_multi_perform(multi, &running) != CURLM_OK)
+      {
+        return AZ_ERROR_HTTP_ADAPTER;
+      }
+    }
+  }
+
+  int messages_left = 0;
+  CURLMsg const* message = NULL;
+  while ((message = curl_multi_info_read(multi, &messages_left)) != NULL)
+  {
+    if (message->msg != CURLMSG_DONE)
+    {
+      continue;
+    }
+
+    az_curl_multi_request* request = NULL;
+    (void)curl_easy_getinfo(message->easy_handle, CURLINFO_PRIVATE, (char**)&request);
+    _az_curl_multi_transfer_done(ref_multi, request, message->data.result);
+  }
+
+  // Start the retries which are due. Their transfers make progress on the next poll.
+  int64_t now = -1;
+  if (_az_curl_multi_has_scheduled_retries(ref_multi))
+  {
+    _az_RETURN_IF_FAILED(az_platform_clock_msec(&now));
+  }
+
+  az_curl_multi_request* request = ref_multi->_internal.requests;
+  while (request != NULL)
+  {
+    az_curl_multi_request* const next = request->_internal.next;
+    if (request->_internal.retry_at_msec >= 0 && request->_internal.retry_at_msec <= now)
+    {
+      _az_http_pipeline retry_pipeline = { 0 };
+      az_result result = _az_http_pipeline_prepare_request(
+          _az_curl_multi_get_pipeline(&request->_internal.options, &retry_pipeline),
+          request->_internal.request,
+          request->_internal.response,
+          request->_internal.attempt + 1);
+
+      if (az_result_succeeded(result))
+      {
+        result = _az_curl_multi_start_transfer(ref_multi, request);
+      }
+
+      if (az_result_failed(result))
+      {
+        _az_curl_multi_complete(ref_multi, request, result);
+      }
+    }
+
+    request = next;
+  }
+
+  if (out_pending_count != NULL)
+  {
+    *out_pending_count = ref_multi->_internal.pending_count;
+  }
+
+  return AZ_OK;
+}
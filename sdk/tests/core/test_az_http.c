@@ -957,6 +957,199 @@ static void test_http_response_append_overflow_on_second_call(void** state)
   }
 }
 
+typedef struct
+{
+  uint8_t buffer[32];
+  int32_t written;
+  int32_t segments;
+} test_http_response_body_sink;
+
+static az_result test_http_response_body_callback(az_span body_segment, void* user_context)
+{
+  test_http_response_body_sink* const sink = (test_http_response_body_sink*)user_context;
+  az_span remaining = az_span_slice_to_end(AZ_SPAN_FROM_BUFFER(sink->buffer), sink->written);
+  if (az_span_size(remaining) < az_span_size(body_segment))
+  {
+    return AZ_ERROR_NOT_ENOUGH_SPACE;
+  }
+
+  az_span_copy(remaining, body_segment);
+  sink->written += az_span_size(body_segment);
+  ++sink->segments;
+  return AZ_OK;
+}
+
+static void test_http_response_append_body(void** state)
+{
+  (void)state;
+  {
+    // Without a body callback, the body is appended to the buffer.
+    uint8_t buffer[64];
+    az_http_response response = { 0 };
+    assert_return_code(az_http_response_init(&response, AZ_SPAN_FROM_BUFFER(buffer)), AZ_OK);
+    assert_return_code(
+        az_http_response_append(&response, AZ_SPAN_FROM_STR("HTTP/1.1 200 OK\r\n\r\n")), AZ_OK);
+    assert_return_code(az_http_response_append_body(&response, AZ_SPAN_FROM_STR("{}")), AZ_OK);
+
+    az_http_response_status_line status_line = { 0 };
+    az_span body = AZ_SPAN_EMPTY;
+    assert_return_code(az_http_response_get_status_line(&response, &status_line), AZ_OK);
+    assert_return_code(az_http_response_get_body(&response, &body), AZ_OK);
+    assert_memory_equal(az_span_ptr(body), "{}", 2);
+  }
+  {
+    // With a body callback, only the status line and headers are kept in the buffer, which can be
+    // smaller than the body.
+    uint8_t buffer[40];
+    test_http_response_body_sink sink = { 0 };
+    az_http_response response = { 0 };
+    assert_return_code(az_http_response_init(&response, AZ_SPAN_FROM_BUFFER(buffer)), AZ_OK);
+    az_http_response_set_body_callback(&response, test_http_response_body_callback, &sink);
+
+    assert_return_code(
+        az_http_response_append(
+            &response, AZ_SPAN_FROM_STR("HTTP/1.1 200 OK\r\nContent-Length: 27\r\n\r\n")),
+        AZ_OK);
+    assert_return_code(
+        az_http_response_append_body(&response, AZ_SPAN_FROM_STR("{\"name\":\"abcdefghij")), AZ_OK);
+    assert_return_code(
+        az_http_response_append_body(&response, AZ_SPAN_FROM_STR("klmnop\"}")), AZ_OK);
+
+    assert_int_equal(sink.segments, 2);
+    assert_int_equal(sink.written, 27);
+    assert_memory_equal(sink.buffer, "{\"name\":\"abcdefghijklmnop\"}", 27);
+
+    az_http_response_status_line status_line = { 0 };
+    az_span header_name = AZ_SPAN_EMPTY;
+    az_span header_value = AZ_SPAN_EMPTY;
+    az_span body = AZ_SPAN_EMPTY;
+    assert_return_code(az_http_response_get_status_line(&response, &status_line), AZ_OK);
+    assert_int_equal(status_line.status_code, AZ_HTTP_STATUS_CODE_OK);
+    assert_return_code(
+        az_http_response_get_next_header(&response, &header_name, &header_value), AZ_OK);
+    assert_return_code(az_http_response_get_body(&response, &body), AZ_OK);
+    assert_int_equal(az_span_size(body), 0);
+
+    // A failed callback fails the append.
+    assert_int_equal(
+        az_http_response_append_body(&response, AZ_SPAN_FROM_STR("0123456789")),
+        AZ_ERROR_NOT_ENOUGH_SPACE);
+
+    // Resetting the response for the next attempt keeps the callback.
+    _az_http_response_reset(&response);
+    assert_ptr_equal(response._internal.body_callback, test_http_response_body_callback);
+    assert_ptr_equal(response._internal.body_callback_context, &sink);
+  }
+}
+
+static az_result test_http_request_body_callback(
+    int64_t offset,
+    az_span* out_segment,
+    void* user_context)
+{
+  // Provides the body 4 bytes at a time.
+  az_span const body = *(az_span*)user_context;
+  int32_t const start = (int32_t)offset;
+  int32_t const end = start + 4 < az_span_size(body) ? start + 4 : az_span_size(body);
+  *out_segment = az_span_slice(body, start, end);
+  return AZ_OK;
+}
+
+static az_result test_http_request_body_callback_failed(
+    int64_t offset,
+    az_span* out_segment,
+    void* user_context)
+{
+  (void)offset;
+  (void)out_segment;
+  (void)user_context;
+  return AZ_ERROR_NOT_ENOUGH_SPACE;
+}
+
+static void test_http_request_get_body_segment(void** state)
+{
+  (void)state;
+  uint8_t header_buf[(2 * sizeof(_az_http_request_header))];
+  az_span const url = AZ_SPAN_FROM_STR("https://antk.azure.com");
+  {
+    // Without a body callback, the segment is the rest of the body span.
+    az_http_request request = { 0 };
+    assert_return_code(
+        az_http_request_init(
+            &request,
+            &az_context_application,
+            az_http_method_put(),
+            url,
+            az_span_size(url),
+            AZ_SPAN_FROM_BUFFER(header_buf),
+            AZ_SPAN_FROM_STR("{\"a\":1}")),
+        AZ_OK);
+
+    int64_t body_size = 0;
+    az_span segment = AZ_SPAN_EMPTY;
+    assert_return_code(az_http_request_get_body_size(&request, &body_size), AZ_OK);
+    assert_true(body_size == 7);
+    assert_return_code(az_http_request_get_body_segment(&request, 0, &segment), AZ_OK);
+    assert_true(az_span_is_content_equal(segment, AZ_SPAN_FROM_STR("{\"a\":1}")));
+    assert_return_code(az_http_request_get_body_segment(&request, 5, &segment), AZ_OK);
+    assert_true(az_span_is_content_equal(segment, AZ_SPAN_FROM_STR("1}")));
+    assert_return_code(az_http_request_get_body_segment(&request, 7, &segment), AZ_OK);
+    assert_int_equal(az_span_size(segment), 0);
+  }
+  {
+    // With a body callback, the segments come from it.
+    az_span body = AZ_SPAN_FROM_STR("{\"name\":\"abc\"}");
+    az_http_request request = { 0 };
+    assert_return_code(
+        az_http_request_init(
+            &request,
+            &az_context_application,
+            az_http_method_post(),
+            url,
+            az_span_size(url),
+            AZ_SPAN_FROM_BUFFER(header_buf),
+            AZ_SPAN_FROM_STR("ignored")),
+        AZ_OK);
+    assert_return_code(
+        az_http_request_set_body_callback(&request, test_http_request_body_callback, -1, &body),
+        AZ_OK);
+
+    int64_t body_size = 0;
+    az_span request_body = AZ_SPAN_EMPTY;
+    assert_return_code(az_http_request_get_body_size(&request, &body_size), AZ_OK);
+    assert_true(body_size == -1);
+    assert_return_code(az_http_request_get_body(&request, &request_body), AZ_OK);
+    assert_int_equal(az_span_size(request_body), 0);
+
+    uint8_t sent_buf[32];
+    az_span sent = AZ_SPAN_FROM_BUFFER(sent_buf);
+    int64_t offset = 0;
+    int32_t segments = 0;
+    az_span segment = AZ_SPAN_EMPTY;
+    do
+    {
+      assert_return_code(az_http_request_get_body_segment(&request, offset, &segment), AZ_OK);
+      sent = az_span_copy(sent, segment);
+      offset += az_span_size(segment);
+      ++segments;
+    } while (az_span_size(segment) > 0);
+
+    assert_int_equal(segments, 5);
+    assert_true(offset == az_span_size(body));
+    assert_memory_equal(sent_buf, az_span_ptr(body), (size_t)az_span_size(body));
+
+    // A failed callback fails getting the segment.
+    assert_return_code(
+        az_http_request_set_body_callback(
+            &request, test_http_request_body_callback_failed, 10, NULL),
+        AZ_OK);
+    assert_return_code(az_http_request_get_body_size(&request, &body_size), AZ_OK);
+    assert_true(body_size == 10);
+    assert_int_equal(
+        az_http_request_get_body_segment(&request, 0, &segment), AZ_ERROR_NOT_ENOUGH_SPACE);
+  }
+}
+
 int test_az_http()
 {
 #ifndef AZ_NO_PRECONDITION_CHECKING
@@ -979,6 +1172,8 @@ int test_az_http()
     cmocka_unit_test(test_http_response_append_overflow),
     cmocka_unit_test(test_http_response_append),
     cmocka_unit_test(test_http_response_append_overflow_on_second_call),
+    cmocka_unit_test(test_http_response_append_body),
+    cmocka_unit_test(test_http_request_get_body_segment),
   };
   return cmocka_run_group_tests_name("az_core_http", tests, NULL, NULL);
 }
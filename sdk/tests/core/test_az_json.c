@@ -659,7 +659,7 @@ static void test_json_writer_chunked(void** state)
     uint8_t array[200] = { 0 };
 
     az_span_to_str((char*)array, 200, az_json_writer_get_bytes_used_in_destination(&writer));
-    assert_string_equal(array, ",-12.3]}");
+    assert_string_equal(array, "}");
 
     az_span_to_str(
         (char*)array,
@@ -2822,6 +2822,1615 @@ static void test_az_json_reader_chunked(void** state)
   assert_true(az_span_is_content_equal(expected, az_span_create_from_str(m.name_string)));
 }
 
+static void test_json_writer_append_double_shortest(void** state)
+{
+  (void)state;
+
+  uint8_t array[200] = { 0 };
+  az_json_writer writer = { 0 };
+  TEST_EXPECT_SUCCESS(az_json_writer_init(&writer, AZ_SPAN_FROM_BUFFER(array), NULL));
+
+  TEST_EXPECT_SUCCESS(az_json_writer_append_begin_array(&writer));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_double_shortest(&writer, 23.5));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_double_shortest(&writer, -0.1));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_double_shortest(&writer, 1e21));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_double_shortest(&writer, 1.5e-7));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_double_shortest(&writer, 0.1 + 0.2));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_end_array(&writer));
+
+  assert_true(az_span_is_content_equal(
+      az_json_writer_get_bytes_used_in_destination(&writer),
+      AZ_SPAN_FROM_STR("[23.5,-0.1,1e+21,1.5e-7,0.30000000000000004]")));
+
+  // Every value is read back exactly.
+  double const expected[] = { 23.5, -0.1, 1e21, 1.5e-7, 0.1 + 0.2 };
+  az_json_reader reader = { 0 };
+  TEST_EXPECT_SUCCESS(
+      az_json_reader_init(&reader, az_json_writer_get_bytes_used_in_destination(&writer), NULL));
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  for (size_t i = 0; i < sizeof(expected) / sizeof(expected[0]); i++)
+  {
+    double value = 0;
+    TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+    TEST_EXPECT_SUCCESS(az_json_token_get_double(&reader.token, &value));
+    assert_memory_equal(&value, &expected[i], sizeof(double));
+  }
+
+  // Only the space for the digits written is required, not for the largest number (25 bytes).
+  az_span const destination = AZ_SPAN_FROM_BUFFER(array);
+  TEST_EXPECT_SUCCESS(az_json_writer_init(&writer, az_span_slice(destination, 0, 5), NULL));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_begin_array(&writer));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_double_shortest(&writer, 0.5));
+  assert_int_equal(az_json_writer_append_double_shortest(&writer, 1), AZ_ERROR_NOT_ENOUGH_SPACE);
+  assert_true(az_span_is_content_equal(
+      az_json_writer_get_bytes_used_in_destination(&writer), AZ_SPAN_FROM_STR("[0.5")));
+}
+
+static void test_json_writer_escape_long_strings(void** state)
+{
+  (void)state;
+
+  // Characters to escape at the start, on block boundaries, and within the trailing bytes.
+  az_span const value = AZ_SPAN_LITERAL_FROM_STR("\"abcdefghijklmnopqrstuvwxyz0123\n"
+                                                 "abcdefghijklmnopqrstuvwxyz01234\x01"
+                                                 "abcdefghijklmnopqrstuvwxyz\\");
+  az_span const expected = AZ_SPAN_LITERAL_FROM_STR("{\"\\\"abcdefghijklmnopqrstuvwxyz0123\\n"
+                                                    "abcdefghijklmnopqrstuvwxyz01234\\u0001"
+                                                    "abcdefghijklmnopqrstuvwxyz\\\\\":"
+                                                    "\"\\\"abcdefghijklmnopqrstuvwxyz0123\\n"
+                                                    "abcdefghijklmnopqrstuvwxyz01234\\u0001"
+                                                    "abcdefghijklmnopqrstuvwxyz\\\\\"}");
+
+  // The first destination has room for the worst case, where every character needs the longest
+  // escape sequence, while the second one only fits the output and the 64 bytes which long strings
+  // require to be available while they are written.
+  uint8_t array[1024] = { 0 };
+  az_span const destinations[] = {
+    AZ_SPAN_FROM_BUFFER(array),
+    az_span_slice(AZ_SPAN_FROM_BUFFER(array), 0, az_span_size(expected) + 64),
+  };
+
+  for (size_t i = 0; i < sizeof(destinations) / sizeof(destinations[0]); i++)
+  {
+    az_json_writer writer = { 0 };
+    TEST_EXPECT_SUCCESS(az_json_writer_init(&writer, destinations[i], NULL));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_begin_object(&writer));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_property_name(&writer, value));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_string(&writer, value));
+    TEST_EXPECT_SUCCESS(az_json_writer_append_end_object(&writer));
+
+    assert_true(
+        az_span_is_content_equal(az_json_writer_get_bytes_used_in_destination(&writer), expected));
+    assert_int_equal(writer._internal.total_bytes_written, az_span_size(expected));
+  }
+}
+
+typedef struct
+{
+  az_span output;
+  az_span const* buffers;
+  int32_t flush_count;
+  bool fail;
+} _az_flush_context;
+
+static az_result test_flush(void* user_context, az_span json_chunk)
+{
+  _az_flush_context* context = (_az_flush_context*)user_context;
+  if (context->fail)
+  {
+    return AZ_ERROR_NOT_SUPPORTED;
+  }
+
+  // The buffers are used in turn.
+  assert_ptr_equal(
+      az_span_ptr(json_chunk), az_span_ptr(context->buffers[context->flush_count % 3]));
+  context->output = az_span_copy(context->output, json_chunk);
+  context->flush_count++;
+  return AZ_OK;
+}
+
+static az_result test_json_writer_write_document(az_json_writer* ref_json_writer)
+{
+  _az_RETURN_IF_FAILED(az_json_writer_append_begin_object(ref_json_writer));
+  for (int32_t i = 0; i < 10; i++)
+  {
+    _az_RETURN_IF_FAILED(
+        az_json_writer_append_property_name(ref_json_writer, AZ_SPAN_FROM_STR("a")));
+    _az_RETURN_IF_FAILED(az_json_writer_append_begin_array(ref_json_writer));
+    _az_RETURN_IF_FAILED(az_json_writer_append_int32(ref_json_writer, i * 1000));
+    _az_RETURN_IF_FAILED(az_json_writer_append_double(ref_json_writer, 1.25, 2));
+    _az_RETURN_IF_FAILED(az_json_writer_append_string(
+        ref_json_writer, AZ_SPAN_FROM_STR("a string which is longer than ten \"bytes\"")));
+    _az_RETURN_IF_FAILED(az_json_writer_append_null(ref_json_writer));
+    _az_RETURN_IF_FAILED(az_json_writer_append_end_array(ref_json_writer));
+  }
+  return az_json_writer_append_end_object(ref_json_writer);
+}
+
+static void test_json_writer_buffered(void** state)
+{
+  (void)state;
+
+  uint8_t expected_array[1024] = { 0 };
+  az_json_writer writer = { 0 };
+  TEST_EXPECT_SUCCESS(az_json_writer_init(&writer, AZ_SPAN_FROM_BUFFER(expected_array), NULL));
+  TEST_EXPECT_SUCCESS(test_json_writer_write_document(&writer));
+  az_span const expected = az_json_writer_get_bytes_used_in_destination(&writer);
+
+  uint8_t buffer_array[3][64] = { { 0 } };
+  az_span const buffers[] = {
+    AZ_SPAN_FROM_BUFFER(buffer_array[0]),
+    AZ_SPAN_FROM_BUFFER(buffer_array[1]),
+    AZ_SPAN_FROM_BUFFER(buffer_array[2]),
+  };
+
+  uint8_t output_array[1024] = { 0 };
+  _az_flush_context context = {
+    .output = AZ_SPAN_FROM_BUFFER(output_array),
+    .buffers = buffers,
+    .flush_count = 0,
+    .fail = false,
+  };
+
+  TEST_EXPECT_SUCCESS(
+      az_json_writer_buffered_init(&writer, buffers, 3, test_flush, &context, NULL));
+  TEST_EXPECT_SUCCESS(test_json_writer_write_document(&writer));
+
+  // The last chunk is only handed to the callback when flushing explicitly.
+  int32_t const flush_count = context.flush_count;
+  assert_true(flush_count > 3);
+  TEST_EXPECT_SUCCESS(az_json_writer_flush(&writer));
+  assert_int_equal(context.flush_count, flush_count + 1);
+  TEST_EXPECT_SUCCESS(az_json_writer_flush(&writer));
+  assert_int_equal(context.flush_count, flush_count + 1);
+
+  az_span const output = az_span_slice(
+      AZ_SPAN_FROM_BUFFER(output_array),
+      0,
+      _az_span_diff(context.output, AZ_SPAN_FROM_BUFFER(output_array)));
+  assert_true(az_span_is_content_equal(output, expected));
+  assert_int_equal(writer._internal.total_bytes_written, az_span_size(expected));
+
+  // A failure to flush means there is no space left to write into.
+  context.fail = true;
+  TEST_EXPECT_SUCCESS(
+      az_json_writer_buffered_init(&writer, buffers, 3, test_flush, &context, NULL));
+  assert_int_equal(test_json_writer_write_document(&writer), AZ_ERROR_NOT_ENOUGH_SPACE);
+}
+
+static az_result test_json_writer_write_values(az_json_writer* ref_json_writer)
+{
+  _az_RETURN_IF_FAILED(az_json_writer_append_begin_array(ref_json_writer));
+  _az_RETURN_IF_FAILED(az_json_writer_append_bool(ref_json_writer, true));
+  _az_RETURN_IF_FAILED(az_json_writer_append_double_shortest(ref_json_writer, 0.1));
+  _az_RETURN_IF_FAILED(az_json_writer_append_int32(ref_json_writer, INT32_MIN));
+  _az_RETURN_IF_FAILED(
+      az_json_writer_append_json_text(ref_json_writer, AZ_SPAN_FROM_STR("{\"a\": [1, 2]}")));
+  _az_RETURN_IF_FAILED(az_json_writer_append_string(ref_json_writer, AZ_SPAN_FROM_STR("\b\x1f")));
+  _az_RETURN_IF_FAILED(az_json_writer_append_string(ref_json_writer, AZ_SPAN_EMPTY));
+  return az_json_writer_append_end_array(ref_json_writer);
+}
+
+static az_result test_json_writer_write_telemetry(az_json_writer* ref_json_writer)
+{
+  _az_RETURN_IF_FAILED(az_json_writer_append_begin_object(ref_json_writer));
+  _az_RETURN_IF_FAILED(
+      az_json_writer_append_property_name(ref_json_writer, AZ_SPAN_FROM_STR("temp")));
+  _az_RETURN_IF_FAILED(az_json_writer_append_double(ref_json_writer, 21.5, 1));
+  _az_RETURN_IF_FAILED(az_json_writer_append_property_name(ref_json_writer, AZ_SPAN_FROM_STR("n")));
+  _az_RETURN_IF_FAILED(az_json_writer_append_int32(ref_json_writer, 7));
+  _az_RETURN_IF_FAILED(az_json_writer_append_property_name(
+      ref_json_writer, AZ_SPAN_FROM_STR("a property name longer than a chunk")));
+  _az_RETURN_IF_FAILED(az_json_writer_append_string(
+      ref_json_writer, AZ_SPAN_FROM_STR("a \"quoted\" string longer than a chunk\n")));
+  _az_RETURN_IF_FAILED(az_json_writer_append_property_name(ref_json_writer, AZ_SPAN_FROM_STR("x")));
+  _az_RETURN_IF_FAILED(az_json_writer_append_double_shortest(ref_json_writer, 0.5));
+  _az_RETURN_IF_FAILED(az_json_writer_append_property_name(ref_json_writer, AZ_SPAN_FROM_STR("y")));
+  _az_RETURN_IF_FAILED(
+      az_json_writer_append_json_text(ref_json_writer, AZ_SPAN_FROM_STR("[1, 2, 3, 4, 5, 6, 7]")));
+  return az_json_writer_append_end_object(ref_json_writer);
+}
+
+static void test_json_writer_measure(void** state)
+{
+  (void)state;
+
+  az_result (*const write_functions[])(az_json_writer*) = {
+    test_json_writer_write_document,
+    test_json_writer_write_values,
+    test_json_writer_write_telemetry,
+  };
+
+  az_json_writer_options options = az_json_writer_options_default();
+
+  for (int32_t indentation = 0; indentation <= 2; indentation += 2)
+  {
+    options.indentation = indentation;
+
+    for (size_t i = 0; i < sizeof(write_functions) / sizeof(write_functions[0]); i++)
+    {
+      az_json_writer writer = { 0 };
+      TEST_EXPECT_SUCCESS(az_json_writer_measure_init(&writer, &options));
+      TEST_EXPECT_SUCCESS(write_functions[i](&writer));
+      int32_t const size = az_json_writer_get_total_bytes_written(&writer);
+      assert_int_equal(az_span_size(az_json_writer_get_bytes_used_in_destination(&writer)), 0);
+
+      // The JSON text fits in a buffer of exactly the measured size, and no smaller.
+      uint8_t array[1024] = { 0 };
+      assert_true(size <= (int32_t)sizeof(array));
+      TEST_EXPECT_SUCCESS(az_json_writer_init(
+          &writer, az_span_slice(AZ_SPAN_FROM_BUFFER(array), 0, size), &options));
+      TEST_EXPECT_SUCCESS(write_functions[i](&writer));
+      assert_int_equal(az_span_size(az_json_writer_get_bytes_used_in_destination(&writer)), size);
+
+      TEST_EXPECT_SUCCESS(az_json_writer_init(
+          &writer, az_span_slice(AZ_SPAN_FROM_BUFFER(array), 0, size - 1), &options));
+      assert_int_equal(write_functions[i](&writer), AZ_ERROR_NOT_ENOUGH_SPACE);
+    }
+  }
+
+  // Numbers only take as much space as their digits, not the longest number of their type.
+  az_json_writer writer = { 0 };
+  uint8_t array[19] = { 0 };
+  TEST_EXPECT_SUCCESS(az_json_writer_init(&writer, AZ_SPAN_FROM_BUFFER(array), NULL));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_begin_object(&writer));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_property_name(&writer, AZ_SPAN_FROM_STR("temp")));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_double(&writer, 21.5, 1));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_property_name(&writer, AZ_SPAN_FROM_STR("n")));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_int32(&writer, 7));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_end_object(&writer));
+  assert_true(az_span_is_content_equal(
+      az_json_writer_get_bytes_used_in_destination(&writer),
+      AZ_SPAN_FROM_STR("{\"temp\":21.5,\"n\":7}")));
+
+  // The JSON text is still validated.
+  TEST_EXPECT_SUCCESS(az_json_writer_measure_init(&writer, NULL));
+  assert_int_equal(
+      az_json_writer_append_json_text(&writer, AZ_SPAN_FROM_STR("{\"a\":")),
+      AZ_ERROR_UNEXPECTED_END);
+  assert_int_equal(az_json_writer_get_total_bytes_written(&writer), 0);
+}
+
+typedef struct
+{
+  az_span output;
+  int32_t start;
+  int32_t max_required_size;
+} _az_contiguous_allocator_context;
+
+// Hands out the exact size required, right after the bytes used in the previous destination, so
+// that the JSON text ends up contiguous in the output.
+static az_result test_allocator_contiguous(
+    az_span_allocator_context* allocator_context,
+    az_span* out_next_destination)
+{
+  _az_contiguous_allocator_context* context
+      = (_az_contiguous_allocator_context*)allocator_context->user_context;
+  context->start += allocator_context->bytes_used;
+  if (allocator_context->minimum_required_size > context->max_required_size)
+  {
+    context->max_required_size = allocator_context->minimum_required_size;
+  }
+
+  *out_next_destination = az_span_slice(
+      context->output, context->start, context->start + allocator_context->minimum_required_size);
+  return AZ_OK;
+}
+
+static az_result test_json_writer_write_large_indented_values(
+    az_json_writer* ref_json_writer,
+    az_span long_string,
+    az_span long_json_text)
+{
+  _az_RETURN_IF_FAILED(az_json_writer_append_begin_object(ref_json_writer));
+  _az_RETURN_IF_FAILED(az_json_writer_append_property_name(ref_json_writer, long_string));
+  _az_RETURN_IF_FAILED(az_json_writer_append_begin_array(ref_json_writer));
+  _az_RETURN_IF_FAILED(az_json_writer_append_string(ref_json_writer, long_string));
+  _az_RETURN_IF_FAILED(az_json_writer_append_json_text(ref_json_writer, long_json_text));
+  _az_RETURN_IF_FAILED(az_json_writer_append_int32(ref_json_writer, 1));
+  _az_RETURN_IF_FAILED(az_json_writer_append_end_array(ref_json_writer));
+  return az_json_writer_append_end_object(ref_json_writer);
+}
+
+static void test_json_writer_indentation_chunked(void** state)
+{
+  (void)state;
+
+  az_json_writer_options options = az_json_writer_options_default();
+  options.indentation = 2;
+
+  uint8_t string_array[150] = { 0 };
+  az_span const long_string = AZ_SPAN_FROM_BUFFER(string_array);
+  az_span_fill(long_string, 'a');
+  string_array[75] = '\n';
+
+  uint8_t json_text_array[120] = { 0 };
+  az_span const long_json_text = AZ_SPAN_FROM_BUFFER(json_text_array);
+  az_span_fill(long_json_text, 'b');
+  json_text_array[0] = '"';
+  json_text_array[sizeof(json_text_array) - 1] = '"';
+
+  uint8_t expected_array[1024] = { 0 };
+  az_json_writer writer = { 0 };
+  TEST_EXPECT_SUCCESS(az_json_writer_init(&writer, AZ_SPAN_FROM_BUFFER(expected_array), &options));
+  TEST_EXPECT_SUCCESS(
+      test_json_writer_write_large_indented_values(&writer, long_string, long_json_text));
+  az_span const expected = az_json_writer_get_bytes_used_in_destination(&writer);
+
+  // The allocator is only asked for buffers of the minimum chunk size, even for the large tokens
+  // that follow the white space.
+  uint8_t output_array[1024] = { 0 };
+  _az_contiguous_allocator_context context = {
+    .output = AZ_SPAN_FROM_BUFFER(output_array),
+    .start = 0,
+    .max_required_size = 0,
+  };
+  TEST_EXPECT_SUCCESS(az_json_writer_chunked_init(
+      &writer, AZ_SPAN_EMPTY, test_allocator_contiguous, &context, &options));
+  TEST_EXPECT_SUCCESS(
+      test_json_writer_write_large_indented_values(&writer, long_string, long_json_text));
+  assert_true(context.max_required_size <= 64);
+
+  az_span const last_chunk = az_json_writer_get_bytes_used_in_destination(&writer);
+  az_span const output = az_span_slice(context.output, 0, context.start + az_span_size(last_chunk));
+  assert_true(az_span_is_content_equal(output, expected));
+  assert_int_equal(writer._internal.total_bytes_written, az_span_size(expected));
+}
+
+static void test_json_writer_indentation_not_enough_space(void** state)
+{
+  (void)state;
+
+  az_json_writer_options options = az_json_writer_options_default();
+  options.indentation = 2;
+
+  uint8_t array[14] = { 0 };
+  az_json_writer writer = { 0 };
+  TEST_EXPECT_SUCCESS(az_json_writer_init(&writer, AZ_SPAN_FROM_BUFFER(array), &options));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_begin_array(&writer));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_string(&writer, AZ_SPAN_FROM_STR("hello")));
+
+  // A failed append doesn't write the white space that goes before the token either.
+  az_span const expected = AZ_SPAN_FROM_STR("[\n  \"hello\"");
+  assert_int_equal(az_json_writer_append_int32(&writer, 1), AZ_ERROR_NOT_ENOUGH_SPACE);
+  assert_true(
+      az_span_is_content_equal(az_json_writer_get_bytes_used_in_destination(&writer), expected));
+  assert_int_equal(az_json_writer_append_double(&writer, 1.5, 1), AZ_ERROR_NOT_ENOUGH_SPACE);
+  assert_int_equal(az_json_writer_append_double_shortest(&writer, 1.5), AZ_ERROR_NOT_ENOUGH_SPACE);
+  assert_int_equal(az_json_writer_append_null(&writer), AZ_ERROR_NOT_ENOUGH_SPACE);
+  assert_int_equal(
+      az_json_writer_append_string(&writer, AZ_SPAN_FROM_STR("x")), AZ_ERROR_NOT_ENOUGH_SPACE);
+  assert_int_equal(
+      az_json_writer_append_json_text(&writer, AZ_SPAN_FROM_STR("1")), AZ_ERROR_NOT_ENOUGH_SPACE);
+  assert_int_equal(az_json_writer_append_begin_object(&writer), AZ_ERROR_NOT_ENOUGH_SPACE);
+  assert_true(
+      az_span_is_content_equal(az_json_writer_get_bytes_used_in_destination(&writer), expected));
+
+  TEST_EXPECT_SUCCESS(az_json_writer_append_end_array(&writer));
+  assert_true(az_span_is_content_equal(
+      az_json_writer_get_bytes_used_in_destination(&writer),
+      AZ_SPAN_FROM_STR("[\n  \"hello\"\n]")));
+
+  // The same goes for a property name.
+  TEST_EXPECT_SUCCESS(
+      az_json_writer_init(&writer, az_span_slice(AZ_SPAN_FROM_BUFFER(array), 0, 8), &options));
+  TEST_EXPECT_SUCCESS(az_json_writer_append_begin_object(&writer));
+  assert_int_equal(
+      az_json_writer_append_property_name(&writer, AZ_SPAN_FROM_STR("abc")),
+      AZ_ERROR_NOT_ENOUGH_SPACE);
+  TEST_EXPECT_SUCCESS(az_json_writer_append_end_object(&writer));
+  assert_true(az_span_is_content_equal(
+      az_json_writer_get_bytes_used_in_destination(&writer), AZ_SPAN_FROM_STR("{}")));
+}
+
+static void test_json_writer_transcode(void** state)
+{
+  (void)state;
+
+  az_span const pretty = AZ_SPAN_LITERAL_FROM_STR("{\n"
+                                                  "  \"name\": \"a\\\"b\\u00e9\",\n"
+                                                  "  \"values\": [\n"
+                                                  "    1.50,\n"
+                                                  "    -2e3,\n"
+                                                  "    true,\n"
+                                                  "    null\n"
+                                                  "  ],\n"
+                                                  "  \"empty\": {},\n"
+                                                  "  \"nested\": {\n"
+                                                  "    \"list\": []\n"
+                                                  "  }\n"
+                                                  "}");
+  az_span const minified = AZ_SPAN_LITERAL_FROM_STR(
+      "{\"name\":\"a\\\"b\\u00e9\",\"values\":[1.50,-2e3,true,null],\"empty\":{},"
+      "\"nested\":{\"list\":[]}}");
+
+  uint8_t array[200] = { 0 };
+  az_json_writer writer = { 0 };
+  az_json_reader reader = { 0 };
+
+  // Minify, keeping the escapes and numbers as they are in the JSON text.
+  TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, pretty, NULL));
+  TEST_EXPECT_SUCCESS(az_json_writer_init(&writer, AZ_SPAN_FROM_BUFFER(array), NULL));
+  TEST_EXPECT_SUCCESS(az_json_writer_transcode(&writer, &reader));
+  assert_true(
+      az_span_is_content_equal(az_json_writer_get_bytes_used_in_destination(&writer), minified));
+  assert_int_equal(az_json_reader_next_token(&reader), AZ_ERROR_JSON_READER_DONE);
+
+  // Pretty-print.
+  az_json_writer_options options = az_json_writer_options_default();
+  options.indentation = 2;
+  TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, minified, NULL));
+  TEST_EXPECT_SUCCESS(az_json_writer_init(&writer, AZ_SPAN_FROM_BUFFER(array), &options));
+  TEST_EXPECT_SUCCESS(az_json_writer_transcode(&writer, &reader));
+  assert_true(
+      az_span_is_content_equal(az_json_writer_get_bytes_used_in_destination(&writer), pretty));
+
+  // The measured size of indented JSON includes the white space.
+  TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, minified, NULL));
+  TEST_EXPECT_SUCCESS(az_json_writer_measure_init(&writer, &options));
+  TEST_EXPECT_SUCCESS(az_json_writer_transcode(&writer, &reader));
+  assert_int_equal(az_json_writer_get_total_bytes_written(&writer), az_span_size(pretty));
+
+  // Copy a single property value, from tokens that straddle non-contiguous buffers.
+  az_span buffers[] = {
+    az_span_slice(minified, 0, 32),
+    az_span_slice(minified, 32, 34),
+    az_span_slice_to_end(minified, 34),
+  };
+  TEST_EXPECT_SUCCESS(az_json_reader_chunked_init(&reader, buffers, 3, NULL));
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  TEST_EXPECT_SUCCESS(az_json_writer_init(&writer, AZ_SPAN_FROM_BUFFER(array), NULL));
+  TEST_EXPECT_SUCCESS(az_json_writer_transcode(&writer, &reader));
+  assert_true(az_span_is_content_equal(
+      az_json_writer_get_bytes_used_in_destination(&writer),
+      AZ_SPAN_FROM_STR("[1.50,-2e3,true,null]")));
+  assert_int_equal(reader.token.kind, AZ_JSON_TOKEN_END_ARRAY);
+}
+
+static az_result test_json_read_all(az_span json_text)
+{
+  az_json_reader reader = { 0 };
+  _az_RETURN_IF_FAILED(az_json_reader_init(&reader, json_text, NULL));
+
+  az_result result = AZ_OK;
+  while (az_result_succeeded(result = az_json_reader_next_token(&reader)))
+  {
+  }
+  return result == AZ_ERROR_JSON_READER_DONE ? AZ_OK : result;
+}
+
+static void test_az_json_validate(void** state)
+{
+  (void)state;
+
+  // The validator and the reader agree on all of these.
+  az_span const json_texts[] = {
+    AZ_SPAN_LITERAL_FROM_STR("{\"a\":[1,-2.5e+3,true,false,null,\"\\u00e9\\n\"],\"b\":{}}"),
+    AZ_SPAN_LITERAL_FROM_STR(" [ ] "),
+    AZ_SPAN_LITERAL_FROM_STR("0"),
+    AZ_SPAN_LITERAL_FROM_STR("\"caf\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80\""),
+    AZ_SPAN_LITERAL_FROM_STR("   "),
+    AZ_SPAN_LITERAL_FROM_STR("{"),
+    AZ_SPAN_LITERAL_FROM_STR("{\"a\""),
+    AZ_SPAN_LITERAL_FROM_STR("{\"a\":1"),
+    AZ_SPAN_LITERAL_FROM_STR("{\"a\" 1}"),
+    AZ_SPAN_LITERAL_FROM_STR("{1:1}"),
+    AZ_SPAN_LITERAL_FROM_STR("{\"a\":1,}"),
+    AZ_SPAN_LITERAL_FROM_STR("[1,]"),
+    AZ_SPAN_LITERAL_FROM_STR("[1 2]"),
+    AZ_SPAN_LITERAL_FROM_STR("[1}"),
+    AZ_SPAN_LITERAL_FROM_STR("[1"),
+    AZ_SPAN_LITERAL_FROM_STR("1 2"),
+    AZ_SPAN_LITERAL_FROM_STR("01"),
+    AZ_SPAN_LITERAL_FROM_STR("-"),
+    AZ_SPAN_LITERAL_FROM_STR("1."),
+    AZ_SPAN_LITERAL_FROM_STR("1.e1"),
+    AZ_SPAN_LITERAL_FROM_STR("1e"),
+    AZ_SPAN_LITERAL_FROM_STR("1e+"),
+    AZ_SPAN_LITERAL_FROM_STR("1e "),
+    AZ_SPAN_LITERAL_FROM_STR("[1e ]"),
+    AZ_SPAN_LITERAL_FROM_STR("[1E,2]"),
+    AZ_SPAN_LITERAL_FROM_STR("[1.5e]"),
+    AZ_SPAN_LITERAL_FROM_STR("[1e- ]"),
+    AZ_SPAN_LITERAL_FROM_STR("[1e5 ,-2E+0]"),
+    AZ_SPAN_LITERAL_FROM_STR("tru"),
+    AZ_SPAN_LITERAL_FROM_STR("trux"),
+    AZ_SPAN_LITERAL_FROM_STR("nul"),
+    AZ_SPAN_LITERAL_FROM_STR("\"abc"),
+    AZ_SPAN_LITERAL_FROM_STR("\"a\\x\""),
+    AZ_SPAN_LITERAL_FROM_STR("\"a\\u12G4\""),
+    AZ_SPAN_LITERAL_FROM_STR("\"a\tb\""),
+    AZ_SPAN_LITERAL_FROM_STR("]"),
+  };
+
+  for (size_t i = 0; i < sizeof(json_texts) / sizeof(json_texts[0]); i++)
+  {
+    assert_int_equal(az_json_validate(json_texts[i]), test_json_read_all(json_texts[i]));
+  }
+
+  assert_int_equal(az_json_validate(AZ_SPAN_EMPTY), AZ_ERROR_UNEXPECTED_END);
+
+  // An exponent must have at least one digit.
+  assert_int_equal(az_json_validate(AZ_SPAN_FROM_STR("[1e ]")), AZ_ERROR_UNEXPECTED_CHAR);
+  assert_int_equal(test_json_read_all(AZ_SPAN_FROM_STR("[1e ]")), AZ_ERROR_UNEXPECTED_CHAR);
+  az_span exponent_buffers[] = { AZ_SPAN_FROM_STR("[1e"), AZ_SPAN_FROM_STR("]") };
+  az_json_reader reader = { 0 };
+  TEST_EXPECT_SUCCESS(az_json_reader_chunked_init(&reader, exponent_buffers, 2, NULL));
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  assert_int_equal(az_json_reader_next_token(&reader), AZ_ERROR_UNEXPECTED_CHAR);
+
+  // The reader doesn't validate UTF-8, but the validator does.
+  az_span const invalid_utf8[] = {
+    AZ_SPAN_LITERAL_FROM_STR("\"\x80\""), // Unexpected continuation byte.
+    AZ_SPAN_LITERAL_FROM_STR("\"\xC0\xAF\""), // Overlong encoding.
+    AZ_SPAN_LITERAL_FROM_STR("\"\xE0\x80\xAF\""), // Overlong encoding.
+    AZ_SPAN_LITERAL_FROM_STR("\"\xED\xA0\x80\""), // UTF-16 surrogate.
+    AZ_SPAN_LITERAL_FROM_STR("\"\xF4\x90\x80\x80\""), // Larger than U+10FFFF.
+    AZ_SPAN_LITERAL_FROM_STR("\"\xE2\x82\""), // Missing continuation byte.
+    AZ_SPAN_LITERAL_FROM_STR("{\"\xFF\":1}"),
+  };
+
+  for (size_t i = 0; i < sizeof(invalid_utf8) / sizeof(invalid_utf8[0]); i++)
+  {
+    TEST_EXPECT_SUCCESS(test_json_read_all(invalid_utf8[i]));
+    assert_int_equal(az_json_validate(invalid_utf8[i]), AZ_ERROR_UNEXPECTED_CHAR);
+  }
+  assert_int_equal(
+      az_json_validate(AZ_SPAN_FROM_STR("\"\xF0\x9F\x98")), AZ_ERROR_UNEXPECTED_END);
+
+  // Long strings take the vectorized path, and every multibyte sequence is still checked.
+  uint8_t array[300] = { 0 };
+  az_span long_string = AZ_SPAN_FROM_BUFFER(array);
+  az_span_fill(long_string, 'a');
+  array[0] = '"';
+  array[sizeof(array) - 1] = '"';
+  TEST_EXPECT_SUCCESS(az_json_validate(long_string));
+  array[200] = 0xC3;
+  array[201] = 0xA9;
+  TEST_EXPECT_SUCCESS(az_json_validate(long_string));
+  array[201] = 'a';
+  assert_int_equal(az_json_validate(long_string), AZ_ERROR_UNEXPECTED_CHAR);
+  array[200] = 'a';
+  array[201] = '\n';
+  assert_int_equal(az_json_validate(long_string), AZ_ERROR_UNEXPECTED_CHAR);
+
+  // Nesting deeper than 64 levels.
+  uint8_t nested[130] = { 0 };
+  for (int32_t i = 0; i < 65; i++)
+  {
+    nested[i] = '[';
+    nested[129 - i] = ']';
+  }
+  assert_int_equal(az_json_validate(AZ_SPAN_FROM_BUFFER(nested)), AZ_ERROR_JSON_NESTING_OVERFLOW);
+  TEST_EXPECT_SUCCESS(az_json_validate(az_span_slice(AZ_SPAN_FROM_BUFFER(nested), 1, 129)));
+
+  // The writer rejects JSON text that isn't valid UTF-8.
+  uint8_t destination[64] = { 0 };
+  az_json_writer writer = { 0 };
+  TEST_EXPECT_SUCCESS(az_json_writer_init(&writer, AZ_SPAN_FROM_BUFFER(destination), NULL));
+  assert_int_equal(
+      az_json_writer_append_json_text(&writer, AZ_SPAN_FROM_STR("[\"\xC0\xAF\"]")),
+      AZ_ERROR_UNEXPECTED_CHAR);
+  TEST_EXPECT_SUCCESS(
+      az_json_writer_append_json_text(&writer, AZ_SPAN_FROM_STR("[\"\xC3\xA9\"]")));
+  assert_true(az_span_is_content_equal(
+      az_json_writer_get_bytes_used_in_destination(&writer),
+      AZ_SPAN_FROM_STR("[\"\xC3\xA9\"]")));
+}
+
+static void test_az_json_reader_validate_utf8(void** state)
+{
+  (void)state;
+
+  az_json_reader_options options = az_json_reader_options_default();
+  options.validate_utf8 = true;
+  az_json_reader reader = { 0 };
+
+  // Long enough for the ASCII runs to be scanned a block at a time.
+  az_span const valid = AZ_SPAN_LITERAL_FROM_STR(
+      "{\"caf\xC3\xA9\":\"an ASCII run which is longer than a block \xE2\x82\xAC, then "
+      "\xF0\x9F\x98\x80 and \xED\x9F\xBF and \xF4\x8F\xBF\xBF\"}");
+  TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, valid, &options));
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  assert_true(az_span_is_content_equal(reader.token.slice, AZ_SPAN_FROM_STR("caf\xC3\xA9")));
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  assert_int_equal(reader.token.kind, AZ_JSON_TOKEN_STRING);
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+
+  // A multibyte sequence split across non-contiguous buffers.
+  for (int32_t split = 1; split < az_span_size(valid); split++)
+  {
+    az_span buffers[] = { az_span_slice(valid, 0, split), az_span_slice_to_end(valid, split) };
+    TEST_EXPECT_SUCCESS(az_json_reader_chunked_init(&reader, buffers, 2, &options));
+    TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+    TEST_EXPECT_SUCCESS(az_json_reader_skip_children(&reader));
+    assert_int_equal(reader.token.kind, AZ_JSON_TOKEN_END_OBJECT);
+  }
+
+  az_span const invalid[] = {
+    AZ_SPAN_LITERAL_FROM_STR("\"\x80\""), // Unexpected continuation byte.
+    AZ_SPAN_LITERAL_FROM_STR("\"\xC1\xBF\""), // Overlong encoding.
+    AZ_SPAN_LITERAL_FROM_STR("\"\xF0\x8F\xBF\xBF\""), // Overlong encoding.
+    AZ_SPAN_LITERAL_FROM_STR("\"\xED\xBF\xBF\""), // UTF-16 surrogate.
+    AZ_SPAN_LITERAL_FROM_STR("\"\xF5\x80\x80\x80\""), // Larger than U+10FFFF.
+    AZ_SPAN_LITERAL_FROM_STR("\"\xE2\x82\""), // Missing continuation byte.
+    AZ_SPAN_LITERAL_FROM_STR("\"an ASCII run which is longer than a block \xFF\""),
+    AZ_SPAN_LITERAL_FROM_STR("{\"\xC3\":1}"),
+  };
+
+  for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++)
+  {
+    // Without the option, any byte of 0x80 or more is accepted.
+    TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, invalid[i], NULL));
+    TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+    TEST_EXPECT_SUCCESS(az_json_reader_skip_children(&reader));
+
+    TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, invalid[i], &options));
+    az_result result = az_json_reader_next_token(&reader);
+    if (reader.token.kind == AZ_JSON_TOKEN_BEGIN_OBJECT)
+    {
+      result = az_json_reader_next_token(&reader);
+    }
+    assert_int_equal(result, AZ_ERROR_UNEXPECTED_CHAR);
+  }
+
+  TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, AZ_SPAN_FROM_STR("\"\xF0\x9F\x98"), &options));
+  assert_int_equal(az_json_reader_next_token(&reader), AZ_ERROR_UNEXPECTED_END);
+}
+
+static void test_az_json_token_unescape_in_place(void** state)
+{
+  (void)state;
+
+  uint8_t json[] = "{\"a\\tb\":\"an escaped \\\"quote\\\", a run longer than a block, and "
+                   "\\\\\\/\\b\\f\\n\\r\\t\",\"plain\":\"text\",\"n\":1,\"u\":\"\\u00e9\"}";
+  az_span const json_span = az_span_create(json, (int32_t)sizeof(json) - 1);
+  az_json_reader reader = { 0 };
+  az_span unescaped = AZ_SPAN_EMPTY;
+
+  TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, json_span, NULL));
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  assert_int_equal(
+      az_json_token_unescape_in_place(&reader.token, &unescaped), AZ_ERROR_JSON_INVALID_STATE);
+
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  TEST_EXPECT_SUCCESS(az_json_token_unescape_in_place(&reader.token, &unescaped));
+  assert_true(az_span_is_content_equal(unescaped, AZ_SPAN_FROM_STR("a\tb")));
+  assert_ptr_equal(az_span_ptr(unescaped), az_span_ptr(reader.token.slice));
+
+  // The reader continues after the bytes that were rewritten.
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  TEST_EXPECT_SUCCESS(az_json_token_unescape_in_place(&reader.token, &unescaped));
+  assert_true(az_span_is_content_equal(
+      unescaped,
+      AZ_SPAN_FROM_STR(
+          "an escaped \"quote\", a run longer than a block, and \\/\b\f\n\r\t")));
+
+  // Strings without escaped characters are returned as they are.
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  TEST_EXPECT_SUCCESS(az_json_token_unescape_in_place(&reader.token, &unescaped));
+  assert_ptr_equal(az_span_ptr(unescaped), az_span_ptr(reader.token.slice));
+  assert_int_equal(az_span_size(unescaped), az_span_size(reader.token.slice));
+
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  TEST_EXPECT_SUCCESS(az_json_token_unescape_in_place(&reader.token, &unescaped));
+  assert_true(az_span_is_content_equal(unescaped, AZ_SPAN_FROM_STR("\xC3\xA9")));
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  assert_int_equal(reader.token.kind, AZ_JSON_TOKEN_END_OBJECT);
+
+  // Characters escaped in the form of \uXXXX are unescaped as UTF-8, from 1 to 4 bytes.
+  uint8_t unicode_json[] = "[\"\\u0041\\u00e9\\u20AC\\uD83D\\ude00 \\u0000\\\"\\uDBFF\\uDFFF\"]";
+  TEST_EXPECT_SUCCESS(az_json_reader_init(
+      &reader, az_span_create(unicode_json, (int32_t)sizeof(unicode_json) - 1), NULL));
+  az_span const unicode_string
+      = AZ_SPAN_LITERAL_FROM_STR("A\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80 \x00\"\xF4\x8F\xBF\xBF");
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+
+  // az_json_token_get_string() unescapes them the same way, into a separate destination.
+  char unicode_string_buffer[32] = { 0 };
+  int32_t unicode_string_length = 0;
+  TEST_EXPECT_SUCCESS(az_json_token_get_string(
+      &reader.token,
+      unicode_string_buffer,
+      (int32_t)sizeof(unicode_string_buffer),
+      &unicode_string_length));
+  assert_int_equal(unicode_string_length, az_span_size(unicode_string));
+  assert_memory_equal(
+      unicode_string_buffer, az_span_ptr(unicode_string), (size_t)az_span_size(unicode_string));
+  assert_int_equal(unicode_string_buffer[unicode_string_length], 0);
+  assert_int_equal(
+      az_json_token_get_string(
+          &reader.token, unicode_string_buffer, az_span_size(unicode_string), NULL),
+      AZ_ERROR_NOT_ENOUGH_SPACE);
+  assert_int_equal(
+      az_json_token_get_string(&reader.token, unicode_string_buffer, 5, NULL),
+      AZ_ERROR_NOT_ENOUGH_SPACE);
+
+  TEST_EXPECT_SUCCESS(az_json_token_unescape_in_place(&reader.token, &unescaped));
+  assert_true(az_span_is_content_equal(unescaped, unicode_string));
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  assert_int_equal(reader.token.kind, AZ_JSON_TOKEN_END_ARRAY);
+
+  // The escaped characters can straddle non-contiguous buffers.
+  az_span const unicode_json_span = AZ_SPAN_FROM_STR(
+      "\"\\u0041\\u00e9\\u20AC\\uD83D\\ude00 \\u0000\\\"\\uDBFF\\uDFFF\"");
+  for (int32_t split_index = 1; split_index < az_span_size(unicode_json_span); split_index++)
+  {
+    az_span split_buffers[2] = {
+      az_span_slice(unicode_json_span, 0, split_index),
+      az_span_slice_to_end(unicode_json_span, split_index),
+    };
+    TEST_EXPECT_SUCCESS(az_json_reader_chunked_init(&reader, split_buffers, 2, NULL));
+    TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+    TEST_EXPECT_SUCCESS(az_json_token_get_string(
+        &reader.token,
+        unicode_string_buffer,
+        (int32_t)sizeof(unicode_string_buffer),
+        &unicode_string_length));
+    assert_int_equal(unicode_string_length, az_span_size(unicode_string));
+    assert_memory_equal(
+        unicode_string_buffer, az_span_ptr(unicode_string), (size_t)az_span_size(unicode_string));
+  }
+
+  // A UTF-16 surrogate must be part of a high and low surrogate pair.
+  az_span const unpaired_surrogates[] = {
+    AZ_SPAN_LITERAL_FROM_STR("\"\\uD83D\""),
+    AZ_SPAN_LITERAL_FROM_STR("\"\\uD83Dx\""),
+    AZ_SPAN_LITERAL_FROM_STR("\"\\uD83D\\n\""),
+    AZ_SPAN_LITERAL_FROM_STR("\"\\uD83D\\u0041\""),
+    AZ_SPAN_LITERAL_FROM_STR("\"\\uD83D\\uD83D\""),
+    AZ_SPAN_LITERAL_FROM_STR("\"\\uDE00\""),
+  };
+  for (size_t i = 0; i < sizeof(unpaired_surrogates) / sizeof(unpaired_surrogates[0]); i++)
+  {
+    uint8_t surrogate_json[16] = { 0 };
+    az_span const surrogate_span = az_span_slice(
+        AZ_SPAN_FROM_BUFFER(surrogate_json), 0, az_span_size(unpaired_surrogates[i]));
+    az_span_copy(surrogate_span, unpaired_surrogates[i]);
+    TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, surrogate_span, NULL));
+    TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+    assert_int_equal(
+        az_json_token_get_string(
+            &reader.token, unicode_string_buffer, (int32_t)sizeof(unicode_string_buffer), NULL),
+        AZ_ERROR_UNEXPECTED_CHAR);
+    assert_int_equal(
+        az_json_token_unescape_in_place(&reader.token, &unescaped), AZ_ERROR_UNEXPECTED_CHAR);
+  }
+
+  // A token which straddles non-contiguous buffers.
+  uint8_t chunked_json[] = "\"a\\nb\"";
+  az_span buffers[] = {
+    az_span_create(chunked_json, 3),
+    az_span_create(chunked_json + 3, (int32_t)sizeof(chunked_json) - 4),
+  };
+  TEST_EXPECT_SUCCESS(az_json_reader_chunked_init(&reader, buffers, 2, NULL));
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  assert_int_equal(
+      az_json_token_unescape_in_place(&reader.token, &unescaped), AZ_ERROR_NOT_SUPPORTED);
+}
+
+static void test_az_json_reader_long_strings(void** state)
+{
+  (void)state;
+
+  // Long enough to span several blocks when the string is scanned a block at a time.
+  uint8_t json_buffer[80] = { 0 };
+  az_span json = AZ_SPAN_FROM_BUFFER(json_buffer);
+
+  // Move the special character across every position, including block boundaries.
+  for (int32_t special_index = 1; special_index < az_span_size(json) - 2; special_index++)
+  {
+    memset(json_buffer, 'a', sizeof(json_buffer));
+    json_buffer[0] = '"';
+    json_buffer[sizeof(json_buffer) - 1] = '"';
+
+    // Closing quote
+    json_buffer[special_index] = '"';
+    az_json_reader reader = { 0 };
+    TEST_EXPECT_SUCCESS(
+        az_json_reader_init(&reader, az_span_slice(json, 0, special_index + 1), NULL));
+    assert_int_equal(az_json_reader_next_token(&reader), AZ_OK);
+    assert_int_equal(reader.token.kind, AZ_JSON_TOKEN_STRING);
+    assert_int_equal(reader.token.size, special_index - 1);
+    assert_false(reader.token._internal.string_has_escaped_chars);
+
+    // Escaped character
+    json_buffer[special_index] = '\\';
+    json_buffer[special_index + 1] = 'n';
+    TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, json, NULL));
+    assert_int_equal(az_json_reader_next_token(&reader), AZ_OK);
+    assert_int_equal(reader.token.size, az_span_size(json) - 2);
+    assert_true(reader.token._internal.string_has_escaped_chars);
+
+    az_span buffers[2] = { 0 };
+    buffers[0] = az_span_slice(json, 0, special_index);
+    buffers[1] = az_span_slice_to_end(json, special_index);
+    TEST_EXPECT_SUCCESS(az_json_reader_chunked_init(&reader, buffers, 2, NULL));
+    assert_int_equal(az_json_reader_next_token(&reader), AZ_OK);
+    assert_int_equal(reader.token.size, az_span_size(json) - 2);
+    assert_true(reader.token._internal.string_has_escaped_chars);
+
+    // Unescaped control character
+    json_buffer[special_index] = '\t';
+    json_buffer[special_index + 1] = 'a';
+    TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, json, NULL));
+    assert_int_equal(az_json_reader_next_token(&reader), AZ_ERROR_UNEXPECTED_CHAR);
+
+    TEST_EXPECT_SUCCESS(az_json_reader_chunked_init(&reader, buffers, 2, NULL));
+    assert_int_equal(az_json_reader_next_token(&reader), AZ_ERROR_UNEXPECTED_CHAR);
+
+    // Missing closing quote
+    json_buffer[special_index] = 'a';
+    TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, az_span_slice(json, 0, special_index), NULL));
+    assert_int_equal(az_json_reader_next_token(&reader), AZ_ERROR_UNEXPECTED_END);
+  }
+}
+
+static void test_az_json_reader_long_whitespace(void** state)
+{
+  (void)state;
+
+  // Long enough to span several blocks when whitespace is skipped a block at a time.
+  uint8_t const whitespace[] = { ' ', '\t', '\n', '\r' };
+  uint8_t json_buffer[84] = { 0 };
+
+  // Grow the run of whitespace between the tokens, so that it ends at every position, including
+  // block boundaries.
+  for (int32_t run_size = 1; run_size < 40; run_size++)
+  {
+    int32_t size = 0;
+    json_buffer[size++] = '[';
+    for (int32_t i = 0; i < run_size; i++)
+    {
+      json_buffer[size++] = whitespace[i % 4];
+    }
+    json_buffer[size++] = '1';
+    for (int32_t i = 0; i < run_size; i++)
+    {
+      json_buffer[size++] = whitespace[(i + 1) % 4];
+    }
+    json_buffer[size++] = ']';
+    az_span json = az_span_create(json_buffer, size);
+
+    az_json_reader reader = { 0 };
+    TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, json, NULL));
+    TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+    assert_int_equal(reader.token.kind, AZ_JSON_TOKEN_BEGIN_ARRAY);
+    TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+    assert_int_equal(reader.token.kind, AZ_JSON_TOKEN_NUMBER);
+    assert_int_equal(reader._internal.total_bytes_consumed, run_size + 2);
+    TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+    assert_int_equal(reader.token.kind, AZ_JSON_TOKEN_END_ARRAY);
+    assert_int_equal(reader._internal.total_bytes_consumed, size);
+    assert_int_equal(az_json_reader_next_token(&reader), AZ_ERROR_JSON_READER_DONE);
+
+    // Split the payload within the whitespace, at every position.
+    for (int32_t split_index = 1; split_index < size; split_index++)
+    {
+      az_span buffers[2] = { 0 };
+      buffers[0] = az_span_slice(json, 0, split_index);
+      buffers[1] = az_span_slice_to_end(json, split_index);
+      TEST_EXPECT_SUCCESS(az_json_reader_chunked_init(&reader, buffers, 2, NULL));
+      TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+      TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+      assert_int_equal(reader.token.kind, AZ_JSON_TOKEN_NUMBER);
+      TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+      assert_int_equal(reader.token.kind, AZ_JSON_TOKEN_END_ARRAY);
+      assert_int_equal(az_json_reader_next_token(&reader), AZ_ERROR_JSON_READER_DONE);
+    }
+
+    // Invalid character after the whitespace
+    json_buffer[size - 1] = 'x';
+    TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, json, NULL));
+    TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+    TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+    assert_int_equal(az_json_reader_next_token(&reader), AZ_ERROR_UNEXPECTED_CHAR);
+
+    // Nothing after the whitespace
+    TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, az_span_slice(json, 0, size - 1), NULL));
+    TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+    TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+    assert_int_equal(az_json_reader_next_token(&reader), AZ_ERROR_UNEXPECTED_END);
+  }
+}
+
+static void test_az_json_document(void** state)
+{
+  (void)state;
+
+  az_span const json = AZ_SPAN_FROM_STR(
+      "{\"desired\":{\"targetTemperature\":21.5,\"fan\":{\"on\":true},\"$version\":7},"
+      "\"items\":[1,[],{},\"four\"],\"a/b\":1,\"m~n\":2,\"esc\\/aped\":3,\"\":4}");
+
+  az_json_document_node nodes[31];
+  az_json_document document = { 0 };
+  az_json_reader reader = { 0 };
+  TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, json, NULL));
+  TEST_EXPECT_SUCCESS(az_json_document_init(&document, &reader, nodes, 31));
+  assert_int_equal(az_json_document_get_node_count(&document), 31);
+  assert_int_equal(reader.token.kind, AZ_JSON_TOKEN_END_OBJECT);
+  assert_int_equal(az_json_reader_next_token(&reader), AZ_ERROR_JSON_READER_DONE);
+
+  int32_t index = 0;
+  int64_t number = 0;
+  TEST_EXPECT_SUCCESS(
+      az_json_document_get_pointer(&document, AZ_SPAN_FROM_STR("/desired/$version"), &index));
+  TEST_EXPECT_SUCCESS(
+      az_json_token_get_int64(az_json_document_get_token(&document, index), &number));
+  assert_int_equal(number, 7);
+
+  TEST_EXPECT_SUCCESS(
+      az_json_document_get_pointer(&document, AZ_SPAN_FROM_STR("/desired/fan/on"), &index));
+  assert_int_equal(az_json_document_get_token(&document, index)->kind, AZ_JSON_TOKEN_TRUE);
+
+  TEST_EXPECT_SUCCESS(az_json_document_get_pointer(&document, AZ_SPAN_FROM_STR(""), &index));
+  assert_int_equal(index, 0);
+
+  TEST_EXPECT_SUCCESS(
+      az_json_document_get_pointer(&document, AZ_SPAN_FROM_STR("/items/3"), &index));
+  assert_true(az_json_token_is_text_equal(
+      az_json_document_get_token(&document, index), AZ_SPAN_FROM_STR("four")));
+  TEST_EXPECT_SUCCESS(
+      az_json_document_get_pointer(&document, AZ_SPAN_FROM_STR("/items/1"), &index));
+  assert_int_equal(az_json_document_get_token(&document, index)->kind, AZ_JSON_TOKEN_BEGIN_ARRAY);
+
+  // RFC 6901 escapes, escaped property names, and the empty property name.
+  TEST_EXPECT_SUCCESS(az_json_document_get_pointer(&document, AZ_SPAN_FROM_STR("/a~1b"), &index));
+  TEST_EXPECT_SUCCESS(
+      az_json_token_get_int64(az_json_document_get_token(&document, index), &number));
+  assert_int_equal(number, 1);
+  TEST_EXPECT_SUCCESS(az_json_document_get_pointer(&document, AZ_SPAN_FROM_STR("/m~0n"), &index));
+  TEST_EXPECT_SUCCESS(
+      az_json_token_get_int64(az_json_document_get_token(&document, index), &number));
+  assert_int_equal(number, 2);
+  TEST_EXPECT_SUCCESS(
+      az_json_document_get_pointer(&document, AZ_SPAN_FROM_STR("/esc~1aped"), &index));
+  TEST_EXPECT_SUCCESS(
+      az_json_token_get_int64(az_json_document_get_token(&document, index), &number));
+  assert_int_equal(number, 3);
+  TEST_EXPECT_SUCCESS(az_json_document_get_pointer(&document, AZ_SPAN_FROM_STR("/"), &index));
+  TEST_EXPECT_SUCCESS(
+      az_json_token_get_int64(az_json_document_get_token(&document, index), &number));
+  assert_int_equal(number, 4);
+
+  // Missing values
+  assert_int_equal(
+      az_json_document_get_pointer(&document, AZ_SPAN_FROM_STR("/desired/missing"), &index),
+      AZ_ERROR_ITEM_NOT_FOUND);
+  assert_int_equal(
+      az_json_document_get_pointer(&document, AZ_SPAN_FROM_STR("/items/4"), &index),
+      AZ_ERROR_ITEM_NOT_FOUND);
+  assert_int_equal(
+      az_json_document_get_pointer(&document, AZ_SPAN_FROM_STR("/items/01"), &index),
+      AZ_ERROR_ITEM_NOT_FOUND);
+  assert_int_equal(
+      az_json_document_get_pointer(&document, AZ_SPAN_FROM_STR("/items/-"), &index),
+      AZ_ERROR_ITEM_NOT_FOUND);
+  assert_int_equal(
+      az_json_document_get_pointer(&document, AZ_SPAN_FROM_STR("/items/99999999999"), &index),
+      AZ_ERROR_ITEM_NOT_FOUND);
+  assert_int_equal(
+      az_json_document_get_pointer(&document, AZ_SPAN_FROM_STR("/items/0/x"), &index),
+      AZ_ERROR_ITEM_NOT_FOUND);
+  assert_int_equal(
+      az_json_document_get_pointer(&document, AZ_SPAN_FROM_STR("/items/2/x"), &index),
+      AZ_ERROR_ITEM_NOT_FOUND);
+
+  // Invalid pointers
+  assert_int_equal(
+      az_json_document_get_pointer(&document, AZ_SPAN_FROM_STR("desired"), &index),
+      AZ_ERROR_UNEXPECTED_CHAR);
+  assert_int_equal(
+      az_json_document_get_pointer(&document, AZ_SPAN_FROM_STR("/m~2n"), &index),
+      AZ_ERROR_UNEXPECTED_CHAR);
+  assert_int_equal(
+      az_json_document_get_pointer(&document, AZ_SPAN_FROM_STR("/m~"), &index),
+      AZ_ERROR_UNEXPECTED_CHAR);
+  assert_int_equal(
+      az_json_document_get_pointer(
+          &document,
+          AZ_SPAN_FROM_STR(
+              "/~0123456789012345678901234567890123456789012345678901234567890123456789"),
+          &index),
+      AZ_ERROR_NOT_SUPPORTED);
+
+  // Sibling iteration skips over nested elements.
+  az_span const names[] = { AZ_SPAN_LITERAL_FROM_STR("desired"), AZ_SPAN_LITERAL_FROM_STR("items"),
+                            AZ_SPAN_LITERAL_FROM_STR("a/b"),     AZ_SPAN_LITERAL_FROM_STR("m~n"),
+                            AZ_SPAN_LITERAL_FROM_STR("esc/aped"), AZ_SPAN_LITERAL_FROM_STR("") };
+  int32_t child = 0;
+  int32_t count = 0;
+  az_result result = az_json_document_get_first_child(&document, 0, &child);
+  while (az_result_succeeded(result))
+  {
+    assert_true(count < 6);
+    assert_true(
+        az_json_token_is_text_equal(az_json_document_get_token(&document, child), names[count]));
+    count++;
+    result = az_json_document_get_next_sibling(&document, child, &child);
+  }
+  assert_int_equal(result, AZ_ERROR_ITEM_NOT_FOUND);
+  assert_int_equal(count, 6);
+
+  int32_t items = 0;
+  TEST_EXPECT_SUCCESS(
+      az_json_document_get_property(&document, 0, AZ_SPAN_FROM_STR("items"), &items));
+  TEST_EXPECT_SUCCESS(az_json_document_get_array_element(&document, items, 2, &index));
+  assert_int_equal(az_json_document_get_token(&document, index)->kind, AZ_JSON_TOKEN_BEGIN_OBJECT);
+  assert_int_equal(
+      az_json_document_get_first_child(&document, index, &child), AZ_ERROR_ITEM_NOT_FOUND);
+  assert_int_equal(
+      az_json_document_get_property(&document, items, AZ_SPAN_FROM_STR("x"), &index),
+      AZ_ERROR_ITEM_NOT_FOUND);
+  assert_int_equal(
+      az_json_document_get_array_element(&document, 0, 0, &index), AZ_ERROR_ITEM_NOT_FOUND);
+  assert_int_equal(
+      az_json_document_get_next_sibling(&document, 0, &index), AZ_ERROR_ITEM_NOT_FOUND);
+
+  // Too few nodes
+  for (int32_t nodes_length = 1; nodes_length < 31; nodes_length++)
+  {
+    TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, json, NULL));
+    assert_int_equal(
+        az_json_document_init(&document, &reader, nodes, nodes_length), AZ_ERROR_NOT_ENOUGH_SPACE);
+  }
+
+  // Invalid JSON
+  TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, AZ_SPAN_FROM_STR("{\"a\":[1,}"), NULL));
+  assert_int_equal(az_json_document_init(&document, &reader, nodes, 31), AZ_ERROR_UNEXPECTED_CHAR);
+  TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, AZ_SPAN_FROM_STR("{\"a\":[1,"), NULL));
+  assert_int_equal(az_json_document_init(&document, &reader, nodes, 31), AZ_ERROR_UNEXPECTED_END);
+}
+
+static void test_az_json_document_property_value(void** state)
+{
+  (void)state;
+
+  // Index only the value of one property, from JSON split across several buffers.
+  az_span const json
+      = AZ_SPAN_FROM_STR("{\"skip\":[1,2],\"reported\":{\"x\":[true,null]},\"y\":5}");
+  az_span buffers[3] = { 0 };
+  buffers[0] = az_span_slice(json, 0, 18);
+  buffers[1] = az_span_slice(json, 18, 31);
+  buffers[2] = az_span_slice_to_end(json, 31);
+
+  az_json_reader reader = { 0 };
+  TEST_EXPECT_SUCCESS(az_json_reader_chunked_init(&reader, buffers, 3, NULL));
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  TEST_EXPECT_SUCCESS(az_json_reader_skip_children(&reader));
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  assert_true(az_json_token_is_text_equal(&reader.token, AZ_SPAN_FROM_STR("reported")));
+
+  az_json_document_node nodes[8];
+  az_json_document document = { 0 };
+  TEST_EXPECT_SUCCESS(az_json_document_init(&document, &reader, nodes, 8));
+  assert_int_equal(az_json_document_get_node_count(&document), 7);
+  assert_int_equal(reader.token.kind, AZ_JSON_TOKEN_END_OBJECT);
+
+  int32_t index = 0;
+  TEST_EXPECT_SUCCESS(az_json_document_get_pointer(&document, AZ_SPAN_FROM_STR("/x/1"), &index));
+  assert_int_equal(az_json_document_get_token(&document, index)->kind, AZ_JSON_TOKEN_NULL);
+
+  // The reader continues after the indexed value.
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  assert_true(az_json_token_is_text_equal(&reader.token, AZ_SPAN_FROM_STR("y")));
+
+  // A single primitive value
+  TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, AZ_SPAN_FROM_STR(" 42 "), NULL));
+  TEST_EXPECT_SUCCESS(az_json_document_init(&document, &reader, nodes, 1));
+  assert_int_equal(az_json_document_get_node_count(&document), 1);
+  assert_int_equal(az_json_document_get_token(&document, 0)->kind, AZ_JSON_TOKEN_NUMBER);
+  assert_int_equal(
+      az_json_document_get_next_sibling(&document, 0, &index), AZ_ERROR_ITEM_NOT_FOUND);
+  assert_int_equal(
+      az_json_document_get_pointer(&document, AZ_SPAN_FROM_STR("/0"), &index),
+      AZ_ERROR_ITEM_NOT_FOUND);
+
+  // The reader is on an end token, so there is no value to index, and no node is written.
+  TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, AZ_SPAN_FROM_STR("[[],1]"), NULL));
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  assert_int_equal(reader.token.kind, AZ_JSON_TOKEN_END_ARRAY);
+  nodes[0].token.kind = AZ_JSON_TOKEN_NONE;
+  assert_int_equal(
+      az_json_document_init(&document, &reader, nodes, 8), AZ_ERROR_JSON_INVALID_STATE);
+  assert_int_equal(az_json_document_get_node_count(&document), 0);
+  assert_int_equal(nodes[0].token.kind, AZ_JSON_TOKEN_NONE);
+  assert_int_equal(reader.token.kind, AZ_JSON_TOKEN_END_ARRAY);
+
+  // The reader can still continue after the end token.
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  assert_int_equal(reader.token.kind, AZ_JSON_TOKEN_NUMBER);
+}
+
+static void test_az_json_property_name_table(void** state)
+{
+  (void)state;
+
+  az_span const names[] = {
+    AZ_SPAN_LITERAL_FROM_STR("targetTemperature"),
+    AZ_SPAN_LITERAL_FROM_STR("maxTempSinceLastReboot"),
+    AZ_SPAN_LITERAL_FROM_STR("$version"),
+    AZ_SPAN_LITERAL_FROM_STR("a\"b/c"),
+    AZ_SPAN_LITERAL_FROM_STR(""),
+    AZ_SPAN_LITERAL_FROM_STR("$version"),
+  };
+  int32_t const names_length = (int32_t)(sizeof(names) / sizeof(names[0]));
+
+  az_json_property_name_table table = { 0 };
+  uint8_t slots[16];
+  assert_int_equal(
+      az_json_property_name_table_init(&table, names, names_length, slots, 4),
+      AZ_ERROR_NOT_ENOUGH_SPACE);
+
+  az_span const json = AZ_SPAN_FROM_STR(
+      "{\"maxTempSinceLastReboot\":1,\"$version\":2,\"a\\\"b\\/c\":3,\"\":4,"
+      "\"targetTemperatur\":5,\"targetTemperature\":6,\"\\u0024version\":7,"
+      "\"x\":\"targetTemperature\"}");
+  int32_t const expected[] = { 1, 2, 3, 4, -1, 0, -1, -1 };
+
+  // Fewer slots force names to share them.
+  for (int32_t slots_length = 8; slots_length <= 16; slots_length *= 2)
+  {
+    TEST_EXPECT_SUCCESS(
+        az_json_property_name_table_init(&table, names, names_length, slots, slots_length));
+
+    // Split the JSON within every token, to cover tokens that straddle buffers.
+    for (int32_t split_index = 1; split_index < az_span_size(json); split_index++)
+    {
+      az_span buffers[2] = { 0 };
+      buffers[0] = az_span_slice(json, 0, split_index);
+      buffers[1] = az_span_slice_to_end(json, split_index);
+
+      az_json_reader reader = { 0 };
+      TEST_EXPECT_SUCCESS(az_json_reader_chunked_init(&reader, buffers, 2, NULL));
+      TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+
+      int32_t index = 0;
+      assert_int_equal(
+          az_json_property_name_table_find(&table, &reader.token, &index),
+          AZ_ERROR_ITEM_NOT_FOUND);
+
+      for (int32_t i = 0; i < (int32_t)(sizeof(expected) / sizeof(expected[0])); i++)
+      {
+        TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+        assert_int_equal(reader.token.kind, AZ_JSON_TOKEN_PROPERTY_NAME);
+        if (expected[i] < 0)
+        {
+          assert_int_equal(
+              az_json_property_name_table_find(&table, &reader.token, &index),
+              AZ_ERROR_ITEM_NOT_FOUND);
+        }
+        else
+        {
+          TEST_EXPECT_SUCCESS(az_json_property_name_table_find(&table, &reader.token, &index));
+          assert_int_equal(index, expected[i]);
+        }
+
+        // Property values are matched the same way as names, but numbers aren't.
+        TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+        if (reader.token.kind == AZ_JSON_TOKEN_STRING)
+        {
+          TEST_EXPECT_SUCCESS(az_json_property_name_table_find(&table, &reader.token, &index));
+          assert_int_equal(index, 0);
+        }
+        else
+        {
+          assert_int_equal(
+              az_json_property_name_table_find(&table, &reader.token, &index),
+              AZ_ERROR_ITEM_NOT_FOUND);
+        }
+      }
+    }
+  }
+
+  // An empty list of names
+  TEST_EXPECT_SUCCESS(az_json_property_name_table_init(&table, names, 0, slots, 1));
+  az_json_reader reader = { 0 };
+  TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, json, NULL));
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  int32_t index = 0;
+  assert_int_equal(
+      az_json_property_name_table_find(&table, &reader.token, &index), AZ_ERROR_ITEM_NOT_FOUND);
+}
+
+typedef struct
+{
+  bool on;
+  uint32_t speed;
+} test_fan;
+
+typedef struct
+{
+  double target_temperature;
+  int64_t version;
+  uint64_t serial;
+  int32_t offset;
+  az_span name;
+  int32_t name_length;
+  test_fan fan;
+} test_desired;
+
+static az_json_binding_field const test_fan_fields[] = {
+  { AZ_SPAN_LITERAL_FROM_STR("on"), offsetof(test_fan, on), NULL, AZ_JSON_BINDING_BOOLEAN, 0 },
+  { AZ_SPAN_LITERAL_FROM_STR("speed"), offsetof(test_fan, speed), NULL, AZ_JSON_BINDING_UINT32, 0 },
+};
+
+static az_json_binding const test_fan_binding = { test_fan_fields, 2 };
+
+static az_json_binding_field const test_desired_fields[] = {
+  { AZ_SPAN_LITERAL_FROM_STR("targetTemperature"),
+    offsetof(test_desired, target_temperature),
+    NULL,
+    AZ_JSON_BINDING_DOUBLE,
+    0 },
+  { AZ_SPAN_LITERAL_FROM_STR("$version"),
+    offsetof(test_desired, version),
+    NULL,
+    AZ_JSON_BINDING_INT64,
+    0 },
+  { AZ_SPAN_LITERAL_FROM_STR("serial"),
+    offsetof(test_desired, serial),
+    NULL,
+    AZ_JSON_BINDING_UINT64,
+    0 },
+  { AZ_SPAN_LITERAL_FROM_STR("offset"),
+    offsetof(test_desired, offset),
+    NULL,
+    AZ_JSON_BINDING_INT32,
+    0 },
+  { AZ_SPAN_LITERAL_FROM_STR("name"),
+    offsetof(test_desired, name),
+    NULL,
+    AZ_JSON_BINDING_STRING,
+    offsetof(test_desired, name_length) },
+  { AZ_SPAN_LITERAL_FROM_STR("fan"),
+    offsetof(test_desired, fan),
+    &test_fan_binding,
+    AZ_JSON_BINDING_OBJECT,
+    0 },
+};
+
+static az_json_binding const test_desired_binding = { test_desired_fields, 6 };
+
+static void test_az_json_binding(void** state)
+{
+  (void)state;
+
+  uint8_t name_buffer[16];
+  test_desired desired = { 0 };
+  desired.name = AZ_SPAN_FROM_BUFFER(name_buffer);
+  desired.fan.speed = 3;
+
+  // Unknown properties are skipped, and null or missing values leave the field unchanged.
+  az_json_reader reader = { 0 };
+  TEST_EXPECT_SUCCESS(az_json_reader_init(
+      &reader,
+      AZ_SPAN_FROM_STR("{\"unknown\":{\"fan\":{\"on\":1}},\"targetTemperature\":21.5,"
+                       "\"$version\":7,\"serial\":18446744073709551615,\"offset\":-2147483648,"
+                       "\"name\":\"a\\\"b\",\"fan\":{\"on\":true,\"speed\":null,\"x\":[]},"
+                       "\"extra\":[1,{}]}"),
+      NULL));
+  TEST_EXPECT_SUCCESS(az_json_binding_read(&reader, &test_desired_binding, &desired));
+  assert_int_equal(reader.token.kind, AZ_JSON_TOKEN_END_OBJECT);
+  assert_int_equal(az_json_reader_next_token(&reader), AZ_ERROR_JSON_READER_DONE);
+
+  assert_true(desired.target_temperature >= 21.5 && desired.target_temperature <= 21.5);
+  assert_int_equal(desired.version, 7);
+  assert_true(desired.serial == UINT64_MAX);
+  assert_int_equal(desired.offset, INT32_MIN);
+  assert_int_equal(desired.name_length, 3);
+  assert_memory_equal(name_buffer, "a\"b", 4);
+  assert_int_equal(az_span_size(desired.name), sizeof(name_buffer));
+  assert_true(desired.fan.on);
+  assert_int_equal(desired.fan.speed, 3);
+
+  // Write the struct back, and read it again.
+  uint8_t json_buffer[256];
+  az_json_writer writer = { 0 };
+  TEST_EXPECT_SUCCESS(az_json_writer_init(&writer, AZ_SPAN_FROM_BUFFER(json_buffer), NULL));
+  TEST_EXPECT_SUCCESS(az_json_binding_write(&writer, &test_desired_binding, &desired));
+  az_span const json = az_json_writer_get_bytes_used_in_destination(&writer);
+  assert_true(az_span_is_content_equal(
+      json,
+      AZ_SPAN_FROM_STR("{\"targetTemperature\":21.5,\"$version\":7,"
+                       "\"serial\":18446744073709551615,\"offset\":-2147483648,"
+                       "\"name\":\"a\\\"b\",\"fan\":{\"on\":true,\"speed\":3}}")));
+
+  uint8_t name_buffer2[16];
+  test_desired read_back = { 0 };
+  read_back.name = AZ_SPAN_FROM_BUFFER(name_buffer2);
+  TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, json, NULL));
+  TEST_EXPECT_SUCCESS(az_json_binding_read(&reader, &test_desired_binding, &read_back));
+  assert_true(
+      read_back.target_temperature >= desired.target_temperature
+      && read_back.target_temperature <= desired.target_temperature);
+  assert_int_equal(read_back.version, desired.version);
+  assert_true(read_back.serial == desired.serial);
+  assert_int_equal(read_back.offset, desired.offset);
+  assert_int_equal(read_back.name_length, desired.name_length);
+  assert_memory_equal(name_buffer2, name_buffer, (size_t)desired.name_length);
+  assert_true(read_back.fan.on);
+  assert_int_equal(read_back.fan.speed, 3);
+
+  // Not enough space to write
+  for (int32_t size = 0; size < az_span_size(json); size++)
+  {
+    TEST_EXPECT_SUCCESS(az_json_writer_init(&writer, az_span_create(json_buffer, size), NULL));
+    assert_int_equal(
+        az_json_binding_write(&writer, &test_desired_binding, &desired), AZ_ERROR_NOT_ENOUGH_SPACE);
+  }
+
+  // Reading a property value, from JSON split across buffers
+  az_span const property_json = AZ_SPAN_FROM_STR("{\"desired\":{\"on\":false,\"speed\":12}}");
+  for (int32_t split_index = 1; split_index < az_span_size(property_json); split_index++)
+  {
+    az_span buffers[2] = { 0 };
+    buffers[0] = az_span_slice(property_json, 0, split_index);
+    buffers[1] = az_span_slice_to_end(property_json, split_index);
+    TEST_EXPECT_SUCCESS(az_json_reader_chunked_init(&reader, buffers, 2, NULL));
+    TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+    TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+
+    test_fan fan = { true, 0 };
+    TEST_EXPECT_SUCCESS(az_json_binding_read(&reader, &test_fan_binding, &fan));
+    assert_false(fan.on);
+    assert_int_equal(fan.speed, 12);
+    TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+    assert_int_equal(reader.token.kind, AZ_JSON_TOKEN_END_OBJECT);
+  }
+
+  // Values of the wrong kind, or out of range
+  test_fan fan = { 0 };
+  TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, AZ_SPAN_FROM_STR("[]"), NULL));
+  assert_int_equal(
+      az_json_binding_read(&reader, &test_fan_binding, &fan), AZ_ERROR_JSON_INVALID_STATE);
+  TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, AZ_SPAN_FROM_STR("{\"on\":1}"), NULL));
+  assert_int_equal(
+      az_json_binding_read(&reader, &test_fan_binding, &fan), AZ_ERROR_JSON_INVALID_STATE);
+  TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, AZ_SPAN_FROM_STR("{\"speed\":-1}"), NULL));
+  assert_int_equal(
+      az_json_binding_read(&reader, &test_fan_binding, &fan), AZ_ERROR_UNEXPECTED_CHAR);
+  TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, AZ_SPAN_FROM_STR("{\"on\":true"), NULL));
+  assert_int_equal(
+      az_json_binding_read(&reader, &test_fan_binding, &fan), AZ_ERROR_UNEXPECTED_END);
+
+  // The same struct is read again, into the whole buffer, even with a longer string.
+  TEST_EXPECT_SUCCESS(
+      az_json_reader_init(&reader, AZ_SPAN_FROM_STR("{\"name\":\"012345678901234\"}"), NULL));
+  TEST_EXPECT_SUCCESS(az_json_binding_read(&reader, &test_desired_binding, &desired));
+  assert_int_equal(desired.name_length, 15);
+  assert_memory_equal(name_buffer, "012345678901234", 16);
+
+  // The string doesn't fit, along with its null terminator.
+  desired.name = az_span_create(name_buffer, 3);
+  TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, AZ_SPAN_FROM_STR("{\"name\":\"abc\"}"), NULL));
+  assert_int_equal(
+      az_json_binding_read(&reader, &test_desired_binding, &desired), AZ_ERROR_NOT_ENOUGH_SPACE);
+}
+
+static void test_az_json_reader_push(void** state)
+{
+  (void)state;
+
+  az_span const json = AZ_SPAN_FROM_STR("{\"name\":\"a\\\"b\",\"n\":[-12.5e3,0,true,false,null],"
+                                        "\"skip\":{\"x\":[1,{}]},\"last\":7} ");
+
+  // Read the contiguous JSON first, to know which tokens to expect.
+  az_json_token_kind expected_kinds[32];
+  uint8_t expected_text[32][16];
+  int32_t expected_count = 0;
+  az_json_reader reader = { 0 };
+  TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, json, NULL));
+  while (az_result_succeeded(az_json_reader_next_token(&reader)))
+  {
+    expected_kinds[expected_count] = reader.token.kind;
+    az_span const destination = AZ_SPAN_FROM_BUFFER(expected_text[expected_count]);
+    az_span_copy_u8(az_json_token_copy_into_span(&reader.token, destination), 0);
+    expected_count++;
+  }
+
+  // Push the JSON in fragments of every size. The skipped property, from its name to the end of its
+  // value, is the longest run of JSON that the reader needs at once: 19 bytes.
+  for (int32_t fragment_size = 1; fragment_size <= az_span_size(json); fragment_size++)
+  {
+    az_span buffers[20];
+    TEST_EXPECT_SUCCESS(az_json_reader_push_init(&reader, buffers, 20, NULL));
+    assert_int_equal(az_json_reader_next_token(&reader), AZ_ERROR_JSON_NEED_MORE_DATA);
+
+    int32_t pushed = 0;
+    int32_t count = 0;
+    while (true)
+    {
+      az_result const result = az_json_reader_next_token(&reader);
+      if (result == AZ_ERROR_JSON_NEED_MORE_DATA)
+      {
+        int32_t const remaining = az_span_size(json) - pushed;
+        int32_t const size = fragment_size < remaining ? fragment_size : remaining;
+        TEST_EXPECT_SUCCESS(az_json_reader_push_buffer(
+            &reader,
+            az_span_slice(json, pushed, pushed + size),
+            pushed + size == az_span_size(json)));
+        pushed += size;
+        continue;
+      }
+      if (result == AZ_ERROR_JSON_READER_DONE)
+      {
+        break;
+      }
+      TEST_EXPECT_SUCCESS(result);
+
+      assert_true(count < expected_count);
+      assert_int_equal(reader.token.kind, expected_kinds[count]);
+      uint8_t text[16] = { 0 };
+      az_span_copy_u8(az_json_token_copy_into_span(&reader.token, AZ_SPAN_FROM_BUFFER(text)), 0);
+      assert_string_equal((char*)text, (char*)expected_text[count]);
+      count++;
+
+      // Skipping children restarts from the property name when the object isn't complete yet.
+      if (az_json_token_is_text_equal(&reader.token, AZ_SPAN_FROM_STR("skip")))
+      {
+        az_result skip_result = az_json_reader_skip_children(&reader);
+        while (skip_result == AZ_ERROR_JSON_NEED_MORE_DATA)
+        {
+          assert_true(az_json_token_is_text_equal(&reader.token, AZ_SPAN_FROM_STR("skip")));
+          int32_t const remaining = az_span_size(json) - pushed;
+          int32_t const size = fragment_size < remaining ? fragment_size : remaining;
+          TEST_EXPECT_SUCCESS(az_json_reader_push_buffer(
+              &reader,
+              az_span_slice(json, pushed, pushed + size),
+              pushed + size == az_span_size(json)));
+          pushed += size;
+          skip_result = az_json_reader_skip_children(&reader);
+        }
+        TEST_EXPECT_SUCCESS(skip_result);
+        assert_int_equal(reader.token.kind, AZ_JSON_TOKEN_END_OBJECT);
+        count += 8;
+      }
+    }
+    assert_int_equal(count, expected_count);
+    assert_int_equal(pushed, az_span_size(json));
+  }
+
+  // A token which straddles more buffers than the reader can keep track of
+  az_span buffers[2];
+  TEST_EXPECT_SUCCESS(az_json_reader_push_init(&reader, buffers, 2, NULL));
+  TEST_EXPECT_SUCCESS(az_json_reader_push_buffer(&reader, AZ_SPAN_FROM_STR("[\"ab"), false));
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  TEST_EXPECT_SUCCESS(az_json_reader_push_buffer(&reader, AZ_SPAN_FROM_STR("cd"), false));
+  assert_int_equal(az_json_reader_next_token(&reader), AZ_ERROR_JSON_NEED_MORE_DATA);
+  assert_int_equal(
+      az_json_reader_push_buffer(&reader, AZ_SPAN_FROM_STR("ef\"]"), true),
+      AZ_ERROR_NOT_ENOUGH_SPACE);
+
+  // A single number isn't complete until the final buffer is pushed.
+  TEST_EXPECT_SUCCESS(az_json_reader_push_init(&reader, buffers, 2, NULL));
+  TEST_EXPECT_SUCCESS(az_json_reader_push_buffer(&reader, AZ_SPAN_FROM_STR("12"), false));
+  assert_int_equal(az_json_reader_next_token(&reader), AZ_ERROR_JSON_NEED_MORE_DATA);
+  TEST_EXPECT_SUCCESS(az_json_reader_push_buffer(&reader, AZ_SPAN_FROM_STR("3"), false));
+  assert_int_equal(az_json_reader_next_token(&reader), AZ_ERROR_JSON_NEED_MORE_DATA);
+  TEST_EXPECT_SUCCESS(az_json_reader_push_buffer(&reader, AZ_SPAN_EMPTY, true));
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  int32_t number = 0;
+  TEST_EXPECT_SUCCESS(az_json_token_get_int32(&reader.token, &number));
+  assert_int_equal(number, 123);
+  assert_int_equal(az_json_reader_next_token(&reader), AZ_ERROR_JSON_READER_DONE);
+
+  // Errors are still reported before the final buffer, and an incomplete payload after it.
+  TEST_EXPECT_SUCCESS(az_json_reader_push_init(&reader, buffers, 2, NULL));
+  TEST_EXPECT_SUCCESS(az_json_reader_push_buffer(&reader, AZ_SPAN_FROM_STR("[tx"), false));
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  assert_int_equal(az_json_reader_next_token(&reader), AZ_ERROR_UNEXPECTED_CHAR);
+  TEST_EXPECT_SUCCESS(az_json_reader_push_init(&reader, buffers, 2, NULL));
+  TEST_EXPECT_SUCCESS(az_json_reader_push_buffer(&reader, AZ_SPAN_FROM_STR("[tr"), true));
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  assert_int_equal(az_json_reader_next_token(&reader), AZ_ERROR_UNEXPECTED_END);
+}
+
+static void test_az_json_nesting_buffer(void** state)
+{
+  (void)state;
+
+  // 200 levels of objects and arrays, in an irregular pattern, so that the stack returns the right
+  // container kind at every level.
+  enum
+  {
+    depth = 200,
+  };
+  uint8_t json_buffer[depth * 5 + 1];
+  az_span remaining = AZ_SPAN_FROM_BUFFER(json_buffer);
+  for (int32_t i = 0; i < depth; i++)
+  {
+    bool const is_object = i % 3 == 0 || i % 7 == 0;
+    remaining
+        = az_span_copy(remaining, is_object ? AZ_SPAN_FROM_STR("{\"a\":") : AZ_SPAN_FROM_STR("["));
+  }
+  remaining = az_span_copy_u8(remaining, '1');
+  for (int32_t i = depth - 1; i >= 0; i--)
+  {
+    remaining = az_span_copy_u8(remaining, (i % 3 == 0 || i % 7 == 0) ? '}' : ']');
+  }
+  az_span const json
+      = az_span_create(json_buffer, _az_span_diff(remaining, AZ_SPAN_FROM_BUFFER(json_buffer)));
+
+  // 64 levels + 17 * 8 levels is exactly enough.
+  uint8_t nesting_buffer[17] = { 0 };
+  az_json_reader_options reader_options = az_json_reader_options_default();
+  reader_options.nesting_buffer = AZ_SPAN_FROM_BUFFER(nesting_buffer);
+  az_json_writer_options writer_options = az_json_writer_options_default();
+  writer_options.nesting_buffer = AZ_SPAN_FROM_BUFFER(nesting_buffer);
+
+  // Copy the JSON token by token, which also validates that every end of a container matches.
+  uint8_t output_buffer[depth * 5 + 1];
+  az_json_reader reader = { 0 };
+  az_json_writer writer = { 0 };
+  TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, json, &reader_options));
+  TEST_EXPECT_SUCCESS(
+      az_json_writer_init(&writer, AZ_SPAN_FROM_BUFFER(output_buffer), &writer_options));
+  int32_t max_depth = 0;
+  az_result result = AZ_OK;
+  while (az_result_succeeded(result = az_json_reader_next_token(&reader)))
+  {
+    switch (reader.token.kind)
+    {
+      case AZ_JSON_TOKEN_BEGIN_OBJECT:
+        TEST_EXPECT_SUCCESS(az_json_writer_append_begin_object(&writer));
+        break;
+      case AZ_JSON_TOKEN_BEGIN_ARRAY:
+        TEST_EXPECT_SUCCESS(az_json_writer_append_begin_array(&writer));
+        break;
+      case AZ_JSON_TOKEN_END_OBJECT:
+        TEST_EXPECT_SUCCESS(az_json_writer_append_end_object(&writer));
+        break;
+      case AZ_JSON_TOKEN_END_ARRAY:
+        TEST_EXPECT_SUCCESS(az_json_writer_append_end_array(&writer));
+        break;
+      case AZ_JSON_TOKEN_PROPERTY_NAME:
+        TEST_EXPECT_SUCCESS(az_json_writer_append_property_name(&writer, AZ_SPAN_FROM_STR("a")));
+        break;
+      default:
+        TEST_EXPECT_SUCCESS(az_json_writer_append_int32(&writer, 1));
+        break;
+    }
+    int32_t const current_depth = reader._internal.bit_stack._internal.current_depth;
+    max_depth = current_depth > max_depth ? current_depth : max_depth;
+  }
+  assert_int_equal(result, AZ_ERROR_JSON_READER_DONE);
+  assert_int_equal(max_depth, depth);
+  assert_true(
+      az_span_is_content_equal(az_json_writer_get_bytes_used_in_destination(&writer), json));
+
+  // One level too many
+  reader_options.nesting_buffer = az_span_create(nesting_buffer, 16);
+  TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, json, &reader_options));
+  while (az_result_succeeded(result = az_json_reader_next_token(&reader)))
+  {
+  }
+  assert_int_equal(result, AZ_ERROR_JSON_NESTING_OVERFLOW);
+  assert_int_equal(reader._internal.bit_stack._internal.current_depth, 192);
+
+  writer_options.nesting_buffer = az_span_create(nesting_buffer, 16);
+  TEST_EXPECT_SUCCESS(
+      az_json_writer_init(&writer, AZ_SPAN_FROM_BUFFER(output_buffer), &writer_options));
+  for (int32_t i = 0; i < 192; i++)
+  {
+    TEST_EXPECT_SUCCESS(az_json_writer_append_begin_array(&writer));
+  }
+  assert_int_equal(az_json_writer_append_begin_array(&writer), AZ_ERROR_JSON_NESTING_OVERFLOW);
+}
+
 int test_az_json()
 {
   const struct CMUnitTest tests[]
@@ -2832,6 +4441,16 @@ int test_az_json()
           cmocka_unit_test(test_json_writer_chunked),
           cmocka_unit_test(test_json_writer_chunked_no_callback),
           cmocka_unit_test(test_json_writer_large_string_chunked),
+          cmocka_unit_test(test_json_writer_append_double_shortest),
+          cmocka_unit_test(test_json_writer_escape_long_strings),
+          cmocka_unit_test(test_json_writer_buffered),
+          cmocka_unit_test(test_json_writer_measure),
+          cmocka_unit_test(test_json_writer_indentation_not_enough_space),
+          cmocka_unit_test(test_json_writer_indentation_chunked),
+          cmocka_unit_test(test_json_writer_transcode),
+          cmocka_unit_test(test_az_json_validate),
+          cmocka_unit_test(test_az_json_reader_validate_utf8),
+          cmocka_unit_test(test_az_json_token_unescape_in_place),
           cmocka_unit_test(test_json_reader),
           cmocka_unit_test(test_json_reader_invalid),
           cmocka_unit_test(test_json_reader_incomplete),
@@ -2843,6 +4462,14 @@ int test_az_json()
           cmocka_unit_test(test_az_json_token_number_too_large),
           cmocka_unit_test(test_az_json_token_literal),
           cmocka_unit_test(test_az_json_token_copy),
-          cmocka_unit_test(test_az_json_reader_chunked) };
+          cmocka_unit_test(test_az_json_reader_chunked),
+          cmocka_unit_test(test_az_json_reader_long_strings),
+          cmocka_unit_test(test_az_json_reader_long_whitespace),
+          cmocka_unit_test(test_az_json_document),
+          cmocka_unit_test(test_az_json_document_property_value),
+          cmocka_unit_test(test_az_json_property_name_table),
+          cmocka_unit_test(test_az_json_binding),
+          cmocka_unit_test(test_az_json_reader_push),
+          cmocka_unit_test(test_az_json_nesting_buffer) };
   return cmocka_run_group_tests_name("az_core_json", tests, NULL, NULL);
 }
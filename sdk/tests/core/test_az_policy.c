@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // SPDX-License-Identifier: MIT
 
+#include "az_http_private.h"
 #include "az_test_definitions.h"
 #include <azure/core/az_credentials.h>
 #include <azure/core/az_http.h>
@@ -38,6 +39,9 @@ void test_az_http_pipeline_policy_credential(void** state);
 void test_az_http_pipeline_policy_retry(void** state);
 void test_az_http_pipeline_policy_retry_with_header(void** state);
 void test_az_http_pipeline_policy_retry_with_header_2(void** state);
+void test_az_http_pipeline_prepare_and_complete_request(void** state);
+void test_az_http_pipeline_policy_retry_deferred(void** state);
+void test_az_http_pipeline_policy_retry_body_callback(void** state);
 #endif // _az_MOCK_ENABLED
 
 static az_result test_policy_transport(
@@ -359,6 +363,329 @@ void test_az_http_pipeline_policy_retry_with_header_2(void** state)
       az_http_pipeline_policy_retry(policies, &retry_options, &request, &response), AZ_OK);
 }
 
+void test_az_http_pipeline_prepare_and_complete_request(void** state)
+{
+  (void)state;
+
+  uint8_t buf[100];
+  uint8_t header_buf[(2 * sizeof(_az_http_request_header))];
+  memset(buf, 0, sizeof(buf));
+  memset(header_buf, 0, sizeof(header_buf));
+
+  az_span url_span = AZ_SPAN_FROM_BUFFER(buf);
+  az_span remainder = az_span_copy(url_span, AZ_SPAN_FROM_STR("url"));
+  assert_int_equal(az_span_size(remainder), 97);
+  az_span header_span = AZ_SPAN_FROM_BUFFER(header_buf);
+  az_http_request request;
+
+  assert_return_code(
+      az_http_request_init(
+          &request,
+          &az_context_application,
+          az_http_method_get(),
+          url_span,
+          3,
+          header_span,
+          AZ_SPAN_EMPTY),
+      AZ_OK);
+
+  _az_http_policy_telemetry_options telemetry_options = _az_http_policy_telemetry_options_default();
+  _az_http_policy_apiversion_options api_version_options
+      = _az_http_policy_apiversion_options_default();
+  api_version_options._internal.name = AZ_SPAN_FROM_STR("api-version");
+  api_version_options._internal.version = AZ_SPAN_FROM_STR("2021-03-01");
+
+  az_http_policy_retry_options retry_options = _az_http_policy_retry_options_default();
+  // make just one retry
+  retry_options.max_retries = 1;
+
+  _az_http_pipeline pipeline = (_az_http_pipeline){
+        ._internal = {
+          .policies = {
+            {
+              ._internal = {
+                .process = az_http_pipeline_policy_telemetry,
+                .options = &telemetry_options,
+              },
+            },
+            {
+              ._internal = {
+                .process = az_http_pipeline_policy_retry,
+                .options = &retry_options,
+              },
+            },
+            {
+              ._internal = {
+                .process = az_http_pipeline_policy_apiversion,
+                .options = &api_version_options,
+              },
+            },
+            {
+              ._internal = {
+                .process = az_http_pipeline_policy_transport,
+                .options = NULL,
+              },
+            },
+        },
+      },
+  };
+
+  uint8_t response_buf[100];
+  az_http_response response;
+  assert_return_code(
+      az_http_response_init(&response, AZ_SPAN_FROM_BUFFER(response_buf)), AZ_OK);
+
+  // The policies run up to the transport policy, which doesn't send the request.
+  assert_return_code(
+      _az_http_pipeline_prepare_request(&pipeline, &request, &response, 1), AZ_OK);
+  assert_int_equal(az_http_request_headers_count(&request), 2);
+  assert_true(response._internal.is_retriable);
+
+  // The retry policy honors the retry-after-ms header, instead of waiting.
+  assert_return_code(az_http_response_init(&response, retry_response_with_header), AZ_OK);
+  int32_t retry_after_msec = 0;
+  assert_return_code(
+      _az_http_pipeline_complete_request(
+          &pipeline, &request, &response, AZ_OK, 0, 1, &retry_after_msec),
+      AZ_OK);
+  assert_int_equal(retry_after_msec, 1600);
+
+  // A retry only runs the policies after the retry policy again, replacing the headers they added.
+  will_return(__wrap_az_platform_clock_msec, 0);
+  assert_return_code(
+      _az_http_pipeline_prepare_request(&pipeline, &request, &response, 2), AZ_OK);
+  assert_int_equal(az_http_request_headers_count(&request), 2);
+  assert_false(response._internal.is_retriable);
+
+  // No retries are left.
+  assert_return_code(az_http_response_init(&response, retry_response), AZ_OK);
+  assert_return_code(
+      _az_http_pipeline_complete_request(
+          &pipeline, &request, &response, AZ_OK, 0, 2, &retry_after_msec),
+      AZ_OK);
+  assert_int_equal(retry_after_msec, -1);
+
+  // A failed request isn't retried.
+  assert_int_equal(
+      _az_http_pipeline_complete_request(
+          &pipeline, &request, &response, AZ_ERROR_HTTP_ADAPTER, 0, 1, &retry_after_msec),
+      AZ_ERROR_HTTP_ADAPTER);
+  assert_int_equal(retry_after_msec, -1);
+}
+
+void test_az_http_pipeline_policy_retry_deferred(void** state)
+{
+  (void)state;
+
+  uint8_t buf[100];
+  uint8_t header_buf[(2 * sizeof(_az_http_request_header))];
+  memset(buf, 0, sizeof(buf));
+  memset(header_buf, 0, sizeof(header_buf));
+
+  az_span url_span = AZ_SPAN_FROM_BUFFER(buf);
+  az_span remainder = az_span_copy(url_span, AZ_SPAN_FROM_STR("url"));
+  assert_int_equal(az_span_size(remainder), 97);
+  az_span header_span = AZ_SPAN_FROM_BUFFER(header_buf);
+  az_http_request request;
+
+  assert_return_code(
+      az_http_request_init(
+          &request,
+          &az_context_application,
+          az_http_method_get(),
+          url_span,
+          3,
+          header_span,
+          AZ_SPAN_EMPTY),
+      AZ_OK);
+
+  _az_http_policy_telemetry_options telemetry_options = _az_http_policy_telemetry_options_default();
+
+  az_http_policy_retry_options retry_options = _az_http_policy_retry_options_default();
+  retry_options.max_retries = 1;
+  retry_options.defer_retries = true;
+
+  _az_http_pipeline pipeline = (_az_http_pipeline){
+        ._internal = {
+          .policies = {
+            {
+              ._internal = {
+                .process = az_http_pipeline_policy_telemetry,
+                .options = &telemetry_options,
+              },
+            },
+            {
+              ._internal = {
+                .process = az_http_pipeline_policy_retry,
+                .options = &retry_options,
+              },
+            },
+            {
+              ._internal = {
+                .process = test_policy_transport_retry_response_with_header,
+                .options = NULL,
+              },
+            },
+        },
+      },
+  };
+
+  int64_t retry_at_msec = 0;
+  int32_t retry_after_msec = 0;
+  assert_int_equal(
+      az_http_request_get_retry_at_msec(&request, &retry_at_msec, &retry_after_msec),
+      AZ_ERROR_HTTP_INVALID_STATE);
+
+  // The retry policy returns when the request must be retried, instead of waiting.
+  will_return(__wrap_az_platform_clock_msec, 1000);
+  az_http_response response;
+  assert_int_equal(
+      az_http_pipeline_process(&pipeline, &request, &response), AZ_ERROR_HTTP_RETRY_PENDING);
+  assert_return_code(
+      az_http_request_get_retry_at_msec(&request, &retry_at_msec, &retry_after_msec), AZ_OK);
+  assert_int_equal(retry_at_msec, 2600);
+  assert_int_equal(retry_after_msec, 1600);
+  assert_int_equal(az_http_request_headers_count(&request), 1);
+
+  // Processing the request again resumes at the retry policy, which has no retries left.
+  will_return(__wrap_az_platform_clock_msec, 2600);
+  assert_return_code(az_http_pipeline_process(&pipeline, &request, &response), AZ_OK);
+  assert_int_equal(az_http_request_headers_count(&request), 1);
+  assert_int_equal(
+      az_http_request_get_retry_at_msec(&request, &retry_at_msec, NULL),
+      AZ_ERROR_HTTP_INVALID_STATE);
+}
+
+// Writes the status line and headers of the next response, then its body as a transport adapter
+// does, one segment at a time.
+static az_result test_policy_transport_body_responses(
+    _az_http_policy* ref_policies,
+    void* ref_options,
+    az_http_request* ref_request,
+    az_http_response* ref_response)
+{
+  (void)ref_policies;
+  (void)ref_request;
+
+  // As az_http_pipeline_policy_transport() does.
+  _az_http_response_reset(ref_response);
+
+  static az_span const status_lines[] = {
+    AZ_SPAN_LITERAL_FROM_STR("HTTP/1.1 503 Service Unavailable\r\n\r\n"),
+    AZ_SPAN_LITERAL_FROM_STR("HTTP/1.1 503 Service Unavailable\r\n\r\n"),
+    AZ_SPAN_LITERAL_FROM_STR("HTTP/1.1 200 OK\r\n\r\n"),
+  };
+  static az_span const bodies[] = {
+    AZ_SPAN_LITERAL_FROM_STR("busy 1"),
+    AZ_SPAN_LITERAL_FROM_STR("busy 2"),
+    AZ_SPAN_LITERAL_FROM_STR("done"),
+  };
+
+  int32_t* const attempt = (int32_t*)ref_options;
+  az_span const body = bodies[*attempt];
+
+  assert_return_code(az_http_response_append(ref_response, status_lines[*attempt]), AZ_OK);
+  assert_return_code(
+      az_http_response_append_body(ref_response, az_span_slice(body, 0, 2)), AZ_OK);
+  assert_return_code(
+      az_http_response_append_body(ref_response, az_span_slice_to_end(body, 2)), AZ_OK);
+
+  ++*attempt;
+  return AZ_OK;
+}
+
+typedef struct
+{
+  uint8_t buffer[32];
+  int32_t written;
+} test_policy_body_sink;
+
+static az_result test_policy_body_callback(az_span body_segment, void* user_context)
+{
+  test_policy_body_sink* const sink = (test_policy_body_sink*)user_context;
+  az_span remaining = az_span_slice_to_end(AZ_SPAN_FROM_BUFFER(sink->buffer), sink->written);
+  if (az_span_size(remaining) < az_span_size(body_segment))
+  {
+    return AZ_ERROR_NOT_ENOUGH_SPACE;
+  }
+
+  az_span_copy(remaining, body_segment);
+  sink->written += az_span_size(body_segment);
+  return AZ_OK;
+}
+
+void test_az_http_pipeline_policy_retry_body_callback(void** state)
+{
+  (void)state;
+
+  uint8_t buf[100];
+  uint8_t header_buf[(2 * sizeof(_az_http_request_header))];
+  memset(buf, 0, sizeof(buf));
+  memset(header_buf, 0, sizeof(header_buf));
+
+  az_span url_span = AZ_SPAN_FROM_BUFFER(buf);
+  az_span remainder = az_span_copy(url_span, AZ_SPAN_FROM_STR("url"));
+  assert_int_equal(az_span_size(remainder), 97);
+  az_span header_span = AZ_SPAN_FROM_BUFFER(header_buf);
+  az_http_request request;
+
+  assert_return_code(
+      az_http_request_init(
+          &request,
+          &az_context_application,
+          az_http_method_get(),
+          url_span,
+          3,
+          header_span,
+          AZ_SPAN_EMPTY),
+      AZ_OK);
+
+  az_http_policy_retry_options retry_options = _az_http_policy_retry_options_default();
+  int32_t attempt = 0;
+
+  _az_http_policy policies[1] = {
+            {
+              ._internal = {
+                .process = test_policy_transport_body_responses,
+                .options = &attempt,
+              },
+            },
+        };
+
+  uint8_t response_buf[64];
+  test_policy_body_sink sink = { 0 };
+  az_http_response response;
+  assert_return_code(
+      az_http_response_init(&response, AZ_SPAN_FROM_BUFFER(response_buf)), AZ_OK);
+  az_http_response_set_body_callback(&response, test_policy_body_callback, &sink);
+
+  // Only the body of the response which isn't retried is passed to the callback.
+  will_return_count(__wrap_az_platform_clock_msec, 0, 2);
+  assert_return_code(
+      az_http_pipeline_policy_retry(policies, &retry_options, &request, &response), AZ_OK);
+  assert_int_equal(attempt, 3);
+  assert_int_equal(sink.written, 4);
+  assert_memory_equal(sink.buffer, "done", 4);
+  assert_int_equal(response._internal.body_status_code, AZ_HTTP_STATUS_CODE_OK);
+
+  az_http_response_status_line status_line = { 0 };
+  assert_return_code(az_http_response_get_status_line(&response, &status_line), AZ_OK);
+  assert_int_equal(status_line.status_code, AZ_HTTP_STATUS_CODE_OK);
+
+  // The body of the last attempt is passed to the callback, even if its status code asks for a
+  // retry.
+  retry_options.max_retries = 1;
+  attempt = 0;
+  sink.written = 0;
+  will_return(__wrap_az_platform_clock_msec, 0);
+  assert_return_code(
+      az_http_pipeline_policy_retry(policies, &retry_options, &request, &response), AZ_OK);
+  assert_int_equal(attempt, 2);
+  assert_int_equal(sink.written, 6);
+  assert_memory_equal(sink.buffer, "busy 2", 6);
+  assert_false(response._internal.is_retriable);
+}
+
 az_result __wrap_az_platform_clock_msec(int64_t* out_clock_msec);
 az_result __wrap_az_platform_clock_msec(int64_t* out_clock_msec)
 {
@@ -383,6 +710,9 @@ int test_az_policy()
     cmocka_unit_test(test_az_http_pipeline_policy_retry),
     cmocka_unit_test(test_az_http_pipeline_policy_retry_with_header),
     cmocka_unit_test(test_az_http_pipeline_policy_retry_with_header_2),
+    cmocka_unit_test(test_az_http_pipeline_prepare_and_complete_request),
+    cmocka_unit_test(test_az_http_pipeline_policy_retry_deferred),
+    cmocka_unit_test(test_az_http_pipeline_policy_retry_body_callback),
 #endif // _az_MOCK_ENABLED
     cmocka_unit_test(test_az_http_pipeline_policy_apiversion),
     cmocka_unit_test(test_az_http_pipeline_policy_telemetry),
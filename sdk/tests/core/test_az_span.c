@@ -14,6 +14,9 @@
 #include <math.h>
 #include <setjmp.h>
 #include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include <cmocka.h>
 
@@ -79,6 +82,36 @@ static void az_single_char_ascii_lower_test(void** state)
   }
 }
 
+static void az_span_is_content_equal_ignoring_case_long_test(void** state)
+{
+  (void)state;
+
+  // Spans long enough to be compared several bytes at a time, with a differently cased filler, and
+  // every pair of bytes at positions within the first word, on a word boundary, and past the last
+  // whole word.
+  int32_t const positions[] = { 0, 7, 8, 17 };
+  for (size_t p = 0; p < sizeof(positions) / sizeof(positions[0]); p++)
+  {
+    for (int32_t i = 0; i <= UINT8_MAX; i++)
+    {
+      for (int32_t j = 0; j <= UINT8_MAX; j++)
+      {
+        uint8_t buffer1[18] = "header-NAME-value";
+        uint8_t buffer2[18] = "HEADER-name-VALUE";
+        buffer1[positions[p]] = (uint8_t)i;
+        buffer2[positions[p]] = (uint8_t)j;
+
+        int32_t const lower_i = i >= 'A' && i <= 'Z' ? i + 32 : i;
+        int32_t const lower_j = j >= 'A' && j <= 'Z' ? j + 32 : j;
+        assert_int_equal(
+            az_span_is_content_equal_ignoring_case(
+                AZ_SPAN_FROM_BUFFER(buffer1), AZ_SPAN_FROM_BUFFER(buffer2)),
+            lower_i == lower_j);
+      }
+    }
+  }
+}
+
 static void az_span_to_lower_test(void** state)
 {
   (void)state;
@@ -669,6 +702,48 @@ static void az_span_atod_non_finite_not_allowed(void** state)
   assert_int_equal(az_span_atod(AZ_SPAN_FROM_STR("1.8e309"), &value), AZ_ERROR_UNEXPECTED_CHAR);
 }
 
+static void az_span_atod_matches_strtod(void** state)
+{
+  (void)state;
+
+  // Sensor-like values, with and without a fraction and an exponent, on both sides of the limits of
+  // the exact fast path (a significand below 2^53 and a power of ten up to 22).
+  char const* const significands[] = {
+    "0",          "1",          "7",         "23.5",        "-40.25",         "0.1",
+    "0.3",        "1013.25",    "-0.0",      "98.6",        "3.14159",        "65535",
+    "0.00012207", "123456.789", "1.0000001", "9007199254740991", "9007199254740993",
+    "0.30000000000000004",      "+12.5",     "2.2250738585072011",
+  };
+  char const* const exponents[] = { "",     "e0",   "e5",   "E-5",  "e+22", "e-22",
+                                    "e23",  "e-23", "e30",  "e37",  "e-38", "e300" };
+
+  char buffer[64] = { 0 };
+  for (size_t i = 0; i < sizeof(significands) / sizeof(significands[0]); i++)
+  {
+    for (size_t j = 0; j < sizeof(exponents) / sizeof(exponents[0]); j++)
+    {
+      int const size = snprintf(buffer, sizeof(buffer), "%s%s", significands[i], exponents[j]);
+      double const expected = strtod(buffer, NULL);
+      if (!isfinite(expected))
+      {
+        continue;
+      }
+
+      double value = 0;
+      assert_int_equal(
+          az_span_atod(az_span_create((uint8_t*)buffer, (int32_t)size), &value), AZ_OK);
+      assert_memory_equal(&value, &expected, sizeof(double));
+    }
+  }
+
+  double value = 0;
+  assert_int_equal(az_span_atod(AZ_SPAN_FROM_STR("-"), &value), AZ_ERROR_UNEXPECTED_CHAR);
+  assert_int_equal(az_span_atod(AZ_SPAN_FROM_STR("+."), &value), AZ_ERROR_UNEXPECTED_CHAR);
+  assert_int_equal(az_span_atod(AZ_SPAN_FROM_STR("1.2.3"), &value), AZ_ERROR_UNEXPECTED_CHAR);
+  assert_int_equal(az_span_atod(AZ_SPAN_FROM_STR("1e5x"), &value), AZ_ERROR_UNEXPECTED_CHAR);
+  assert_int_equal(az_span_atod(AZ_SPAN_FROM_STR("12 "), &value), AZ_ERROR_UNEXPECTED_CHAR);
+}
+
 static void az_span_ato_number_whitespace_or_invalid_not_allowed(void** state)
 {
   (void)state;
@@ -934,6 +1009,142 @@ static void az_span_find_overlapping_checks_success(void** state)
   assert_int_equal(az_span_find(source, az_span_slice(span, 2, 4)), 1);
 }
 
+static void az_span_find_partial_matches_success(void** state)
+{
+  (void)state;
+
+  az_span topic = AZ_SPAN_FROM_STR("$iothub/twin/PATCH/properties/desired/?$rid=1&$version=4");
+  assert_int_equal(az_span_find(topic, AZ_SPAN_FROM_STR("$iothub/twin/res/")), -1);
+  assert_int_equal(az_span_find(topic, AZ_SPAN_FROM_STR("$version=")), 46);
+  assert_int_equal(az_span_find(topic, AZ_SPAN_FROM_STR("=4")), 54);
+  assert_int_equal(az_span_find(topic, AZ_SPAN_FROM_STR("=5")), -1);
+
+  // The first and last bytes match, but not the ones in between.
+  assert_int_equal(az_span_find(AZ_SPAN_FROM_STR("axxbaxbbayb"), AZ_SPAN_FROM_STR("ayb")), 8);
+  assert_int_equal(az_span_find(AZ_SPAN_FROM_STR("axxbaxbbaxb"), AZ_SPAN_FROM_STR("ayb")), -1);
+}
+
+static void az_span_find_long_target_success(void** state)
+{
+  (void)state;
+
+  // Targets of at least 32 bytes are searched with a different algorithm.
+  az_span topic = AZ_SPAN_FROM_STR(
+      "$iothub/twin/PATCH/properties/desired/?$rid=1&$iothub/twin/PATCH/properties/reported/");
+  assert_int_equal(
+      az_span_find(topic, AZ_SPAN_FROM_STR("$iothub/twin/PATCH/properties/reported/")), 46);
+  assert_int_equal(
+      az_span_find(topic, AZ_SPAN_FROM_STR("$iothub/twin/PATCH/properties/desired/?")), 0);
+  assert_int_equal(
+      az_span_find(topic, AZ_SPAN_FROM_STR("$iothub/twin/PATCH/properties/removed/")), -1);
+
+  // Periodic targets.
+  uint8_t source[300];
+  uint8_t target[100];
+  memset(source, 'a', sizeof(source));
+  memset(target, 'a', sizeof(target));
+  assert_int_equal(az_span_find(AZ_SPAN_FROM_BUFFER(source), AZ_SPAN_FROM_BUFFER(target)), 0);
+
+  for (size_t i = 0; i < sizeof(source); i += 3)
+  {
+    source[i] = 'b';
+  }
+  for (size_t i = 0; i < sizeof(target); i += 3)
+  {
+    target[i] = 'b';
+  }
+  assert_int_equal(az_span_find(AZ_SPAN_FROM_BUFFER(source), AZ_SPAN_FROM_BUFFER(target)), 0);
+  assert_int_equal(
+      az_span_find(
+          AZ_SPAN_FROM_BUFFER(source), az_span_slice_to_end(AZ_SPAN_FROM_BUFFER(target), 1)),
+      1);
+
+  source[99] = 'a';
+  assert_int_equal(az_span_find(AZ_SPAN_FROM_BUFFER(source), AZ_SPAN_FROM_BUFFER(target)), 102);
+  source[201] = 'a';
+  assert_int_equal(az_span_find(AZ_SPAN_FROM_BUFFER(source), AZ_SPAN_FROM_BUFFER(target)), -1);
+}
+
+static void az_span_find_worst_case_success(void** state)
+{
+  (void)state;
+
+  // Every position of the source matches all of the target but its last byte, or its middle one.
+  uint8_t source[4096];
+  uint8_t target[64];
+  memset(source, 'a', sizeof(source));
+  memset(target, 'a', sizeof(target));
+
+  target[sizeof(target) - 1] = 'b';
+  assert_int_equal(az_span_find(AZ_SPAN_FROM_BUFFER(source), AZ_SPAN_FROM_BUFFER(target)), -1);
+  source[sizeof(source) - 1] = 'b';
+  assert_int_equal(
+      az_span_find(AZ_SPAN_FROM_BUFFER(source), AZ_SPAN_FROM_BUFFER(target)),
+      (int32_t)(sizeof(source) - sizeof(target)));
+
+  target[sizeof(target) - 1] = 'a';
+  target[sizeof(target) / 2] = 'b';
+  assert_int_equal(az_span_find(AZ_SPAN_FROM_BUFFER(source), AZ_SPAN_FROM_BUFFER(target)), -1);
+  source[1000] = 'b';
+  assert_int_equal(
+      az_span_find(AZ_SPAN_FROM_BUFFER(source), AZ_SPAN_FROM_BUFFER(target)),
+      (int32_t)(1000 - sizeof(target) / 2));
+}
+
+static int32_t _naive_find(az_span source, az_span target)
+{
+  for (int32_t i = 0; i <= az_span_size(source) - az_span_size(target); i++)
+  {
+    if (az_span_is_content_equal(az_span_slice(source, i, i + az_span_size(target)), target))
+    {
+      return i;
+    }
+  }
+  return -1;
+}
+
+static void az_span_find_matches_naive_search_success(void** state)
+{
+  (void)state;
+
+  // Small alphabets make partial matches, and periodic targets, common.
+  uint32_t seed = 12345;
+  uint8_t source[200];
+  uint8_t target[80];
+  for (int32_t iteration = 0; iteration < 5000; iteration++)
+  {
+    seed = seed * 1103515245 + 12345;
+    uint8_t const alphabet_size = (uint8_t)(1 + (seed >> 16) % 3);
+    int32_t const target_size = (int32_t)((seed >> 8) % sizeof(target)) + 1;
+
+    for (size_t i = 0; i < sizeof(source); i++)
+    {
+      seed = seed * 1103515245 + 12345;
+      source[i] = (uint8_t)('a' + (seed >> 16) % alphabet_size);
+    }
+
+    // Half of the targets are taken from the source, to be found.
+    seed = seed * 1103515245 + 12345;
+    if ((seed >> 16) % 2 == 0)
+    {
+      int32_t const offset = (int32_t)((seed >> 8) % (sizeof(source) - (size_t)target_size));
+      memcpy(target, source + offset, (size_t)target_size);
+    }
+    else
+    {
+      for (int32_t i = 0; i < target_size; i++)
+      {
+        seed = seed * 1103515245 + 12345;
+        target[i] = (uint8_t)('a' + (seed >> 16) % alphabet_size);
+      }
+    }
+
+    az_span const source_span = AZ_SPAN_FROM_BUFFER(source);
+    az_span const target_span = az_span_create(target, target_size);
+    assert_int_equal(az_span_find(source_span, target_span), _naive_find(source_span, target_span));
+  }
+}
+
 static void az_span_i64toa_test(void** state)
 {
   (void)state;
@@ -1187,6 +1398,59 @@ static void az_span_u32toa_overflow_fails(void** state)
   assert_true(az_span_u32toa(buffer, v, &out_span) == AZ_ERROR_NOT_ENOUGH_SPACE);
 }
 
+static void az_span_itoa_digit_count_boundaries(void** state)
+{
+  (void)state;
+
+  uint8_t raw_buffer[21] = { 0 };
+  char expected[22] = { 0 };
+
+  // Check both sides of every power of ten, where the number of digits changes, as well as the
+  // 8 digit chunks of 64-bit numbers.
+  uint64_t power_of_ten = 1;
+  for (int32_t digits = 1; digits <= 20; digits++)
+  {
+    uint64_t const candidates[]
+        = { power_of_ten - 1, power_of_ten, power_of_ten + 1, UINT64_MAX - power_of_ten };
+    for (size_t i = 0; i < sizeof(candidates) / sizeof(candidates[0]); i++)
+    {
+      uint64_t const value = candidates[i];
+      int32_t const size
+          = (int32_t)snprintf(expected, sizeof(expected), "%llu", (unsigned long long)value);
+      assert_int_equal(_az_span_u64toa_size(value), size);
+
+      az_span buffer = AZ_SPAN_FROM_BUFFER(raw_buffer);
+      az_span out_span = AZ_SPAN_EMPTY;
+      assert_int_equal(az_span_u64toa(buffer, value, &out_span), AZ_OK);
+      assert_int_equal(az_span_size(out_span), az_span_size(buffer) - size);
+      assert_memory_equal(raw_buffer, expected, (size_t)size);
+
+      assert_int_equal(
+          az_span_u64toa(az_span_slice(buffer, 0, size - 1), value, &out_span),
+          AZ_ERROR_NOT_ENOUGH_SPACE);
+
+      if (value <= UINT32_MAX)
+      {
+        assert_int_equal(az_span_u32toa(buffer, (uint32_t)value, &out_span), AZ_OK);
+        assert_int_equal(az_span_size(out_span), az_span_size(buffer) - size);
+        assert_memory_equal(raw_buffer, expected, (size_t)size);
+
+        assert_int_equal(
+            az_span_u32toa(az_span_slice(buffer, 0, size - 1), (uint32_t)value, &out_span),
+            AZ_ERROR_NOT_ENOUGH_SPACE);
+      }
+    }
+
+    if (digits < 20)
+    {
+      power_of_ten *= 10;
+    }
+  }
+
+  assert_int_equal(_az_span_u64toa_size(0), 1);
+  assert_int_equal(_az_span_u64toa_size(UINT64_MAX), 20);
+}
+
 #define AZ_SPAN_DTOA_SUCCEEDS_HELPER(v, fractional_digits, expected)                         \
   do                                                                                         \
   {                                                                                          \
@@ -1493,6 +1757,66 @@ static void az_span_dtoa_too_large(void** state)
   assert_int_equal(az_span_dtoa(buff, 1.7e308, 15, &o), AZ_ERROR_NOT_SUPPORTED);
 }
 
+#define AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(v, expected)                                     \
+  do                                                                                         \
+  {                                                                                          \
+    az_span buffer = AZ_SPAN_FROM_BUFFER(raw_buffer);                                        \
+    az_span out_span = AZ_SPAN_EMPTY;                                                        \
+    assert_true(az_result_succeeded(az_span_dtoa_shortest(buffer, v, &out_span)));           \
+    az_span output = az_span_slice(buffer, 0, _az_span_diff(out_span, buffer));              \
+    assert_true(az_span_is_content_equal(output, expected));                                 \
+    double round_trip = 0;                                                                   \
+    assert_true(az_result_succeeded(az_span_atod(output, &round_trip)));                     \
+    double const value = v;                                                                  \
+    assert_memory_equal(&round_trip, &value, sizeof(double));                                \
+    assert_int_equal(                                                                        \
+        az_span_dtoa_shortest(                                                               \
+            az_span_slice(buffer, 0, az_span_size(expected) - 1), v, &out_span),             \
+        AZ_ERROR_NOT_ENOUGH_SPACE);                                                          \
+  } while (0)
+
+static void az_span_dtoa_shortest_succeeds(void** state)
+{
+  (void)state;
+
+  // We don't need more than 25 bytes to hold any double: [-]0.00000[0-9]{17}, i.e. 1+2+5+17
+  uint8_t raw_buffer[25] = { 0 };
+
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(0, AZ_SPAN_FROM_STR("0"));
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(-0.0, AZ_SPAN_FROM_STR("-0"));
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(1, AZ_SPAN_FROM_STR("1"));
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(-1, AZ_SPAN_FROM_STR("-1"));
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(100, AZ_SPAN_FROM_STR("100"));
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(0.1, AZ_SPAN_FROM_STR("0.1"));
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(0.3, AZ_SPAN_FROM_STR("0.3"));
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(0.1 + 0.2, AZ_SPAN_FROM_STR("0.30000000000000004"));
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(-1013.25, AZ_SPAN_FROM_STR("-1013.25"));
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(23.5, AZ_SPAN_FROM_STR("23.5"));
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(98.6, AZ_SPAN_FROM_STR("98.6"));
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(123.456, AZ_SPAN_FROM_STR("123.456"));
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(1.0000000001, AZ_SPAN_FROM_STR("1.0000000001"));
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(2147483647, AZ_SPAN_FROM_STR("2147483647"));
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(9007199254740991, AZ_SPAN_FROM_STR("9007199254740991"));
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(
+      (double)9007199254740993, AZ_SPAN_FROM_STR("9007199254740992"));
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(1e20, AZ_SPAN_FROM_STR("100000000000000000000"));
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(
+      123456789012345678901.0, AZ_SPAN_FROM_STR("123456789012345680000"));
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(1e21, AZ_SPAN_FROM_STR("1e+21"));
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(-1.5e300, AZ_SPAN_FROM_STR("-1.5e+300"));
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(0.000001, AZ_SPAN_FROM_STR("0.000001"));
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(
+      -0.0000054557345522995, AZ_SPAN_FROM_STR("-0.0000054557345522995"));
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(1e-7, AZ_SPAN_FROM_STR("1e-7"));
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(1.5e-7, AZ_SPAN_FROM_STR("1.5e-7"));
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(1e-300, AZ_SPAN_FROM_STR("1e-300"));
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(
+      1.7976931348623157e308, AZ_SPAN_FROM_STR("1.7976931348623157e+308"));
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(
+      2.2250738585072014e-308, AZ_SPAN_FROM_STR("2.2250738585072014e-308"));
+  AZ_SPAN_DTOA_SHORTEST_SUCCEEDS_HELPER(5e-324, AZ_SPAN_FROM_STR("5e-324"));
+}
+
 static void az_span_copy_empty(void** state)
 {
   (void)state;
@@ -1755,6 +2079,7 @@ int test_az_span()
     cmocka_unit_test(az_span_slice_to_end_test),
     cmocka_unit_test(test_az_span_getters),
     cmocka_unit_test(az_single_char_ascii_lower_test),
+    cmocka_unit_test(az_span_is_content_equal_ignoring_case_long_test),
     cmocka_unit_test(az_span_to_lower_test),
     cmocka_unit_test(az_span_to_str_test),
     cmocka_unit_test(test_az_span_is_content_equal),
@@ -1771,6 +2096,10 @@ int test_az_span()
     cmocka_unit_test(az_span_find_embedded_NULLs_success),
     cmocka_unit_test(az_span_find_capacity_checks_success),
     cmocka_unit_test(az_span_find_overlapping_checks_success),
+    cmocka_unit_test(az_span_find_partial_matches_success),
+    cmocka_unit_test(az_span_find_long_target_success),
+    cmocka_unit_test(az_span_find_worst_case_success),
+    cmocka_unit_test(az_span_find_matches_naive_search_success),
     cmocka_unit_test(az_span_atox_return_errors),
     cmocka_unit_test(az_span_atou32_test),
     cmocka_unit_test(az_span_atoi32_test),
@@ -1779,6 +2108,7 @@ int test_az_span()
     cmocka_unit_test(test_az_isfinite),
     cmocka_unit_test(az_span_atod_test),
     cmocka_unit_test(az_span_atod_non_finite_not_allowed),
+    cmocka_unit_test(az_span_atod_matches_strtod),
     cmocka_unit_test(az_span_ato_number_whitespace_or_invalid_not_allowed),
     cmocka_unit_test(az_span_ato_number_no_out_of_bounds_reads),
     cmocka_unit_test(az_span_i64toa_negative_number_test),
@@ -1787,6 +2117,7 @@ int test_az_span()
     cmocka_unit_test(az_span_create_from_str_succeeds),
     cmocka_unit_test(az_span_copy_uint8_succeeds),
     cmocka_unit_test(az_span_i32toa_succeeds),
+    cmocka_unit_test(az_span_itoa_digit_count_boundaries),
     cmocka_unit_test(az_span_i32toa_negative_succeeds),
     cmocka_unit_test(az_span_i32toa_max_int_succeeds),
     cmocka_unit_test(az_span_i32toa_zero_succeeds),
@@ -1798,6 +2129,7 @@ int test_az_span()
     cmocka_unit_test(az_span_dtoa_succeeds),
     cmocka_unit_test(az_span_dtoa_overflow_fails),
     cmocka_unit_test(az_span_dtoa_too_large),
+    cmocka_unit_test(az_span_dtoa_shortest_succeeds),
     cmocka_unit_test(az_span_copy_empty),
     cmocka_unit_test(test_az_span_is_valid),
     cmocka_unit_test(test_az_span_overlap),
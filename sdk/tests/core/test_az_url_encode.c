@@ -475,6 +475,79 @@ static void test_url_encode_full(void** state)
                        "****")));
 }
 
+static void test_url_decode(void** state)
+{
+  (void)state;
+  {
+    // Every byte value round trips through encoding and decoding.
+    uint8_t source[256] = { 0 };
+    for (int32_t i = 0; i < 256; i++)
+    {
+      source[i] = (uint8_t)i;
+    }
+
+    uint8_t encoded[256 * 3] = { 0 };
+    int32_t encoded_length = 0;
+    assert_true(az_result_succeeded(_az_span_url_encode(
+        AZ_SPAN_FROM_BUFFER(encoded), AZ_SPAN_FROM_BUFFER(source), &encoded_length)));
+
+    uint8_t decoded[256] = { 0 };
+    int32_t decoded_length = 0;
+    assert_true(az_result_succeeded(_az_span_url_decode(
+        AZ_SPAN_FROM_BUFFER(decoded),
+        az_span_create(encoded, encoded_length),
+        &decoded_length)));
+    assert_int_equal(decoded_length, 256);
+    assert_true(
+        az_span_is_content_equal(AZ_SPAN_FROM_BUFFER(decoded), AZ_SPAN_FROM_BUFFER(source)));
+  }
+  {
+    // Lower case hex digits, and '+' which isn't decoded, in place.
+    uint8_t buffer[] = "%24.to=%2fdevices%2Fmy+device&%24.ct=application%2Fjson";
+    az_span const span = az_span_create(buffer, (int32_t)sizeof(buffer) - 1);
+    int32_t decoded_length = 0;
+    assert_true(az_result_succeeded(_az_span_url_decode(span, span, &decoded_length)));
+    assert_true(az_span_is_content_equal(
+        az_span_slice(span, 0, decoded_length),
+        AZ_SPAN_FROM_STR("$.to=/devices/my+device&$.ct=application/json")));
+  }
+  {
+    int32_t decoded_length = 0xFF;
+    assert_true(az_result_succeeded(
+        _az_span_url_decode(AZ_SPAN_EMPTY, AZ_SPAN_EMPTY, &decoded_length)));
+    assert_int_equal(decoded_length, 0);
+  }
+  {
+    uint8_t buffer[8] = { 0 };
+    int32_t decoded_length = 0xFF;
+
+    assert_int_equal(
+        _az_span_url_decode(AZ_SPAN_FROM_BUFFER(buffer), AZ_SPAN_FROM_STR("a%2"), &decoded_length),
+        AZ_ERROR_UNEXPECTED_END);
+    assert_int_equal(decoded_length, 0);
+
+    decoded_length = 0xFF;
+    assert_int_equal(
+        _az_span_url_decode(AZ_SPAN_FROM_BUFFER(buffer), AZ_SPAN_FROM_STR("a%2G"), &decoded_length),
+        AZ_ERROR_UNEXPECTED_CHAR);
+    assert_int_equal(decoded_length, 0);
+
+    decoded_length = 0xFF;
+    assert_int_equal(
+        _az_span_url_decode(
+            az_span_create(buffer, 2), AZ_SPAN_FROM_STR("ab%20"), &decoded_length),
+        AZ_ERROR_NOT_ENOUGH_SPACE);
+    assert_int_equal(decoded_length, 0);
+
+    decoded_length = 0xFF;
+    assert_int_equal(
+        _az_span_url_decode(
+            az_span_create(buffer, 2), AZ_SPAN_FROM_STR("abc%20"), &decoded_length),
+        AZ_ERROR_NOT_ENOUGH_SPACE);
+    assert_int_equal(decoded_length, 0);
+  }
+}
+
 int test_az_url_encode()
 {
   struct CMUnitTest const tests[] = {
@@ -482,6 +555,7 @@ int test_az_url_encode()
     cmocka_unit_test(test_url_encode_preconditions),
     cmocka_unit_test(test_url_encode_usage),
     cmocka_unit_test(test_url_encode_full),
+    cmocka_unit_test(test_url_decode),
   };
 
   return cmocka_run_group_tests_name("az_core_encode", tests, NULL, NULL);
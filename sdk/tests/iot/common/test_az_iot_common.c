@@ -166,6 +166,15 @@ static void test_az_iot_message_properties_next_NULL_out_value_fail(void** state
   ASSERT_PRECONDITION_CHECKED(az_iot_message_properties_next(&props, &name, NULL));
 }
 
+static void test_az_iot_message_properties_decode_NULL_out_decoded_fail(void** state)
+{
+  (void)state;
+
+  uint8_t buffer[8];
+  ASSERT_PRECONDITION_CHECKED(az_iot_message_properties_decode(
+      AZ_SPAN_FROM_STR("%24.to"), AZ_SPAN_FROM_BUFFER(buffer), NULL));
+}
+
 static void test_az_iot_message_properties_next_written_less_than_size_succeed(void** state)
 {
   (void)state;
@@ -764,6 +773,64 @@ static void test_az_iot_message_properties_next_empty_succeed(void** state)
       az_iot_message_properties_next(&props, &name, &value), AZ_ERROR_IOT_END_OF_PROPERTIES);
 }
 
+static void test_az_iot_message_properties_decode_succeed(void** state)
+{
+  (void)state;
+
+  // The properties of a C2D message, as found in its received topic.
+  uint8_t received[] = "%24.to=%2Fdevices%2Fuseragent%2Fmessages%2Fdevicebound&key=a%26b";
+  az_span const received_span
+      = az_span_slice(AZ_SPAN_FROM_BUFFER(received), 0, (int32_t)sizeof(received) - 1);
+  az_iot_message_properties props;
+  assert_int_equal(
+      az_iot_message_properties_init(&props, received_span, az_span_size(received_span)), AZ_OK);
+
+  az_span name;
+  az_span value;
+  assert_int_equal(az_iot_message_properties_next(&props, &name, &value), AZ_OK);
+
+  uint8_t name_buffer[16];
+  az_span decoded_name;
+  assert_int_equal(
+      az_iot_message_properties_decode(name, AZ_SPAN_FROM_BUFFER(name_buffer), &decoded_name),
+      AZ_OK);
+  assert_true(az_span_is_content_equal(decoded_name, AZ_SPAN_FROM_STR("$.to")));
+
+  // Values can be decoded in place.
+  az_span decoded_value;
+  assert_int_equal(az_iot_message_properties_decode(value, value, &decoded_value), AZ_OK);
+  assert_true(az_span_ptr(decoded_value) == az_span_ptr(value));
+  assert_true(az_span_is_content_equal(
+      decoded_value, AZ_SPAN_FROM_STR("/devices/useragent/messages/devicebound")));
+
+  assert_int_equal(az_iot_message_properties_next(&props, &name, &value), AZ_OK);
+  assert_true(az_span_is_content_equal(name, AZ_SPAN_FROM_STR("key")));
+  assert_int_equal(
+      az_iot_message_properties_decode(value, AZ_SPAN_FROM_BUFFER(name_buffer), &decoded_value),
+      AZ_OK);
+  assert_true(az_span_is_content_equal(decoded_value, AZ_SPAN_FROM_STR("a&b")));
+}
+
+static void test_az_iot_message_properties_decode_fail(void** state)
+{
+  (void)state;
+
+  uint8_t buffer[4];
+  az_span decoded;
+  assert_int_equal(
+      az_iot_message_properties_decode(
+          AZ_SPAN_FROM_STR("%24.to"), az_span_slice(AZ_SPAN_FROM_BUFFER(buffer), 0, 3), &decoded),
+      AZ_ERROR_NOT_ENOUGH_SPACE);
+  assert_int_equal(
+      az_iot_message_properties_decode(
+          AZ_SPAN_FROM_STR("%2G"), AZ_SPAN_FROM_BUFFER(buffer), &decoded),
+      AZ_ERROR_UNEXPECTED_CHAR);
+  assert_int_equal(
+      az_iot_message_properties_decode(
+          AZ_SPAN_FROM_STR("a%2"), AZ_SPAN_FROM_BUFFER(buffer), &decoded),
+      AZ_ERROR_UNEXPECTED_END);
+}
+
 #ifdef _MSC_VER
 // warning C4113: 'void (__cdecl *)()' differs in parameter lists from 'CMUnitTestFunction'
 #pragma warning(disable : 4113)
@@ -790,6 +857,7 @@ int test_az_iot_common()
     cmocka_unit_test(test_az_iot_message_properties_next_NULL_out_name_fail),
     cmocka_unit_test(test_az_iot_message_properties_next_NULL_out_value_fail),
     cmocka_unit_test(test_az_iot_message_properties_next_written_less_than_size_succeed),
+    cmocka_unit_test(test_az_iot_message_properties_decode_NULL_out_decoded_fail),
 #endif // AZ_NO_PRECONDITION_CHECKING
     cmocka_unit_test(test_az_iot_u32toa_size_success),
     cmocka_unit_test(test_az_iot_u64toa_size_success),
@@ -822,6 +890,8 @@ int test_az_iot_common()
     cmocka_unit_test(test_az_iot_message_properties_next_succeed),
     cmocka_unit_test(test_az_iot_message_properties_next_twice_succeed),
     cmocka_unit_test(test_az_iot_message_properties_next_empty_succeed),
+    cmocka_unit_test(test_az_iot_message_properties_decode_succeed),
+    cmocka_unit_test(test_az_iot_message_properties_decode_fail),
   };
   return cmocka_run_group_tests_name("az_iot_common", tests, NULL, NULL);
 }
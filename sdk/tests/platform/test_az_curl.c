@@ -0,0 +1,290 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "test_az_curl.h"
+#include <az_test_precondition.h>
+#include <azure/core/az_context.h>
+#include <azure/core/az_http.h>
+#include <azure/core/az_http_transport.h>
+#include <azure/core/az_precondition.h>
+#include <azure/core/az_span.h>
+#include <azure/core/internal/az_http_internal.h>
+#include <azure/core/internal/az_precondition_internal.h>
+#include <azure/platform/az_curl.h>
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <curl/curl.h>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include <cmocka.h>
+
+#ifndef AZ_NO_PRECONDITION_CHECKING
+ENABLE_PRECONDITION_CHECK_TESTS()
+
+static void test_az_curl_connection_init_NULL_connection_fails(void** state)
+{
+  (void)state;
+
+  ASSERT_PRECONDITION_CHECKED(az_curl_connection_init(NULL, NULL));
+}
+
+static void test_az_curl_connection_init_negative_options_fails(void** state)
+{
+  (void)state;
+
+  az_curl_connection connection = { 0 };
+  az_curl_connection_options options = az_curl_connection_options_default();
+  options.idle_timeout_sec = -1;
+  ASSERT_PRECONDITION_CHECKED(az_curl_connection_init(&connection, &options));
+
+  options = az_curl_connection_options_default();
+  options.keep_alive_interval_sec = -1;
+  ASSERT_PRECONDITION_CHECKED(az_curl_connection_init(&connection, &options));
+}
+
+#endif // AZ_NO_PRECONDITION_CHECKING
+
+static void test_az_curl_connection_init_deinit_succeeds(void** state)
+{
+  (void)state;
+
+  az_curl_connection connection = { 0 };
+  assert_int_equal(az_curl_connection_init(&connection, NULL), AZ_OK);
+  assert_non_null(connection._internal.curl);
+
+  // NULL options are the default ones.
+  az_curl_connection_options const defaults = az_curl_connection_options_default();
+  assert_int_equal(connection._internal.options.idle_timeout_sec, defaults.idle_timeout_sec);
+  assert_int_equal(
+      connection._internal.options.keep_alive_interval_sec, defaults.keep_alive_interval_sec);
+
+  az_curl_connection_deinit(&connection);
+  assert_null(connection._internal.curl);
+
+  // Deinitializing twice does nothing.
+  az_curl_connection_deinit(&connection);
+  assert_null(connection._internal.curl);
+}
+
+static void test_az_curl_connection_init_options_succeeds(void** state)
+{
+  (void)state;
+
+  az_curl_connection_options options = az_curl_connection_options_default();
+  options.idle_timeout_sec = 30;
+  options.keep_alive_interval_sec = 0;
+
+  az_curl_connection connection = { 0 };
+  assert_int_equal(az_curl_connection_init(&connection, &options), AZ_OK);
+  assert_int_equal(connection._internal.options.idle_timeout_sec, 30);
+  assert_int_equal(connection._internal.options.keep_alive_interval_sec, 0);
+
+  az_curl_connection_deinit(&connection);
+}
+
+#ifndef _WIN32
+
+// Answers every request with a body holding the number of connections accepted so far, until it
+// has answered request_count requests.
+static void _test_serve_connection_count(int listener, int request_count)
+{
+  // Don't outlive the test if it fails before sending every request.
+  alarm(10);
+
+  int connection_count = 0;
+  int served_count = 0;
+  while (served_count < request_count)
+  {
+    int const client = accept(listener, NULL, NULL);
+    if (client < 0)
+    {
+      break;
+    }
+    connection_count++;
+
+    char request[2048];
+    size_t used = 0;
+    while (served_count < request_count && used < sizeof(request) - 1)
+    {
+      ssize_t const received = recv(client, request + used, sizeof(request) - 1 - used, 0);
+      if (received <= 0)
+      {
+        break;
+      }
+      used += (size_t)received;
+      request[used] = '\0';
+
+      char* const request_end = strstr(request, "\r\n\r\n");
+      if (request_end == NULL)
+      {
+        continue;
+      }
+
+      char response[128];
+      int const response_size = snprintf(
+          response,
+          sizeof(response),
+          "HTTP/1.1 200 OK\r\nContent-Length: 1\r\n\r\n%d",
+          connection_count % 10);
+      if (send(client, response, (size_t)response_size, 0) != response_size)
+      {
+        break;
+      }
+      served_count++;
+
+      size_t const request_size = (size_t)(request_end + 4 - request);
+      used -= request_size;
+      memmove(request, request + request_size, used);
+    }
+
+    close(client);
+  }
+
+  close(listener);
+  _exit(0);
+}
+
+// Starts a server, in a child process, listening on a loopback port.
+static pid_t _test_start_server(int request_count, uint16_t* out_port)
+{
+  int const listener = socket(AF_INET, SOCK_STREAM, 0);
+  assert_true(listener >= 0);
+
+  struct sockaddr_in address;
+  memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port = 0;
+  assert_int_equal(bind(listener, (struct sockaddr*)&address, sizeof(address)), 0);
+  assert_int_equal(listen(listener, 4), 0);
+
+  socklen_t address_size = sizeof(address);
+  assert_int_equal(getsockname(listener, (struct sockaddr*)&address, &address_size), 0);
+  *out_port = ntohs(address.sin_port);
+
+  pid_t const server = fork();
+  assert_true(server >= 0);
+  if (server == 0)
+  {
+    _test_serve_connection_count(listener, request_count);
+  }
+
+  close(listener);
+  return server;
+}
+
+// Sends a GET request, through the given connection, or the default one if it is NULL, and returns
+// the body of the response, which is the number of connections the server accepted.
+static int32_t _test_get_connection_count(az_curl_connection* connection, uint16_t port)
+{
+  char url[64];
+  int const url_length = snprintf(url, sizeof(url), "http://127.0.0.1:%u/", (unsigned)port);
+
+  uint8_t headers[64] = { 0 };
+  az_http_request request;
+  assert_int_equal(
+      az_http_request_init(
+          &request,
+          &az_context_application,
+          az_http_method_get(),
+          az_span_create((uint8_t*)url, (int32_t)sizeof(url)),
+          url_length,
+          AZ_SPAN_FROM_BUFFER(headers),
+          AZ_SPAN_EMPTY),
+      AZ_OK);
+
+  uint8_t response_buffer[256] = { 0 };
+  az_http_response response;
+  assert_int_equal(az_http_response_init(&response, AZ_SPAN_FROM_BUFFER(response_buffer)), AZ_OK);
+
+  if (connection == NULL)
+  {
+    assert_int_equal(az_http_client_send_request(&request, &response), AZ_OK);
+  }
+  else
+  {
+    assert_int_equal(az_curl_connection_send_request(connection, &request, &response), AZ_OK);
+  }
+
+  az_http_response_status_line status_line = { 0 };
+  assert_int_equal(az_http_response_get_status_line(&response, &status_line), AZ_OK);
+  assert_int_equal(status_line.status_code, AZ_HTTP_STATUS_CODE_OK);
+
+  // The body is at the start of the rest of the response buffer.
+  az_span body = AZ_SPAN_EMPTY;
+  assert_int_equal(az_http_response_get_body(&response, &body), AZ_OK);
+  assert_true(az_span_size(body) >= 1);
+  return az_span_ptr(body)[0] - '0';
+}
+
+static void test_az_curl_connection_reuses_connection(void** state)
+{
+  (void)state;
+
+  uint16_t port = 0;
+  pid_t const server = _test_start_server(5, &port);
+
+  az_curl_connection connection = { 0 };
+  assert_int_equal(az_curl_connection_init(&connection, NULL), AZ_OK);
+
+  // Requests sent through the same connection, directly or as the default one, reuse the TCP
+  // connection opened by the first one.
+  assert_int_equal(_test_get_connection_count(&connection, port), 1);
+  assert_int_equal(_test_get_connection_count(&connection, port), 1);
+  az_curl_set_default_connection(&connection);
+  assert_int_equal(_test_get_connection_count(NULL, port), 1);
+
+  // Deinitializing the default connection closes it and clears the default, so that the next
+  // request opens a new one instead of using the released handle.
+  az_curl_connection_deinit(&connection);
+  assert_null(connection._internal.curl);
+  assert_int_equal(_test_get_connection_count(NULL, port), 2);
+
+  // Without a default connection, every request opens a new one.
+  assert_int_equal(_test_get_connection_count(NULL, port), 3);
+
+  int status = 0;
+  assert_int_equal(waitpid(server, &status, 0), server);
+  assert_true(WIFEXITED(status));
+  assert_int_equal(WEXITSTATUS(status), 0);
+}
+
+#endif // _WIN32
+
+int test_az_curl()
+{
+#ifndef AZ_NO_PRECONDITION_CHECKING
+  SETUP_PRECONDITION_CHECK_TESTS();
+#endif // AZ_NO_PRECONDITION_CHECKING
+
+  const struct CMUnitTest tests[] = {
+#ifndef AZ_NO_PRECONDITION_CHECKING
+    cmocka_unit_test(test_az_curl_connection_init_NULL_connection_fails),
+    cmocka_unit_test(test_az_curl_connection_init_negative_options_fails),
+#endif // AZ_NO_PRECONDITION_CHECKING
+    cmocka_unit_test(test_az_curl_connection_init_deinit_succeeds),
+    cmocka_unit_test(test_az_curl_connection_init_options_succeeds),
+#ifndef _WIN32
+    cmocka_unit_test(test_az_curl_connection_reuses_connection),
+#endif // _WIN32
+  };
+
+  curl_global_init(CURL_GLOBAL_ALL);
+  int const result = cmocka_run_group_tests_name("az_platform_curl", tests, NULL, NULL);
+  curl_global_cleanup();
+  return result;
+}